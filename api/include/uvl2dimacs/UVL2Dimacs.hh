@@ -78,7 +78,7 @@
  *
  * ## Conversion Modes
  *
- * The API supports two CNF transformation strategies, each optimized for different use cases:
+ * The API supports several CNF transformation strategies, each optimized for different use cases:
  *
  * **Straightforward (Default - ConversionMode::STRAIGHTFORWARD):**
  * - Direct transformation using NNF (Negation Normal Form) and distribution law
@@ -99,6 +99,20 @@
  * - **How it works:** Decomposes n-ary operations into binary tree structures
  *   Example: `(A ∨ B ∨ C ∨ D)` becomes `aux1=(A∨B)`, `aux2=(C∨D)`, `result=(aux1∨aux2)`
  *
+ * **Plaisted-Greenbaum (ConversionMode::PLAISTED_GREENBAUM):**
+ * - Tseitin, but each constraint gate only gets the implication direction its polarity needs
+ * - Roughly half the constraint clauses; relation encodings are the same as Tseitin
+ * - Equisatisfiable and preserves the solutions projected onto the features, but
+ *   auxiliary variables are no longer functionally defined: **model counts over all
+ *   variables change**, so do not use it for #SAT
+ *
+ * **Hybrid (ConversionMode::HYBRID):**
+ * - Relations are encoded as in Straightforward mode
+ * - Each cross-tree constraint is converted directly unless its distributed CNF
+ *   has more literals than its Tseitin encoding, in which case Tseitin is used
+ * - Count-preserving; clause length is unbounded
+ * - **Best for:** Models where only a few constraints blow up under distribution
+ *
  * **Comparison Table:**
  *
  * | Aspect                | Straightforward         | Tseitin                  |
@@ -174,7 +188,8 @@
  *
  * - Feature cardinality `[1..*]` not fully supported (requires indexed feature generation)
  * - Arithmetic constraints are filtered out (requires SMT solver, not pure SAT)
- * - No clause minimization or subsumption
+ * - Clause normalization removes duplicates and subsumed clauses but does not
+ *   perform resolution-based minimization
  *
  * @see UVL2Dimacs Main API class
  * @see ConversionMode Enum for conversion strategies
@@ -186,6 +201,8 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <cstdint>
 
 namespace uvl2dimacs {
 
@@ -200,7 +217,93 @@ namespace uvl2dimacs {
  */
 enum class ConversionMode {
     STRAIGHTFORWARD,  ///< Direct NNF conversion without auxiliary variables (compact, fewer variables, variable clause length)
-    TSEITIN           ///< Tseitin transformation with auxiliary variables (guaranteed 3-CNF, more variables, uniform structure)
+    TSEITIN,          ///< Tseitin transformation with auxiliary variables (guaranteed 3-CNF, more variables, uniform structure)
+    PLAISTED_GREENBAUM, ///< Polarity-aware Tseitin (3-CNF, fewer clauses; equisatisfiable but not count-preserving)
+    HYBRID             ///< Direct or Tseitin per constraint, whichever is smaller (count-preserving, clause length unbounded)
+};
+
+/**
+ * @enum VariableOrder
+ * @ingroup UVL2Dimacs
+ * @brief Variable numbering applied before writing
+ *
+ * Renumbering only permutes variable IDs (the feature-name comments follow);
+ * it can improve the memory locality of CDCL solvers.
+ */
+enum class VariableOrder {
+    DEFAULT,                 ///< IDs in feature preorder, auxiliary variables in creation order
+    TREE_BFS,                ///< Features in breadth-first tree order, auxiliary variables after them
+    CUTHILL_MCKEE,           ///< Reverse Cuthill-McKee bandwidth minimization on the variable graph
+    AUX_NEXT_TO_DEFINITION   ///< Each auxiliary variable placed right after the inputs it defines
+};
+
+/**
+ * @enum AtMostOneEncoding
+ * @ingroup UVL2Dimacs
+ * @brief Encoding of the "at most one child" part of alternative groups
+ *
+ * The linear encodings add auxiliary variables that are fully defined by the
+ * features, so the number of solutions is unchanged.
+ */
+enum class AtMostOneEncoding {
+    PAIRWISE,     ///< One binary clause per pair of children, O(n²) clauses, no auxiliary variables
+    SEQUENTIAL,   ///< Sequential counter over prefix ORs, O(n) clauses
+    LADDER,       ///< Ladder of suffix ORs, O(n) clauses
+    COMMANDER,    ///< Groups of 3 with a commander variable each, applied recursively
+    BIMANDER,     ///< Groups of 2 with log2(n) binary commander variables
+    PRODUCT       ///< Children on a √n × √n grid, applied recursively to rows and columns
+};
+
+/**
+ * @enum CardinalityEncoding
+ * @ingroup UVL2Dimacs
+ * @brief Encoding of the count bounds of [min..max] cardinality groups
+ *
+ * The counter encodings add auxiliary variables that are fully defined by
+ * the features, so the number of solutions is unchanged, and produce clauses
+ * of at most 3 literals.
+ */
+enum class CardinalityEncoding {
+    ENUMERATION,         ///< One clause per subset of the children (2^n clauses, no auxiliary variables)
+    SEQUENTIAL_COUNTER,  ///< Sequential counter, O(n·k) clauses for bounds up to k
+    TOTALIZER,           ///< Totalizer, O(n·k) clauses for bounds up to k
+    SORTING_NETWORK,     ///< Odd-even merge sorting network, O(n log² n) clauses
+    AUTO                 ///< The smallest counter encoding for each group
+};
+
+/**
+ * @enum OutputFormat
+ * @ingroup UVL2Dimacs
+ * @brief File format written by convert()
+ *
+ * OPB and KNF keep alternative and cardinality groups as native cardinality
+ * constraints instead of lowering them to clauses, for solvers that reason
+ * about them directly. Both are written while transforming, like streaming
+ * output.
+ */
+enum class OutputFormat {
+    DIMACS,  ///< DIMACS CNF, clauses only (default)
+    OPB,     ///< Pseudo-Boolean OPB: clauses and at-least constraints as linear inequalities
+    KNF      ///< DIMACS extended with cardinality lines "k <bound> <literals> 0"
+};
+
+/**
+ * @struct ResourceLimits
+ * @ingroup UVL2Dimacs
+ * @brief Limits that make a conversion fail fast instead of exhausting the machine
+ *
+ * Every limit is optional (0 = unlimited). The clause and literal limits
+ * apply to the clauses generated by the transformation; each relation and
+ * constraint is checked against its predicted size before it is encoded, so
+ * an encoding that would blow up is rejected before it is expanded.
+ */
+struct ResourceLimits {
+    uint64_t max_clauses;           ///< Maximum number of generated clauses
+    uint64_t max_literals;          ///< Maximum number of generated literals
+    double max_seconds;             ///< Maximum wall time of the conversion in seconds
+    uint64_t max_memory_bytes;      ///< Maximum resident memory of the process in bytes
+
+    ResourceLimits() : max_clauses(0), max_literals(0), max_seconds(0), max_memory_bytes(0) {}
 };
 
 /**
@@ -211,6 +314,7 @@ enum class ConversionMode {
 struct ConversionResult {
     bool success;                   ///< Whether the conversion was successful
     std::string error_message;      ///< Error message if conversion failed
+    bool limit_exceeded;            ///< Whether it failed on a ResourceLimits limit
 
     // Statistics from the input feature model
     int num_features;               ///< Number of features in the input model
@@ -219,7 +323,21 @@ struct ConversionResult {
 
     // Statistics from the output CNF
     int num_variables;              ///< Number of variables in the CNF
-    int num_clauses;                ///< Number of clauses in the CNF
+    int num_clauses;                ///< Number of clauses in the CNF (constraints for OPB and KNF)
+    int num_cardinality_constraints; ///< Native cardinality constraints among them (OPB and KNF)
+    bool threads_ignored;           ///< Whether set_num_threads() asked for threads the conversion cannot use
+
+    // Statistics from clause normalization (zero when disabled)
+    int num_tautologies_removed;    ///< Tautological clauses removed
+    int num_duplicates_removed;     ///< Duplicate clauses removed
+    int num_subsumed_removed;       ///< Subsumed clauses removed
+    int num_merged_variables;       ///< Variables merged by equivalent-literal substitution
+    int num_core_features;          ///< Core features fixed by structural simplification
+    int num_dead_features;          ///< Dead features fixed by structural simplification
+    bool void_model;                ///< Whether structural simplification proved the model void
+    int num_components;             ///< Components written by component decomposition
+    int num_eliminated_variables;   ///< Variables eliminated by feature slicing
+    int num_preprocessed_variables; ///< Auxiliary variables removed by SAT preprocessing
 
     /**
      * @brief Default constructor for failed conversion
@@ -227,11 +345,71 @@ struct ConversionResult {
     ConversionResult()
         : success(false)
         , error_message("")
+        , limit_exceeded(false)
         , num_features(0)
         , num_relations(0)
         , num_constraints(0)
         , num_variables(0)
-        , num_clauses(0) {}
+        , num_clauses(0)
+        , num_cardinality_constraints(0)
+        , threads_ignored(false)
+        , num_tautologies_removed(0)
+        , num_duplicates_removed(0)
+        , num_subsumed_removed(0)
+        , num_merged_variables(0)
+        , num_core_features(0)
+        , num_dead_features(0)
+        , void_model(false)
+        , num_components(0)
+        , num_eliminated_variables(0)
+        , num_preprocessed_variables(0) {}
+};
+
+/**
+ * @struct CostEstimate
+ * @ingroup UVL2Dimacs
+ * @brief Predicted encoding size of one relation or constraint
+ *
+ * Counts that would overflow are reported as UINT64_MAX.
+ */
+struct CostEstimate {
+    std::string kind;               ///< "relation" or "constraint"
+    std::string name;               ///< "<type> <parent>" for relations, the constraint name otherwise
+    uint64_t num_variables;         ///< Auxiliary variables it creates
+    uint64_t num_clauses;           ///< Clauses it emits
+    uint64_t num_literals;          ///< Literals over its clauses
+
+    CostEstimate() : num_variables(0), num_clauses(0), num_literals(0) {}
+};
+
+/**
+ * @struct EstimateResult
+ * @ingroup UVL2Dimacs
+ * @brief Result of a dry-run size estimate
+ *
+ * Predicts the output of the plain transformation in one conversion mode,
+ * before structural simplification and post-processing (which only shrink
+ * it). Counts that would overflow are reported as UINT64_MAX.
+ */
+struct EstimateResult {
+    bool success;                   ///< Whether the model could be read
+    std::string error_message;      ///< Error message if the estimate failed
+    ConversionMode mode;            ///< Conversion mode the estimate is for
+
+    uint64_t num_variables;         ///< Predicted number of variables
+    uint64_t num_clauses;           ///< Predicted number of clauses
+    uint64_t num_literals;          ///< Predicted number of literals
+    uint64_t num_bytes;             ///< Predicted memory of the in-memory clause arena
+    std::vector<CostEstimate> items;  ///< Cost per relation and encoded constraint
+
+    EstimateResult()
+        : success(false)
+        , error_message("")
+        , mode(ConversionMode::STRAIGHTFORWARD)
+        , num_variables(0)
+        , num_clauses(0)
+        , num_literals(0)
+        , num_bytes(0) {}
 };
 
 /**
@@ -261,6 +439,23 @@ private:
     bool verbose_;
     ConversionMode mode_;
     bool use_backbone_;
+    bool use_streaming_;
+    bool use_normalization_;
+    bool use_equivalences_;
+    bool use_structural_;
+    VariableOrder variable_order_;
+    bool use_canonical_order_;
+    size_t spill_threshold_;
+    bool use_components_;
+    std::vector<std::string> slice_features_;
+    bool use_sat_preprocessing_;
+    ResourceLimits resource_limits_;
+    AtMostOneEncoding at_most_one_encoding_;
+    size_t at_most_one_threshold_;
+    CardinalityEncoding cardinality_encoding_;
+    size_t cardinality_threshold_;
+    unsigned num_threads_;
+    OutputFormat output_format_;
 
 public:
     /**
@@ -313,6 +508,301 @@ public:
      */
     bool get_backbone_simplification() const;
 
+    /**
+     * @brief Enable or disable streaming (low-memory) output
+     * @param use_streaming True to write clauses to the file as they are generated
+     *
+     * When enabled, convert() does not keep the clauses in memory: each clause
+     * is written to the output file as soon as it is generated, and the header
+     * counts are filled in once the transformation has finished. Peak memory
+     * then depends on the number of variables only. The clauses are the same
+     * as in normal mode, but the counts in the header are padded with spaces
+     * and the auxiliary variable comments appear after the clauses.
+     *
+     * Only affects convert(); convert_to_string() always builds the model in memory.
+     */
+    void set_streaming(bool use_streaming);
+
+    /**
+     * @brief Check if streaming output is enabled
+     * @return True if streaming output is enabled
+     */
+    bool get_streaming() const;
+
+    /**
+     * @brief Enable or disable clause normalization
+     * @param use_normalization True to clean up the clause set before writing
+     *
+     * When enabled, the CNF is normalized before it is written:
+     * - Literals in each clause are sorted by variable and repeated literals dropped
+     * - Tautologies (clauses with x and -x) are removed
+     * - Exact duplicate clauses are removed
+     * - Clauses subsumed by a shorter clause are removed (bounded effort)
+     *
+     * The number of satisfying assignments is preserved. The removed clause
+     * counts are reported in ConversionResult. Not available together with
+     * streaming output, which never holds the clause set in memory.
+     */
+    void set_clause_normalization(bool use_normalization);
+
+    /**
+     * @brief Check if clause normalization is enabled
+     * @return True if clause normalization is enabled
+     */
+    bool get_clause_normalization() const;
+
+    /**
+     * @brief Enable or disable equivalent-literal substitution
+     * @param use_equivalences True to merge variables that are provably equal
+     *
+     * When enabled, variables forced equal (or opposite) by binary clauses,
+     * such as mandatory chains and <=> constraints, are replaced by a single
+     * representative variable and the variables are renumbered. Both the
+     * number of variables and clauses shrink, while the number of satisfying
+     * assignments is preserved. Each merged feature is listed in the output as
+     * `c <literal> <feature_name> (equivalent)` so solutions can be mapped back.
+     * The number of merged variables is reported in ConversionResult.
+     * Not available together with streaming output.
+     */
+    void set_equivalence_substitution(bool use_equivalences);
+
+    /**
+     * @brief Check if equivalent-literal substitution is enabled
+     * @return True if equivalent-literal substitution is enabled
+     */
+    bool get_equivalence_substitution() const;
+
+    /**
+     * @brief Enable or disable structural simplification
+     * @param use_structural True to fix core and dead features found from the tree
+     *
+     * When enabled, core features (the root, its mandatory closure, ...) and
+     * dead features (features below a dead feature, excluded by unit or
+     * requires/excludes constraints, ...) are derived from the feature tree
+     * without SAT calls. They are asserted by unit clauses and every other
+     * clause is simplified with them, which preserves the number of
+     * satisfying assignments and leaves far fewer candidates for backbone
+     * simplification. Works with streaming output. A model found void is
+     * reported in ConversionResult::void_model and left unsimplified.
+     */
+    void set_structural_simplification(bool use_structural);
+
+    /**
+     * @brief Check if structural simplification is enabled
+     * @return True if structural simplification is enabled
+     */
+    bool get_structural_simplification() const;
+
+    /**
+     * @brief Set the variable numbering applied before writing
+     * @param order Renumbering strategy (VariableOrder::DEFAULT keeps the IDs)
+     *
+     * Not available together with streaming output.
+     */
+    void set_variable_order(VariableOrder order);
+
+    /**
+     * @brief Get the variable numbering applied before writing
+     * @return The current renumbering strategy
+     */
+    VariableOrder get_variable_order() const;
+
+    /**
+     * @brief Enable or disable canonical clause ordering
+     * @param use_canonical_order True to sort the literals of each clause and the clauses
+     *
+     * The output then depends only on the clause set, not on the order the
+     * encoders produced it, so similar models yield DIMACS files that diff and
+     * compress well. Applied after renumbering. Not available together with
+     * streaming output.
+     */
+    void set_canonical_order(bool use_canonical_order);
+
+    /**
+     * @brief Check if canonical clause ordering is enabled
+     * @return True if canonical clause ordering is enabled
+     */
+    bool get_canonical_order() const;
+
+    /**
+     * @brief Set the memory limit of the in-memory clause arena
+     * @param bytes Heap limit per arena buffer before the clauses spill to a
+     *        memory-mapped temporary file (0 = never spill, the default)
+     *
+     * Lets conversions of formulas larger than RAM page to disk instead of
+     * running out of memory. The output is identical. Clause normalization,
+     * canonical ordering, feature slicing and SAT preprocessing build a full
+     * in-memory copy of the formula, so a conversion enabling them together
+     * with a spill threshold fails.
+     */
+    void set_spill_threshold(size_t bytes);
+
+    /**
+     * @brief Get the memory limit of the in-memory clause arena
+     * @return Heap limit in bytes (0 = never spill)
+     */
+    size_t get_spill_threshold() const;
+
+    /**
+     * @brief Enable or disable independent-component decomposition
+     * @param use_components True to split the formula into components that share no variables
+     *
+     * The output file then becomes a manifest listing one DIMACS file per
+     * component ("<output stem>_<k>.dimacs"); the model count of the formula
+     * is the product of the components' model counts. Only available with
+     * convert(), and not together with streaming or backbone simplification.
+     *
+     * @see ComponentDecomposer
+     */
+    void set_component_decomposition(bool use_components);
+
+    /**
+     * @brief Check if independent-component decomposition is enabled
+     * @return True if component decomposition is enabled
+     */
+    bool get_component_decomposition() const;
+
+    /**
+     * @brief Set the features to project the formula onto
+     * @param features Names of the features to keep (empty disables slicing)
+     *
+     * All other variables are eliminated by resolution, so the solutions of
+     * the output are the projections of the model's configurations onto the
+     * kept features. The conversion fails if the formula would exceed
+     * FeatureSlicer::DEFAULT_MAX_CLAUSES clauses. Not available together with
+     * streaming output.
+     *
+     * @see FeatureSlicer
+     */
+    void set_slice_features(const std::vector<std::string>& features);
+
+    /**
+     * @brief Get the features the formula is projected onto
+     * @return Names of the kept features (empty if slicing is disabled)
+     */
+    const std::vector<std::string>& get_slice_features() const;
+
+    /**
+     * @brief Enable or disable SAT preprocessing
+     * @param use_preprocessing True to simplify the formula before writing
+     *
+     * Runs bounded variable elimination, subsumption and blocked-clause
+     * elimination with every feature variable frozen: auxiliary variables
+     * and redundant clauses are removed, feature IDs are unchanged and the
+     * feature assignments of the solutions are preserved. Not available
+     * together with streaming output.
+     *
+     * @see SatPreprocessor
+     */
+    void set_sat_preprocessing(bool use_preprocessing);
+
+    /**
+     * @brief Check if SAT preprocessing is enabled
+     * @return True if SAT preprocessing is enabled
+     */
+    bool get_sat_preprocessing() const;
+
+    /**
+     * @brief Set the resource limits of conversions
+     * @param limits Limits on clauses, literals, wall time and memory (default: unlimited)
+     *
+     * When a limit is exceeded, the conversion stops and fails with
+     * ConversionResult::limit_exceeded set and an error message naming the
+     * limit and the relation or constraint being encoded, e.g.
+     * "Resource limit exceeded in constraint 'Constraint_3' (...): predicted
+     * 268435456 clauses exceed the limit of 10000000 (1200 already used)".
+     * The wall time covers parsing and the post-processing passes as well.
+     *
+     * @see ResourceBudget
+     */
+    void set_resource_limits(const ResourceLimits& limits);
+
+    /**
+     * @brief Get the resource limits of conversions
+     * @return The current limits
+     */
+    const ResourceLimits& get_resource_limits() const;
+
+    /**
+     * @brief Set the at-most-one encoding of alternative groups
+     * @param encoding Encoding of groups with at least threshold children
+     * @param threshold Smallest group size using it (default: 8); smaller
+     *        groups, and groups of 2, stay pairwise
+     *
+     * The default PAIRWISE encoding produces O(n²) clauses per group; the
+     * linear encodings trade them for O(n) clauses and auxiliary variables.
+     */
+    void set_at_most_one_encoding(AtMostOneEncoding encoding, size_t threshold = 8);
+
+    /**
+     * @brief Get the at-most-one encoding of alternative groups
+     * @return The current encoding
+     */
+    AtMostOneEncoding get_at_most_one_encoding() const;
+
+    /**
+     * @brief Get the smallest group size using the at-most-one encoding
+     * @return The current threshold
+     */
+    size_t get_at_most_one_threshold() const;
+
+    /**
+     * @brief Set the encoding of cardinality groups
+     * @param encoding Encoding of groups with at least threshold children
+     * @param threshold Smallest group size using it (default: 8); smaller
+     *        groups stay enumerated
+     *
+     * The default ENUMERATION produces 2^n clauses per group, which makes
+     * groups of more than about 20 children unconvertible; the counter
+     * encodings are polynomial. An unbounded maximum ("*") allows all
+     * children with every encoding.
+     */
+    void set_cardinality_encoding(CardinalityEncoding encoding, size_t threshold = 8);
+
+    /**
+     * @brief Get the encoding of cardinality groups
+     * @return The current encoding
+     */
+    CardinalityEncoding get_cardinality_encoding() const;
+
+    /**
+     * @brief Get the smallest group size using the cardinality encoding
+     * @return The current threshold
+     */
+    size_t get_cardinality_threshold() const;
+
+    /**
+     * @brief Set the number of threads encoding relations and constraints
+     * @param threads Number of threads (0 = one per hardware thread, default: 1)
+     *
+     * The output is identical to the single-threaded conversion. Only the
+     * straightforward mode without resource limits and with DIMACS output
+     * runs in parallel; otherwise ConversionResult::threads_ignored is set.
+     */
+    void set_num_threads(unsigned threads);
+
+    /**
+     * @brief Get the number of threads encoding relations and constraints
+     * @return The current number of threads (0 = one per hardware thread)
+     */
+    unsigned get_num_threads() const;
+
+    /**
+     * @brief Set the file format written by convert()
+     * @param format Output format (default: DIMACS)
+     *
+     * OPB and KNF imply streaming output and cannot be combined with the
+     * options streaming excludes, backbone simplification or component
+     * decomposition. convert_to_string() always produces DIMACS.
+     */
+    void set_output_format(OutputFormat format);
+
+    /**
+     * @brief Get the file format written by convert()
+     * @return The current output format
+     */
+    OutputFormat get_output_format() const;
+
     /**
      * @brief Convert a UVL file to DIMACS format
      * @param input_file Path to input UVL file
@@ -352,6 +842,27 @@ public:
     std::string convert_to_string(const std::string& input_file,
                                   ConversionMode mode,
                                   ConversionResult& result);
+
+    /**
+     * @brief Predict the encoding size without generating the CNF
+     * @param input_file Path to input UVL file
+     * @return EstimateResult for the current conversion mode
+     *
+     * Only parses the model; the sizes are computed in closed form from the
+     * group sizes and constraint expressions, so models whose encoding would
+     * blow up can be detected (and a mode chosen) up front.
+     *
+     * @see EncodingEstimator
+     */
+    EstimateResult estimate(const std::string& input_file);
+
+    /**
+     * @brief Predict the encoding size for a given mode without generating the CNF
+     * @param input_file Path to input UVL file
+     * @param mode Conversion mode to estimate
+     * @return EstimateResult with the predicted sizes
+     */
+    EstimateResult estimate(const std::string& input_file, ConversionMode mode);
 };
 
 } // namespace uvl2dimacs
@@ -31,6 +31,17 @@
 #include "FeatureModelBuilder.hh"
 #include "FMToCNF.hh"
 #include "DimacsWriter.hh"
+#include "DimacsStreamWriter.hh"
+#include "OpbStreamWriter.hh"
+#include "KnfStreamWriter.hh"
+#include "ClauseNormalizer.hh"
+#include "EquivalenceReducer.hh"
+#include "VariableRenumberer.hh"
+#include "ComponentDecomposer.hh"
+#include "FeatureSlicer.hh"
+#include "SatPreprocessor.hh"
+#include "EncodingEstimator.hh"
+#include "ResourceBudget.hh"
 #include "BackboneSimplifier.hh"
 #include "CNFMode.hh"
 #include "UVLCppLexer.h"
@@ -83,14 +94,83 @@ public:
  * @brief Convert ConversionMode to CNFMode
  */
 static CNFMode to_cnf_mode(ConversionMode mode) {
-    return (mode == ConversionMode::TSEITIN) ? CNFMode::TSEITIN : CNFMode::STRAIGHTFORWARD;
+    switch (mode) {
+        case ConversionMode::TSEITIN: return CNFMode::TSEITIN;
+        case ConversionMode::PLAISTED_GREENBAUM: return CNFMode::PLAISTED_GREENBAUM;
+        case ConversionMode::HYBRID: return CNFMode::HYBRID;
+        case ConversionMode::STRAIGHTFORWARD: break;
+    }
+    return CNFMode::STRAIGHTFORWARD;
+}
+
+/**
+ * @brief Convert VariableOrder to RenumberStrategy
+ */
+static RenumberStrategy to_renumber_strategy(VariableOrder order) {
+    switch (order) {
+        case VariableOrder::TREE_BFS: return RenumberStrategy::TREE_BFS;
+        case VariableOrder::CUTHILL_MCKEE: return RenumberStrategy::CUTHILL_MCKEE;
+        case VariableOrder::AUX_NEXT_TO_DEFINITION: return RenumberStrategy::AUX_NEXT_TO_DEFINITION;
+        case VariableOrder::DEFAULT: break;
+    }
+    return RenumberStrategy::NONE;
+}
+
+/**
+ * @brief Convert an AtMostOneEncoding and threshold to an AtMostOnePolicy
+ */
+static AtMostOnePolicy to_at_most_one_policy(AtMostOneEncoding encoding, size_t threshold) {
+    AtMostOnePolicy policy;
+    policy.threshold = threshold;
+    switch (encoding) {
+        case AtMostOneEncoding::SEQUENTIAL: policy.encoding = ::AtMostOneEncoding::SEQUENTIAL; break;
+        case AtMostOneEncoding::LADDER: policy.encoding = ::AtMostOneEncoding::LADDER; break;
+        case AtMostOneEncoding::COMMANDER: policy.encoding = ::AtMostOneEncoding::COMMANDER; break;
+        case AtMostOneEncoding::BIMANDER: policy.encoding = ::AtMostOneEncoding::BIMANDER; break;
+        case AtMostOneEncoding::PRODUCT: policy.encoding = ::AtMostOneEncoding::PRODUCT; break;
+        case AtMostOneEncoding::PAIRWISE: policy.encoding = ::AtMostOneEncoding::PAIRWISE; break;
+    }
+    return policy;
+}
+
+/**
+ * @brief Convert a CardinalityEncoding and threshold to a CardinalityPolicy
+ */
+static CardinalityPolicy to_cardinality_policy(CardinalityEncoding encoding, size_t threshold) {
+    CardinalityPolicy policy;
+    policy.threshold = threshold;
+    switch (encoding) {
+        case CardinalityEncoding::SEQUENTIAL_COUNTER: policy.encoding = ::CardinalityEncoding::SEQUENTIAL_COUNTER; break;
+        case CardinalityEncoding::TOTALIZER: policy.encoding = ::CardinalityEncoding::TOTALIZER; break;
+        case CardinalityEncoding::SORTING_NETWORK: policy.encoding = ::CardinalityEncoding::SORTING_NETWORK; break;
+        case CardinalityEncoding::AUTO: policy.encoding = ::CardinalityEncoding::AUTO; break;
+        case CardinalityEncoding::ENUMERATION: policy.encoding = ::CardinalityEncoding::ENUMERATION; break;
+    }
+    return policy;
 }
 
 // Constructor
 UVL2Dimacs::UVL2Dimacs(bool verbose)
     : verbose_(verbose)
     , mode_(ConversionMode::STRAIGHTFORWARD)
-    , use_backbone_(false) {
+    , use_backbone_(false)
+    , use_streaming_(false)
+    , use_normalization_(false)
+    , use_equivalences_(false)
+    , use_structural_(false)
+    , variable_order_(VariableOrder::DEFAULT)
+    , use_canonical_order_(false)
+    , spill_threshold_(0)
+    , use_components_(false)
+    , slice_features_()
+    , use_sat_preprocessing_(false)
+    , resource_limits_()
+    , at_most_one_encoding_(AtMostOneEncoding::PAIRWISE)
+    , at_most_one_threshold_(AtMostOnePolicy::DEFAULT_THRESHOLD)
+    , cardinality_encoding_(CardinalityEncoding::ENUMERATION)
+    , cardinality_threshold_(CardinalityPolicy::DEFAULT_THRESHOLD)
+    , num_threads_(1)
+    , output_format_(OutputFormat::DIMACS) {
 }
 
 // Destructor
@@ -121,6 +201,302 @@ bool UVL2Dimacs::get_backbone_simplification() const {
     return use_backbone_;
 }
 
+// Set streaming output
+void UVL2Dimacs::set_streaming(bool use_streaming) {
+    use_streaming_ = use_streaming;
+}
+
+// Get streaming output status
+bool UVL2Dimacs::get_streaming() const {
+    return use_streaming_;
+}
+
+// Set clause normalization
+void UVL2Dimacs::set_clause_normalization(bool use_normalization) {
+    use_normalization_ = use_normalization;
+}
+
+// Get clause normalization status
+bool UVL2Dimacs::get_clause_normalization() const {
+    return use_normalization_;
+}
+
+// Set equivalent-literal substitution
+void UVL2Dimacs::set_equivalence_substitution(bool use_equivalences) {
+    use_equivalences_ = use_equivalences;
+}
+
+// Get equivalent-literal substitution status
+bool UVL2Dimacs::get_equivalence_substitution() const {
+    return use_equivalences_;
+}
+
+// Set structural simplification
+void UVL2Dimacs::set_structural_simplification(bool use_structural) {
+    use_structural_ = use_structural;
+}
+
+// Get structural simplification status
+bool UVL2Dimacs::get_structural_simplification() const {
+    return use_structural_;
+}
+
+// Set variable order
+void UVL2Dimacs::set_variable_order(VariableOrder order) {
+    variable_order_ = order;
+}
+
+// Get variable order
+VariableOrder UVL2Dimacs::get_variable_order() const {
+    return variable_order_;
+}
+
+// Set canonical clause ordering
+void UVL2Dimacs::set_canonical_order(bool use_canonical_order) {
+    use_canonical_order_ = use_canonical_order;
+}
+
+// Get canonical clause ordering status
+bool UVL2Dimacs::get_canonical_order() const {
+    return use_canonical_order_;
+}
+
+// Set spill threshold
+void UVL2Dimacs::set_spill_threshold(size_t bytes) {
+    spill_threshold_ = bytes;
+}
+
+// Get spill threshold
+size_t UVL2Dimacs::get_spill_threshold() const {
+    return spill_threshold_;
+}
+
+// Set component decomposition
+void UVL2Dimacs::set_component_decomposition(bool use_components) {
+    use_components_ = use_components;
+}
+
+// Get component decomposition status
+bool UVL2Dimacs::get_component_decomposition() const {
+    return use_components_;
+}
+
+// Set slice features
+void UVL2Dimacs::set_slice_features(const std::vector<std::string>& features) {
+    slice_features_ = features;
+}
+
+// Get slice features
+const std::vector<std::string>& UVL2Dimacs::get_slice_features() const {
+    return slice_features_;
+}
+
+// Set SAT preprocessing
+void UVL2Dimacs::set_sat_preprocessing(bool use_preprocessing) {
+    use_sat_preprocessing_ = use_preprocessing;
+}
+
+// Get SAT preprocessing status
+bool UVL2Dimacs::get_sat_preprocessing() const {
+    return use_sat_preprocessing_;
+}
+
+// Set resource limits
+void UVL2Dimacs::set_resource_limits(const ResourceLimits& limits) {
+    resource_limits_ = limits;
+}
+
+// Get resource limits
+const ResourceLimits& UVL2Dimacs::get_resource_limits() const {
+    return resource_limits_;
+}
+
+// Set at-most-one encoding
+void UVL2Dimacs::set_at_most_one_encoding(AtMostOneEncoding encoding, size_t threshold) {
+    at_most_one_encoding_ = encoding;
+    at_most_one_threshold_ = threshold;
+}
+
+// Get at-most-one encoding
+AtMostOneEncoding UVL2Dimacs::get_at_most_one_encoding() const {
+    return at_most_one_encoding_;
+}
+
+// Get at-most-one threshold
+size_t UVL2Dimacs::get_at_most_one_threshold() const {
+    return at_most_one_threshold_;
+}
+
+// Set cardinality encoding
+void UVL2Dimacs::set_cardinality_encoding(CardinalityEncoding encoding, size_t threshold) {
+    cardinality_encoding_ = encoding;
+    cardinality_threshold_ = threshold;
+}
+
+// Get cardinality encoding
+CardinalityEncoding UVL2Dimacs::get_cardinality_encoding() const {
+    return cardinality_encoding_;
+}
+
+// Get cardinality threshold
+size_t UVL2Dimacs::get_cardinality_threshold() const {
+    return cardinality_threshold_;
+}
+
+// Set number of threads
+void UVL2Dimacs::set_num_threads(unsigned threads) {
+    num_threads_ = threads;
+}
+
+// Get number of threads
+unsigned UVL2Dimacs::get_num_threads() const {
+    return num_threads_;
+}
+
+// Set output format
+void UVL2Dimacs::set_output_format(OutputFormat format) {
+    output_format_ = format;
+}
+
+// Get output format
+OutputFormat UVL2Dimacs::get_output_format() const {
+    return output_format_;
+}
+
+/**
+ * @brief Apply the resource limits to a budget and start its clock
+ */
+static void start_budget(ResourceBudget& budget, const ResourceLimits& limits) {
+    budget.set_max_clauses(limits.max_clauses);
+    budget.set_max_literals(limits.max_literals);
+    budget.set_max_seconds(limits.max_seconds);
+    budget.set_max_rss(limits.max_memory_bytes);
+    budget.start();
+}
+
+/**
+ * @brief Renumber variables with the selected strategy
+ */
+static void renumber_variables(CNFModel& cnf_model, std::shared_ptr<FeatureModel> feature_model,
+                               VariableOrder order, bool verbose) {
+    if (order == VariableOrder::DEFAULT) {
+        return;
+    }
+    if (verbose) {
+        std::cout << "Renumbering variables..." << std::endl;
+    }
+    VariableRenumberer renumberer(to_renumber_strategy(order));
+    renumberer.renumber(cnf_model, feature_model);
+
+    if (verbose) {
+        std::cout << "  Bandwidth: " << renumberer.get_bandwidth_before()
+                  << " -> " << renumberer.get_bandwidth_after() << std::endl;
+    }
+}
+
+/**
+ * @brief Record and report the core/dead features fixed by the transformer
+ */
+static void record_structure(const FMToCNF& transformer, ConversionResult& result, bool verbose) {
+    result.num_core_features = static_cast<int>(transformer.get_num_core_features());
+    result.num_dead_features = static_cast<int>(transformer.get_num_dead_features());
+    result.void_model = transformer.is_void_model();
+
+    if (verbose) {
+        std::cout << "  Core features: " << result.num_core_features << std::endl;
+        std::cout << "  Dead features: " << result.num_dead_features << std::endl;
+        std::cout << "  Simplified clauses: " << transformer.get_num_simplified_clauses() << std::endl;
+        if (result.void_model) {
+            std::cout << "  Model is void (no valid configuration), clauses left unsimplified" << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief Merge equivalent variables and record how many were merged
+ */
+static void substitute_equivalences(CNFModel& cnf_model, ConversionResult& result, bool verbose) {
+    if (verbose) {
+        std::cout << "Substituting equivalent literals..." << std::endl;
+    }
+    EquivalenceReducer reducer;
+    reducer.reduce(cnf_model);
+
+    result.num_merged_variables = static_cast<int>(reducer.get_merged_variables());
+
+    if (verbose) {
+        std::cout << "  Merged variables: " << result.num_merged_variables << std::endl;
+        std::cout << "  Removed clauses: " << reducer.get_removed_clauses() << std::endl;
+        if (reducer.is_unsatisfiable()) {
+            std::cout << "  Formula is unsatisfiable (a variable is equivalent to its negation)" << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief Project the formula onto the kept features and record the eliminated variables
+ */
+static void slice_features(CNFModel& cnf_model, const std::vector<std::string>& features,
+                           ConversionResult& result, bool verbose) {
+    if (features.empty()) {
+        return;
+    }
+    if (verbose) {
+        std::cout << "Slicing to " << features.size() << " features..." << std::endl;
+    }
+    FeatureSlicer slicer(features);
+    slicer.slice(cnf_model);
+
+    result.num_eliminated_variables = static_cast<int>(slicer.get_eliminated_variables());
+
+    if (verbose) {
+        std::cout << "  Eliminated variables: " << result.num_eliminated_variables << std::endl;
+    }
+}
+
+/**
+ * @brief Simplify the formula with the feature variables frozen and record the removed variables
+ */
+static void preprocess_clauses(CNFModel& cnf_model, ConversionResult& result, bool verbose) {
+    if (verbose) {
+        std::cout << "Preprocessing clauses..." << std::endl;
+    }
+    SatPreprocessor preprocessor;
+    preprocessor.preprocess(cnf_model);
+
+    result.num_preprocessed_variables = static_cast<int>(preprocessor.get_eliminated_variables());
+
+    if (verbose) {
+        std::cout << "  Eliminated auxiliary variables: " << result.num_preprocessed_variables << std::endl;
+        std::cout << "  Removed clauses: " << preprocessor.get_removed_clauses() << std::endl;
+        std::cout << "  Blocked clauses: " << preprocessor.get_blocked_clauses() << std::endl;
+        if (preprocessor.is_unsatisfiable()) {
+            std::cout << "  Formula is unsatisfiable (left unchanged)" << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief Normalize the clause set and record the removed clause counts
+ */
+static void normalize_clauses(CNFModel& cnf_model, ConversionResult& result, bool verbose) {
+    if (verbose) {
+        std::cout << "Normalizing clauses..." << std::endl;
+    }
+    ClauseNormalizer normalizer;
+    normalizer.normalize(cnf_model);
+
+    result.num_tautologies_removed = static_cast<int>(normalizer.get_tautologies());
+    result.num_duplicates_removed = static_cast<int>(normalizer.get_duplicate_clauses());
+    result.num_subsumed_removed = static_cast<int>(normalizer.get_subsumed_clauses());
+
+    if (verbose) {
+        std::cout << "  Tautologies removed: " << result.num_tautologies_removed << std::endl;
+        std::cout << "  Duplicates removed: " << result.num_duplicates_removed << std::endl;
+        std::cout << "  Subsumed removed: " << result.num_subsumed_removed << std::endl;
+    }
+}
+
 // Convert with default mode
 ConversionResult UVL2Dimacs::convert(const std::string& input_file,
                                      const std::string& output_file) {
@@ -132,6 +508,8 @@ ConversionResult UVL2Dimacs::convert(const std::string& input_file,
                                      const std::string& output_file,
                                      ConversionMode mode) {
     ConversionResult result;
+    ResourceBudget budget;
+    start_budget(budget, resource_limits_);
 
     try {
         if (verbose_) {
@@ -206,25 +584,138 @@ ConversionResult UVL2Dimacs::convert(const std::string& input_file,
         if (verbose_) {
             std::cout << "Transforming to CNF..." << std::endl;
         }
+        if (spill_threshold_ != 0 && (use_normalization_ || use_canonical_order_ || !slice_features_.empty() ||
+                                      use_sat_preprocessing_)) {
+            result.error_message = "Clause normalization, canonical ordering, feature slicing and SAT "
+                                   "preprocessing rebuild the formula in memory and cannot be combined "
+                                   "with a spill threshold";
+            return result;
+        }
         FMToCNF transformer(feature_model);
-        CNFModel cnf_model = transformer.transform(to_cnf_mode(mode));
+        transformer.set_structural_simplification(use_structural_);
+        transformer.set_spill_threshold(spill_threshold_);
+        transformer.set_at_most_one_policy(to_at_most_one_policy(at_most_one_encoding_, at_most_one_threshold_));
+        transformer.set_cardinality_policy(to_cardinality_policy(cardinality_encoding_, cardinality_threshold_));
+        transformer.set_num_threads(num_threads_);
+        if (budget.is_limited()) {
+            transformer.set_resource_budget(&budget);
+        }
+        result.threads_ignored = num_threads_ != 1 &&
+                                 !transformer.supports_threads(to_cnf_mode(mode), output_format_ != OutputFormat::DIMACS);
+        if (verbose_ && result.threads_ignored) {
+            std::cout << "  Threads ignored: only straightforward DIMACS conversions without limits run in parallel"
+                      << std::endl;
+        }
+        bool native = output_format_ != OutputFormat::DIMACS;
+        if (native && (use_backbone_ || use_components_)) {
+            result.error_message = "Backbone simplification and component decomposition cannot be "
+                                   "combined with OPB or KNF output";
+            return result;
+        }
+        bool streaming = use_streaming_ || native;
+        if (streaming && (use_normalization_ || use_equivalences_ || !slice_features_.empty() ||
+                               use_sat_preprocessing_ || variable_order_ != VariableOrder::DEFAULT ||
+                               use_canonical_order_)) {
+            result.error_message = "Clause normalization, equivalent-literal substitution, feature slicing, "
+                                   "SAT preprocessing, variable renumbering and canonical ordering cannot be "
+                                   "combined with streaming output";
+            return result;
+        }
+        if (use_components_ && (streaming || use_backbone_)) {
+            result.error_message = "Component decomposition cannot be combined with streaming output "
+                                   "or backbone simplification";
+            return result;
+        }
+        if (streaming) {
+            // Write clauses to the output file while transforming
+            if (output_format_ == OutputFormat::OPB) {
+                if (verbose_) {
+                    std::cout << "Streaming OPB file: " << output_file << std::endl;
+                }
+                OpbStreamWriter writer(output_file);
+                transformer.transform(writer, to_cnf_mode(mode));
+                result.num_clauses = static_cast<int>(writer.get_num_constraints());
+                result.num_cardinality_constraints = static_cast<int>(writer.get_num_cardinality_constraints());
+            } else if (output_format_ == OutputFormat::KNF) {
+                if (verbose_) {
+                    std::cout << "Streaming KNF file: " << output_file << std::endl;
+                }
+                KnfStreamWriter writer(output_file);
+                transformer.transform(writer, to_cnf_mode(mode));
+                result.num_clauses = static_cast<int>(writer.get_num_clauses());
+                result.num_cardinality_constraints = static_cast<int>(writer.get_num_cardinality_constraints());
+            } else {
+                if (verbose_) {
+                    std::cout << "Streaming DIMACS file: " << output_file << std::endl;
+                }
+                DimacsStreamWriter writer(output_file);
+                transformer.transform(writer, to_cnf_mode(mode));
+                result.num_clauses = static_cast<int>(writer.get_num_clauses());
+            }
+            record_structure(transformer, result, verbose_ && use_structural_);
 
-        // Store CNF statistics
-        result.num_variables = cnf_model.get_num_variables();
-        result.num_clauses = cnf_model.get_num_clauses();
+            // Store CNF statistics
+            result.num_variables = transformer.get_cnf_model().get_num_variables();
 
-        if (verbose_) {
-            std::cout << "CNF model created:" << std::endl;
-            std::cout << "  Variables: " << result.num_variables << std::endl;
-            std::cout << "  Clauses: " << result.num_clauses << std::endl;
-        }
+            if (verbose_) {
+                std::cout << "CNF written:" << std::endl;
+                std::cout << "  Variables: " << result.num_variables << std::endl;
+                std::cout << "  Clauses: " << result.num_clauses << std::endl;
+                if (native) {
+                    std::cout << "  Cardinality: " << result.num_cardinality_constraints << std::endl;
+                }
+            }
+        } else {
+            CNFModel cnf_model = transformer.transform(to_cnf_mode(mode));
+            record_structure(transformer, result, verbose_ && use_structural_);
+            if (use_equivalences_) {
+                substitute_equivalences(cnf_model, result, verbose_);
+            }
+            slice_features(cnf_model, slice_features_, result, verbose_);
+            if (use_normalization_) {
+                normalize_clauses(cnf_model, result, verbose_);
+            }
+            if (use_sat_preprocessing_) {
+                preprocess_clauses(cnf_model, result, verbose_);
+            }
+            renumber_variables(cnf_model, feature_model, variable_order_, verbose_);
+            if (use_canonical_order_) {
+                ClauseNormalizer::sort_canonically(cnf_model);
+            }
+            budget.check("post-processing");
 
-        // Write DIMACS file
-        if (verbose_) {
-            std::cout << "Writing DIMACS file: " << output_file << std::endl;
+            // Store CNF statistics
+            result.num_variables = cnf_model.get_num_variables();
+            result.num_clauses = cnf_model.get_num_clauses();
+
+            if (verbose_) {
+                std::cout << "CNF model created:" << std::endl;
+                std::cout << "  Variables: " << result.num_variables << std::endl;
+                std::cout << "  Clauses: " << result.num_clauses << std::endl;
+            }
+
+            if (use_components_) {
+                // Write one DIMACS file per component and the manifest
+                if (verbose_) {
+                    std::cout << "Writing component manifest: " << output_file << std::endl;
+                }
+                ComponentDecomposer decomposer(cnf_model);
+                decomposer.decompose();
+                decomposer.write_files(output_file);
+                result.num_components = static_cast<int>(decomposer.get_num_components());
+
+                if (verbose_) {
+                    std::cout << "  Components: " << result.num_components << std::endl;
+                }
+            } else {
+                // Write DIMACS file
+                if (verbose_) {
+                    std::cout << "Writing DIMACS file: " << output_file << std::endl;
+                }
+                DimacsWriter writer(cnf_model);
+                writer.write_to_file(output_file);
+            }
         }
-        DimacsWriter writer(cnf_model);
-        writer.write_to_file(output_file);
 
         // Apply backbone simplification if requested
         if (use_backbone_) {
@@ -286,6 +777,10 @@ ConversionResult UVL2Dimacs::convert(const std::string& input_file,
 
         return result;
 
+    } catch (const BudgetExceeded& e) {
+        result.error_message = e.what();
+        result.limit_exceeded = true;
+        return result;
     } catch (const std::exception& e) {
         result.error_message = e.what();
         return result;
@@ -302,7 +797,14 @@ std::string UVL2Dimacs::convert_to_string(const std::string& input_file,
 std::string UVL2Dimacs::convert_to_string(const std::string& input_file,
                                           ConversionMode mode,
                                           ConversionResult& result) {
+    ResourceBudget budget;
+    start_budget(budget, resource_limits_);
+
     try {
+        if (use_components_) {
+            result.error_message = "Component decomposition writes one file per component; use convert()";
+            return "";
+        }
         if (verbose_) {
             std::cout << "Reading UVL file: " << input_file << std::endl;
         }
@@ -368,8 +870,44 @@ std::string UVL2Dimacs::convert_to_string(const std::string& input_file,
         if (verbose_) {
             std::cout << "Transforming to CNF..." << std::endl;
         }
+        if (spill_threshold_ != 0 && (use_normalization_ || use_canonical_order_ || !slice_features_.empty() ||
+                                      use_sat_preprocessing_)) {
+            result.error_message = "Clause normalization, canonical ordering, feature slicing and SAT "
+                                   "preprocessing rebuild the formula in memory and cannot be combined "
+                                   "with a spill threshold";
+            return "";
+        }
         FMToCNF transformer(feature_model);
+        transformer.set_structural_simplification(use_structural_);
+        transformer.set_spill_threshold(spill_threshold_);
+        transformer.set_at_most_one_policy(to_at_most_one_policy(at_most_one_encoding_, at_most_one_threshold_));
+        transformer.set_cardinality_policy(to_cardinality_policy(cardinality_encoding_, cardinality_threshold_));
+        transformer.set_num_threads(num_threads_);
+        if (budget.is_limited()) {
+            transformer.set_resource_budget(&budget);
+        }
+        result.threads_ignored = num_threads_ != 1 && !transformer.supports_threads(to_cnf_mode(mode), false);
+        if (verbose_ && result.threads_ignored) {
+            std::cout << "  Threads ignored: only straightforward DIMACS conversions without limits run in parallel"
+                      << std::endl;
+        }
         CNFModel cnf_model = transformer.transform(to_cnf_mode(mode));
+        record_structure(transformer, result, verbose_ && use_structural_);
+        if (use_equivalences_) {
+            substitute_equivalences(cnf_model, result, verbose_);
+        }
+        slice_features(cnf_model, slice_features_, result, verbose_);
+        if (use_normalization_) {
+            normalize_clauses(cnf_model, result, verbose_);
+        }
+        if (use_sat_preprocessing_) {
+            preprocess_clauses(cnf_model, result, verbose_);
+        }
+        renumber_variables(cnf_model, feature_model, variable_order_, verbose_);
+        if (use_canonical_order_) {
+            ClauseNormalizer::sort_canonically(cnf_model);
+        }
+        budget.check("post-processing");
 
         // Store CNF statistics
         result.num_variables = cnf_model.get_num_variables();
@@ -384,10 +922,91 @@ std::string UVL2Dimacs::convert_to_string(const std::string& input_file,
 
         return dimacs_str;
 
+    } catch (const BudgetExceeded& e) {
+        result.error_message = e.what();
+        result.limit_exceeded = true;
+        return "";
     } catch (const std::exception& e) {
         result.error_message = e.what();
         return "";
     }
 }
 
+// Estimate with default mode
+EstimateResult UVL2Dimacs::estimate(const std::string& input_file) {
+    return estimate(input_file, mode_);
+}
+
+// Estimate with specified mode
+EstimateResult UVL2Dimacs::estimate(const std::string& input_file, ConversionMode mode) {
+    EstimateResult result;
+    result.mode = mode;
+
+    try {
+        // Open and parse the UVL file
+        std::ifstream stream(input_file);
+        if (!stream.is_open()) {
+            result.error_message = "Could not open file: " + input_file;
+            return result;
+        }
+        ANTLRInputStream input(stream);
+        UVLCppLexer lexer(&input);
+        std::string parse_error;
+        CustomErrorListener errorListener(parse_error);
+        lexer.removeErrorListeners();
+        lexer.addErrorListener(&errorListener);
+        CommonTokenStream tokens(&lexer);
+        UVLCppParser parser(&tokens);
+        parser.removeErrorListeners();
+        parser.addErrorListener(&errorListener);
+        ParseTree* tree = parser.featureModel();
+        if (!parse_error.empty()) {
+            result.error_message = parse_error;
+            return result;
+        }
+
+        FeatureModelBuilder builder;
+        ParseTreeWalker::DEFAULT.walk(&builder, tree);
+        auto feature_model = builder.get_feature_model();
+        if (!feature_model) {
+            result.error_message = "Failed to build feature model";
+            return result;
+        }
+
+        // Predict the encoding size
+        EncodingEstimator estimator(feature_model);
+        estimator.set_at_most_one_policy(to_at_most_one_policy(at_most_one_encoding_, at_most_one_threshold_));
+        estimator.set_cardinality_policy(to_cardinality_policy(cardinality_encoding_, cardinality_threshold_));
+        estimator.estimate(to_cnf_mode(mode));
+        const EncodingCost& total = estimator.get_total();
+        result.num_variables = total.variables;
+        result.num_clauses = total.clauses;
+        result.num_literals = total.literals;
+        result.num_bytes = EncodingEstimator::get_arena_bytes(total);
+        for (const auto& item : estimator.get_items()) {
+            CostEstimate cost;
+            cost.kind = item.kind == EncodingCostItem::Kind::RELATION ? "relation" : "constraint";
+            cost.name = item.name;
+            cost.num_variables = item.cost.variables;
+            cost.num_clauses = item.cost.clauses;
+            cost.num_literals = item.cost.literals;
+            result.items.push_back(std::move(cost));
+        }
+
+        if (verbose_) {
+            std::cout << "Estimated encoding:" << std::endl;
+            std::cout << "  Variables: " << result.num_variables << std::endl;
+            std::cout << "  Clauses: " << result.num_clauses << std::endl;
+            std::cout << "  Literals: " << result.num_literals << std::endl;
+        }
+
+        result.success = true;
+        return result;
+
+    } catch (const std::exception& e) {
+        result.error_message = e.what();
+        return result;
+    }
+}
+
 } // namespace uvl2dimacs
@@ -34,6 +34,17 @@
 #include "FeatureModelBuilder.hh"
 #include "FMToCNF.hh"
 #include "DimacsWriter.hh"
+#include "DimacsStreamWriter.hh"
+#include "OpbStreamWriter.hh"
+#include "KnfStreamWriter.hh"
+#include "ClauseNormalizer.hh"
+#include "EquivalenceReducer.hh"
+#include "VariableRenumberer.hh"
+#include "ComponentDecomposer.hh"
+#include "FeatureSlicer.hh"
+#include "SatPreprocessor.hh"
+#include "EncodingEstimator.hh"
+#include "ResourceBudget.hh"
 #include "BackboneSimplifier.hh"
 #include "UVLCppLexer.h"
 #include "UVLCppParser.h"
@@ -42,6 +53,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
 #include <chrono>
 #include <cstdlib>
 #include <unistd.h>
@@ -134,7 +146,7 @@ void print_banner(std::ostream& out) {
  */
 void print_usage(const char* program_name) {
     print_banner(std::cerr);
-    std::cerr << "Usage: " << program_name << " [-t|-s] [-b] <input.uvl> <output.dimacs>" << std::endl;
+    std::cerr << "Usage: " << program_name << " [-t|-T|-y|-s] [-b] [-l] [-n] [-e] [-c] [-r order] [-o] [-m MB] [-j N] [-f format] [-d] [-k file] [-p] [-x] [-q limits] [-a encoding[:k]] [-g encoding[:k]] <input.uvl> <output.dimacs>" << std::endl;
     std::cerr << std::endl;
     std::cerr << "Description:" << std::endl;
     std::cerr << "  Converts a UVL (Universal Variability Language) feature model" << std::endl;
@@ -143,7 +155,40 @@ void print_usage(const char* program_name) {
     std::cerr << "Options:" << std::endl;
     std::cerr << "  -s            Use straightforward conversion without auxiliary variables (default)" << std::endl;
     std::cerr << "  -t            Use Tseitin transformation with auxiliary variables" << std::endl;
+    std::cerr << "  -T            Use polarity-aware Tseitin (Plaisted-Greenbaum): fewer clauses," << std::endl;
+    std::cerr << "                same feature solutions, but model counts are not preserved" << std::endl;
+    std::cerr << "  -y            Hybrid: convert each constraint directly or with Tseitin," << std::endl;
+    std::cerr << "                whichever gives fewer literals" << std::endl;
     std::cerr << "  -b            Simplify output using backbone" << std::endl;
+    std::cerr << "  -l            Low-memory mode: write clauses to the output while transforming" << std::endl;
+    std::cerr << "  -n            Normalize clauses: remove tautologies, duplicates and subsumed clauses" << std::endl;
+    std::cerr << "  -e            Merge equivalent variables (mandatory chains, <=> constraints)" << std::endl;
+    std::cerr << "  -c            Fix core and dead features found from the tree and simplify clauses" << std::endl;
+    std::cerr << "  -r order      Renumber variables: bfs (tree breadth-first), rcm (reverse" << std::endl;
+    std::cerr << "                Cuthill-McKee), aux (auxiliaries next to their definition)" << std::endl;
+    std::cerr << "  -o            Write clauses in canonical order (sorted literals and clauses)" << std::endl;
+    std::cerr << "  -m MB         Spill clauses to a memory-mapped temporary file beyond MB megabytes" << std::endl;
+    std::cerr << "                (not with -n, -o, -k or -p, which rebuild the formula in memory)" << std::endl;
+    std::cerr << "  -j N          Encode relations and constraints on N threads (0 = all cores), same output" << std::endl;
+    std::cerr << "                (straightforward mode only; ignored with -q and -f opb/knf)" << std::endl;
+    std::cerr << "  -f format     Output format: dimacs (default), opb (pseudo-Boolean) or knf" << std::endl;
+    std::cerr << "                (DIMACS with cardinality lines); opb and knf keep cardinality" << std::endl;
+    std::cerr << "                groups as native constraints and imply -l" << std::endl;
+    std::cerr << "  -d            Split into independent components: output.dimacs becomes a manifest" << std::endl;
+    std::cerr << "                listing one DIMACS file per component (output_<k>.dimacs)" << std::endl;
+    std::cerr << "  -k file       Keep only the features listed in file (one per line), eliminating" << std::endl;
+    std::cerr << "                all other variables: solutions are the projections onto them" << std::endl;
+    std::cerr << "                (fails if the formula grows beyond 1000000 clauses)" << std::endl;
+    std::cerr << "  -p            Preprocess: eliminate auxiliary variables, subsumed and blocked" << std::endl;
+    std::cerr << "                clauses with all feature variables kept" << std::endl;
+    std::cerr << "  -x            Estimate only: predict variables, clauses and literals per mode" << std::endl;
+    std::cerr << "                without generating the CNF (output.dimacs may be omitted)" << std::endl;
+    std::cerr << "  -q limits     Fail fast beyond resource limits, a comma-separated list of" << std::endl;
+    std::cerr << "                clauses=N, literals=N, seconds=S and mb=M (resident memory)" << std::endl;
+    std::cerr << "  -a encoding   At-most-one encoding of alternative groups with at least k children" << std::endl;
+    std::cerr << "                (default 8): pairwise, sequential, ladder, commander, bimander, product" << std::endl;
+    std::cerr << "  -g encoding   Encoding of cardinality groups with at least k children (default 8):" << std::endl;
+    std::cerr << "                enumeration, sequential, totalizer, network, auto (smallest counter)" << std::endl;
     std::cerr << std::endl;
     std::cerr << "Arguments:" << std::endl;
     std::cerr << "  input.uvl     Path to input UVL file" << std::endl;
@@ -153,6 +198,15 @@ void print_usage(const char* program_name) {
     std::cerr << "  This version is compiled with -O3 optimization for maximum speed." << std::endl;
 }
 
+/**
+ * @brief Output file formats of -f
+ */
+enum class OutputFormat {
+    DIMACS,  ///< DIMACS CNF (clauses only)
+    OPB,     ///< Pseudo-Boolean OPB with native at-least constraints
+    KNF      ///< DIMACS with native cardinality lines ("k <bound> ...")
+};
+
 /**
  * @brief Structure to hold command-line arguments
  */
@@ -160,10 +214,145 @@ struct CommandLineArgs {
     CNFMode mode = CNFMode::STRAIGHTFORWARD;
     bool verbose = true;
     bool use_backbone = false;
+    bool use_streaming = false;
+    bool use_normalization = false;
+    bool use_equivalences = false;
+    bool use_structural = false;
+    RenumberStrategy renumbering = RenumberStrategy::NONE;
+    bool use_canonical_order = false;
+    size_t spill_threshold = 0;
+    bool use_components = false;
+    std::string keep_file;
+    bool use_preprocessing = false;
+    bool estimate_only = false;
+    uint64_t max_clauses = 0;
+    uint64_t max_literals = 0;
+    double max_seconds = 0;
+    uint64_t max_megabytes = 0;
+    AtMostOnePolicy at_most_one;
+    CardinalityPolicy cardinality;
+    unsigned num_threads = 1;
+    OutputFormat format = OutputFormat::DIMACS;
     std::string input_file;
     std::string output_file;
 };
 
+/**
+ * @brief Parse the resource limits of -q
+ * @param limits Comma-separated "name=value" pairs
+ * @param args Arguments receiving the limits
+ * @return False if a pair is malformed or names an unknown limit
+ */
+bool parse_limits(const std::string& limits, CommandLineArgs& args) {
+    size_t begin = 0;
+    while (begin <= limits.size()) {
+        size_t end = limits.find(',', begin);
+        if (end == std::string::npos) {
+            end = limits.size();
+        }
+        std::string pair = limits.substr(begin, end - begin);
+        size_t equals = pair.find('=');
+        if (equals == std::string::npos || equals + 1 == pair.size()) {
+            return false;
+        }
+        std::string name = pair.substr(0, equals);
+        std::string value = pair.substr(equals + 1);
+        char* rest = nullptr;
+        if (name == "seconds") {
+            args.max_seconds = std::strtod(value.c_str(), &rest);
+            if (*rest != '\0' || args.max_seconds <= 0) {
+                return false;
+            }
+        } else {
+            unsigned long long number = std::strtoull(value.c_str(), &rest, 10);
+            if (*rest != '\0' || number == 0 || value[0] == '-') {
+                return false;
+            }
+            if (name == "clauses") {
+                args.max_clauses = number;
+            } else if (name == "literals") {
+                args.max_literals = number;
+            } else if (name == "mb") {
+                args.max_megabytes = number;
+            } else {
+                return false;
+            }
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Parse the at-most-one encoding of -a
+ * @param spec Encoding name, optionally followed by ":k" (smallest group size using it)
+ * @param args Arguments receiving the policy
+ * @return False if the name is unknown or the threshold is malformed
+ */
+bool parse_at_most_one(const std::string& spec, CommandLineArgs& args) {
+    size_t colon = spec.find(':');
+    std::string name = spec.substr(0, colon);
+    if (name == "pairwise") {
+        args.at_most_one.encoding = AtMostOneEncoding::PAIRWISE;
+    } else if (name == "sequential") {
+        args.at_most_one.encoding = AtMostOneEncoding::SEQUENTIAL;
+    } else if (name == "ladder") {
+        args.at_most_one.encoding = AtMostOneEncoding::LADDER;
+    } else if (name == "commander") {
+        args.at_most_one.encoding = AtMostOneEncoding::COMMANDER;
+    } else if (name == "bimander") {
+        args.at_most_one.encoding = AtMostOneEncoding::BIMANDER;
+    } else if (name == "product") {
+        args.at_most_one.encoding = AtMostOneEncoding::PRODUCT;
+    } else {
+        return false;
+    }
+    if (colon != std::string::npos) {
+        std::string threshold = spec.substr(colon + 1);
+        char* rest = nullptr;
+        unsigned long long value = std::strtoull(threshold.c_str(), &rest, 10);
+        if (threshold.empty() || *rest != '\0' || threshold[0] == '-') {
+            return false;
+        }
+        args.at_most_one.threshold = static_cast<size_t>(value);
+    }
+    return true;
+}
+
+/**
+ * @brief Parse the cardinality encoding of -g
+ * @param spec Encoding name, optionally followed by ":k" (smallest group size using it)
+ * @param args Arguments receiving the policy
+ * @return False if the name is unknown or the threshold is malformed
+ */
+bool parse_cardinality(const std::string& spec, CommandLineArgs& args) {
+    size_t colon = spec.find(':');
+    std::string name = spec.substr(0, colon);
+    if (name == "enumeration") {
+        args.cardinality.encoding = CardinalityEncoding::ENUMERATION;
+    } else if (name == "sequential") {
+        args.cardinality.encoding = CardinalityEncoding::SEQUENTIAL_COUNTER;
+    } else if (name == "totalizer") {
+        args.cardinality.encoding = CardinalityEncoding::TOTALIZER;
+    } else if (name == "network") {
+        args.cardinality.encoding = CardinalityEncoding::SORTING_NETWORK;
+    } else if (name == "auto") {
+        args.cardinality.encoding = CardinalityEncoding::AUTO;
+    } else {
+        return false;
+    }
+    if (colon != std::string::npos) {
+        std::string threshold = spec.substr(colon + 1);
+        char* rest = nullptr;
+        unsigned long long value = std::strtoull(threshold.c_str(), &rest, 10);
+        if (threshold.empty() || *rest != '\0' || threshold[0] == '-') {
+            return false;
+        }
+        args.cardinality.threshold = static_cast<size_t>(value);
+    }
+    return true;
+}
+
 /**
  * @brief Parse command-line arguments
  * @param argc Argument count
@@ -179,10 +368,104 @@ CommandLineArgs parse_arguments(int argc, char* argv[]) {
         std::string flag = argv[arg_index];
         if (flag == "-t") {
             args.mode = CNFMode::TSEITIN;
+        } else if (flag == "-T") {
+            args.mode = CNFMode::PLAISTED_GREENBAUM;
+        } else if (flag == "-y") {
+            args.mode = CNFMode::HYBRID;
         } else if (flag == "-s") {
             args.mode = CNFMode::STRAIGHTFORWARD;
         } else if (flag == "-b") {
             args.use_backbone = true;
+        } else if (flag == "-l") {
+            args.use_streaming = true;
+        } else if (flag == "-n") {
+            args.use_normalization = true;
+        } else if (flag == "-e") {
+            args.use_equivalences = true;
+        } else if (flag == "-c") {
+            args.use_structural = true;
+        } else if (flag == "-r") {
+            std::string order = arg_index + 1 < argc ? argv[++arg_index] : "";
+            if (order == "bfs") {
+                args.renumbering = RenumberStrategy::TREE_BFS;
+            } else if (order == "rcm") {
+                args.renumbering = RenumberStrategy::CUTHILL_MCKEE;
+            } else if (order == "aux") {
+                args.renumbering = RenumberStrategy::AUX_NEXT_TO_DEFINITION;
+            } else {
+                std::cerr << "Error: Unknown variable order '" << order << "'" << std::endl;
+                print_usage(argv[0]);
+                exit(1);
+            }
+        } else if (flag == "-o") {
+            args.use_canonical_order = true;
+        } else if (flag == "-k") {
+            if (arg_index + 1 >= argc) {
+                std::cerr << "Error: -k requires a file of feature names" << std::endl;
+                print_usage(argv[0]);
+                exit(1);
+            }
+            args.keep_file = argv[++arg_index];
+        } else if (flag == "-d") {
+            args.use_components = true;
+        } else if (flag == "-p") {
+            args.use_preprocessing = true;
+        } else if (flag == "-x") {
+            args.estimate_only = true;
+        } else if (flag == "-q") {
+            std::string limits = arg_index + 1 < argc ? argv[++arg_index] : "";
+            if (!parse_limits(limits, args)) {
+                std::cerr << "Error: Invalid resource limits '" << limits << "'" << std::endl;
+                print_usage(argv[0]);
+                exit(1);
+            }
+        } else if (flag == "-a") {
+            std::string spec = arg_index + 1 < argc ? argv[++arg_index] : "";
+            if (!parse_at_most_one(spec, args)) {
+                std::cerr << "Error: Unknown at-most-one encoding '" << spec << "'" << std::endl;
+                print_usage(argv[0]);
+                exit(1);
+            }
+        } else if (flag == "-g") {
+            std::string spec = arg_index + 1 < argc ? argv[++arg_index] : "";
+            if (!parse_cardinality(spec, args)) {
+                std::cerr << "Error: Unknown cardinality encoding '" << spec << "'" << std::endl;
+                print_usage(argv[0]);
+                exit(1);
+            }
+        } else if (flag == "-m") {
+            std::string megabytes = arg_index + 1 < argc ? argv[++arg_index] : "";
+            char* end = nullptr;
+            unsigned long long value = std::strtoull(megabytes.c_str(), &end, 10);
+            if (megabytes.empty() || *end != '\0' || value == 0) {
+                std::cerr << "Error: Invalid memory limit '" << megabytes << "'" << std::endl;
+                print_usage(argv[0]);
+                exit(1);
+            }
+            args.spill_threshold = static_cast<size_t>(value) << 20;
+        } else if (flag == "-j") {
+            std::string threads = arg_index + 1 < argc ? argv[++arg_index] : "";
+            char* end = nullptr;
+            unsigned long value = std::strtoul(threads.c_str(), &end, 10);
+            if (threads.empty() || *end != '\0' || value > 1024) {
+                std::cerr << "Error: Invalid number of threads '" << threads << "'" << std::endl;
+                print_usage(argv[0]);
+                exit(1);
+            }
+            args.num_threads = static_cast<unsigned>(value);
+        } else if (flag == "-f") {
+            std::string format = arg_index + 1 < argc ? argv[++arg_index] : "";
+            if (format == "dimacs") {
+                args.format = OutputFormat::DIMACS;
+            } else if (format == "opb") {
+                args.format = OutputFormat::OPB;
+            } else if (format == "knf") {
+                args.format = OutputFormat::KNF;
+            } else {
+                std::cerr << "Error: Unknown output format '" << format << "'" << std::endl;
+                print_usage(argv[0]);
+                exit(1);
+            }
         } else {
             std::cerr << "Error: Unknown flag '" << flag << "'" << std::endl;
             print_usage(argv[0]);
@@ -191,14 +474,48 @@ CommandLineArgs parse_arguments(int argc, char* argv[]) {
         arg_index++;
     }
 
-    // Check argument count
-    if (argc - arg_index != 2) {
+    // Native cardinality constraints only exist while streaming
+    if (args.format != OutputFormat::DIMACS) {
+        if (args.use_backbone || args.use_components) {
+            std::cerr << "Error: -b and -d cannot be combined with -f opb or -f knf" << std::endl;
+            print_usage(argv[0]);
+            exit(1);
+        }
+        args.use_streaming = true;
+    }
+
+    if (args.use_streaming && (args.use_normalization || args.use_equivalences || !args.keep_file.empty() ||
+                               args.use_preprocessing || args.renumbering != RenumberStrategy::NONE ||
+                               args.use_canonical_order)) {
+        std::cerr << "Error: -n, -e, -k, -p, -r and -o cannot be combined with -l, -f opb or -f knf" << std::endl;
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    // These passes rebuild the formula in heap memory, defeating the spill limit
+    if (args.spill_threshold != 0 && (args.use_normalization || args.use_canonical_order ||
+                                      !args.keep_file.empty() || args.use_preprocessing)) {
+        std::cerr << "Error: -n, -o, -k and -p cannot be combined with -m" << std::endl;
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    if (args.use_components && (args.use_streaming || args.use_backbone)) {
+        std::cerr << "Error: -d cannot be combined with -l or -b" << std::endl;
+        print_usage(argv[0]);
+        exit(1);
+    }
+
+    // Check argument count (the output file is not needed for an estimate)
+    if (argc - arg_index != 2 && !(args.estimate_only && argc - arg_index == 1)) {
         print_usage(argv[0]);
         exit(1);
     }
 
     args.input_file = argv[arg_index];
-    args.output_file = argv[arg_index + 1];
+    if (argc - arg_index == 2) {
+        args.output_file = argv[arg_index + 1];
+    }
 
     return args;
 }
@@ -311,41 +628,296 @@ bool apply_backbone_simplification(const std::string& output_file, bool verbose)
     }
 }
 
+/**
+ * @brief Print the core/dead features fixed by structural simplification
+ * @param transformer Transformer after transform()
+ */
+void print_structure_stats(const FMToCNF& transformer) {
+    std::cout << "  Core:        " << transformer.get_num_core_features() << " features" << std::endl;
+    std::cout << "  Dead:        " << transformer.get_num_dead_features() << " features" << std::endl;
+    std::cout << "  Simplified:  " << transformer.get_num_simplified_clauses() << " satisfied clauses dropped" << std::endl;
+    if (transformer.is_void_model()) {
+        std::cout << "  Warning:     model is void (no valid configuration), clauses left unsimplified" << std::endl;
+    }
+}
+
+/**
+ * @brief Read the feature names to keep, one per line
+ * @param path Path to the feature list
+ * @return Feature names (blank lines are skipped)
+ * @throws std::runtime_error if the file cannot be opened
+ */
+std::vector<std::string> read_feature_list(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open feature list: " + path);
+    }
+    std::vector<std::string> features;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            features.push_back(line);
+        }
+    }
+    return features;
+}
+
+/**
+ * @brief Format a predicted count, or "unbounded" if it saturated
+ * @param value Count from EncodingEstimator
+ * @return Decimal count or "unbounded"
+ */
+std::string format_estimate(uint64_t value) {
+    return value == EncodingEstimator::UNBOUNDED ? "unbounded" : std::to_string(value);
+}
+
+/**
+ * @brief Print the predicted encoding size of both CNF modes
+ *
+ * The Plaisted-Greenbaum and hybrid modes are only estimated when selected.
+ *
+ * @param feature_model Feature model to estimate
+ * @param args Arguments with the mode and the encodings of alternative and cardinality groups
+ */
+void print_estimates(std::shared_ptr<FeatureModel> feature_model, const CommandLineArgs& args) {
+    const size_t largest = 5;
+    EncodingEstimator estimator(feature_model);
+    estimator.set_at_most_one_policy(args.at_most_one);
+    estimator.set_cardinality_policy(args.cardinality);
+    std::vector<CNFMode> modes = {CNFMode::STRAIGHTFORWARD, CNFMode::TSEITIN};
+    if (args.mode == CNFMode::PLAISTED_GREENBAUM || args.mode == CNFMode::HYBRID) {
+        modes.push_back(args.mode);
+    }
+    for (CNFMode mode : modes) {
+        estimator.estimate(mode);
+        const EncodingCost& total = estimator.get_total();
+        uint64_t bytes = EncodingEstimator::get_arena_bytes(total);
+
+        const char* name = mode == CNFMode::TSEITIN ? "Tseitin" :
+                           mode == CNFMode::PLAISTED_GREENBAUM ? "Plaisted-Greenbaum" :
+                           mode == CNFMode::HYBRID ? "hybrid" : "straightforward";
+        std::cout << "Estimate (" << name << "):" << std::endl;
+        std::cout << "  Variables:   " << format_estimate(total.variables) << std::endl;
+        std::cout << "  Clauses:     " << format_estimate(total.clauses) << std::endl;
+        std::cout << "  Literals:    " << format_estimate(total.literals) << std::endl;
+        std::cout << "  Memory:      " << (bytes == EncodingEstimator::UNBOUNDED ? "unbounded" :
+                                           std::to_string((bytes + (1 << 20) - 1) >> 20) + " MB")
+                  << " (clause arena)" << std::endl;
+        for (size_t index : estimator.get_largest_items(largest)) {
+            const EncodingCostItem& item = estimator.get_items()[index];
+            std::cout << "  Largest:     " << item.name << ": " << format_estimate(item.cost.clauses)
+                      << " clauses, " << format_estimate(item.cost.literals) << " literals" << std::endl;
+        }
+    }
+}
+
 int main(int argc, char* argv[]) {
     // Parse command-line arguments
     CommandLineArgs args = parse_arguments(argc, argv);
 
     // Start timer
     auto start_time = std::chrono::high_resolution_clock::now();
+    ResourceBudget budget;
+    budget.set_max_clauses(args.max_clauses);
+    budget.set_max_literals(args.max_literals);
+    budget.set_max_seconds(args.max_seconds);
+    budget.set_max_rss(args.max_megabytes << 20);
+    budget.start();
 
     try {
         // Print banner and configuration
         if (args.verbose) {
             print_banner(std::cout);
-            std::cout << "CNF Mode: " << (args.mode == CNFMode::TSEITIN ?
-                "Tseitin (with auxiliary variables)" : "Straightforward (no auxiliary variables)") << std::endl;
+            std::cout << "CNF Mode: " << (args.mode == CNFMode::TSEITIN ? "Tseitin (with auxiliary variables)" :
+                args.mode == CNFMode::PLAISTED_GREENBAUM ? "Plaisted-Greenbaum (polarity-aware Tseitin)" :
+                args.mode == CNFMode::HYBRID ? "Hybrid (direct or Tseitin per constraint)" :
+                "Straightforward (no auxiliary variables)") << std::endl;
             std::cout << "Input:  " << args.input_file << std::endl;
-            std::cout << "Output: " << args.output_file << std::endl;
+            if (!args.output_file.empty()) {
+                std::cout << "Output: " << args.output_file << std::endl;
+            }
             std::cout << std::endl;
         }
 
         // Parse UVL file and build feature model
         auto feature_model = parse_uvl_file(args.input_file, args.verbose);
 
+        // Dry run: predict the encoding size and stop
+        if (args.estimate_only) {
+            print_estimates(feature_model, args);
+            return 0;
+        }
+
         // Transform to CNF
-        if (args.verbose) std::cout << "[4/5] Transforming to CNF..." << std::endl;
         FMToCNF transformer(feature_model);
-        CNFModel cnf_model = transformer.transform(args.mode);
-
-        if (args.verbose) {
-            std::cout << "  Variables:   " << cnf_model.get_num_variables() << std::endl;
-            std::cout << "  Clauses:     " << cnf_model.get_num_clauses() << std::endl;
+        transformer.set_structural_simplification(args.use_structural);
+        transformer.set_spill_threshold(args.spill_threshold);
+        transformer.set_at_most_one_policy(args.at_most_one);
+        transformer.set_cardinality_policy(args.cardinality);
+        transformer.set_num_threads(args.num_threads);
+        if (budget.is_limited()) {
+            transformer.set_resource_budget(&budget);
+        }
+        if (args.num_threads != 1 && !transformer.supports_threads(args.mode, args.format != OutputFormat::DIMACS)) {
+            std::cerr << "Warning: -j is ignored with -t, -T, -y, -q and -f opb/knf, encoding on one thread"
+                      << std::endl;
+        }
+        if (args.use_streaming) {
+            // Transform and write in a single pass
+            if (args.verbose) std::cout << "[4/5] Transforming to CNF (streaming)..." << std::endl;
+            uint64_t num_clauses = 0;
+            uint64_t num_cardinality = 0;
+            if (args.format == OutputFormat::OPB) {
+                if (args.verbose) std::cout << "[5/5] Writing OPB file..." << std::endl;
+                OpbStreamWriter writer(args.output_file);
+                transformer.transform(writer, args.mode);
+                num_clauses = writer.get_num_constraints();
+                num_cardinality = writer.get_num_cardinality_constraints();
+            } else if (args.format == OutputFormat::KNF) {
+                if (args.verbose) std::cout << "[5/5] Writing KNF file..." << std::endl;
+                KnfStreamWriter writer(args.output_file);
+                transformer.transform(writer, args.mode);
+                num_clauses = writer.get_num_clauses();
+                num_cardinality = writer.get_num_cardinality_constraints();
+            } else {
+                if (args.verbose) std::cout << "[5/5] Writing DIMACS file..." << std::endl;
+                DimacsStreamWriter writer(args.output_file);
+                transformer.transform(writer, args.mode);
+                num_clauses = writer.get_num_clauses();
+            }
+            if (args.verbose && args.use_structural) print_structure_stats(transformer);
+
+            if (args.verbose) {
+                std::cout << "  Variables:   " << transformer.get_cnf_model().get_num_variables() << std::endl;
+                std::cout << (args.format == OutputFormat::OPB ? "  Constraints: " : "  Clauses:     ")
+                          << num_clauses << std::endl;
+                if (args.format != OutputFormat::DIMACS) {
+                    std::cout << "  Cardinality: " << num_cardinality << " native constraints" << std::endl;
+                }
+                if (args.mode != CNFMode::STRAIGHTFORWARD) {
+                    std::cout << "  Shared:      " << transformer.get_num_shared_gates() << " gates reused" << std::endl;
+                }
+                if (args.mode == CNFMode::HYBRID) {
+                    std::cout << "  Tseitin:     " << transformer.get_num_tseitin_constraints() << " constraints" << std::endl;
+                }
+            }
+        } else {
+            if (args.verbose) std::cout << "[4/5] Transforming to CNF..." << std::endl;
+            CNFModel cnf_model = transformer.transform(args.mode);
+            if (args.verbose && args.use_structural) print_structure_stats(transformer);
+
+            if (args.verbose) {
+                std::cout << "  Variables:   " << cnf_model.get_num_variables() << std::endl;
+                std::cout << "  Clauses:     " << cnf_model.get_num_clauses() << std::endl;
+                if (args.mode != CNFMode::STRAIGHTFORWARD) {
+                    std::cout << "  Shared:      " << transformer.get_num_shared_gates() << " gates reused" << std::endl;
+                }
+                if (args.mode == CNFMode::HYBRID) {
+                    std::cout << "  Tseitin:     " << transformer.get_num_tseitin_constraints() << " constraints" << std::endl;
+                }
+                if (cnf_model.is_spilled()) {
+                    std::cout << "  Spilled:     clause arena moved to a temporary file" << std::endl;
+                }
+            }
+
+            // Merge equivalent variables if requested
+            if (args.use_equivalences) {
+                EquivalenceReducer reducer;
+                reducer.reduce(cnf_model);
+
+                if (args.verbose) {
+                    std::cout << "  Merged:      " << reducer.get_merged_variables() << " equivalent variables, "
+                              << reducer.get_removed_clauses() << " clauses removed" << std::endl;
+                    if (reducer.is_unsatisfiable()) {
+                        std::cout << "  Warning:     formula is unsatisfiable (a variable equals its negation)" << std::endl;
+                    }
+                    std::cout << "  Variables:   " << cnf_model.get_num_variables() << std::endl;
+                    std::cout << "  Clauses:     " << cnf_model.get_num_clauses() << std::endl;
+                }
+            }
+
+            // Project onto the kept features if requested
+            if (!args.keep_file.empty()) {
+                FeatureSlicer slicer(read_feature_list(args.keep_file));
+                slicer.slice(cnf_model);
+
+                if (args.verbose) {
+                    std::cout << "  Sliced:      " << slicer.get_kept_variables() << " kept, "
+                              << slicer.get_eliminated_variables() << " eliminated variables" << std::endl;
+                    std::cout << "  Variables:   " << cnf_model.get_num_variables() << std::endl;
+                    std::cout << "  Clauses:     " << cnf_model.get_num_clauses() << std::endl;
+                }
+            }
+
+            // Normalize clauses if requested
+            if (args.use_normalization) {
+                ClauseNormalizer normalizer;
+                normalizer.normalize(cnf_model);
+
+                if (args.verbose) {
+                    std::cout << "  Normalized:  " << normalizer.get_tautologies() << " tautologies, "
+                              << normalizer.get_duplicate_clauses() << " duplicates, "
+                              << normalizer.get_subsumed_clauses() << " subsumed clauses removed" << std::endl;
+                    std::cout << "  Clauses:     " << cnf_model.get_num_clauses() << std::endl;
+                }
+            }
+
+            // Preprocess with the feature variables frozen if requested
+            if (args.use_preprocessing) {
+                SatPreprocessor preprocessor;
+                preprocessor.preprocess(cnf_model);
+
+                if (args.verbose) {
+                    std::cout << "  Preprocessed: " << preprocessor.get_eliminated_variables() << " auxiliary variables, "
+                              << preprocessor.get_removed_clauses() << " clauses removed ("
+                              << preprocessor.get_blocked_clauses() << " blocked)" << std::endl;
+                    if (preprocessor.is_unsatisfiable()) {
+                        std::cout << "  Warning:     formula is unsatisfiable (left unchanged)" << std::endl;
+                    }
+                    std::cout << "  Variables:   " << cnf_model.get_num_variables() << std::endl;
+                    std::cout << "  Clauses:     " << cnf_model.get_num_clauses() << std::endl;
+                }
+            }
+
+            // Renumber variables if requested
+            if (args.renumbering != RenumberStrategy::NONE) {
+                VariableRenumberer renumberer(args.renumbering);
+                renumberer.renumber(cnf_model, feature_model);
+
+                if (args.verbose) {
+                    std::cout << "  Bandwidth:   " << renumberer.get_bandwidth_before()
+                              << " -> " << renumberer.get_bandwidth_after() << std::endl;
+                }
+            }
+
+            // Sort clauses canonically if requested
+            if (args.use_canonical_order) {
+                ClauseNormalizer::sort_canonically(cnf_model);
+            }
+            budget.check("post-processing");
+
+            if (args.use_components) {
+                // Write one DIMACS file per component and the manifest
+                if (args.verbose) std::cout << "[5/5] Writing component files..." << std::endl;
+                ComponentDecomposer decomposer(cnf_model);
+                decomposer.decompose();
+                decomposer.write_files(args.output_file);
+
+                if (args.verbose) {
+                    std::cout << "  Components:  " << decomposer.get_num_components() << " ("
+                              << decomposer.get_num_fixed_variables() << " fixed, "
+                              << decomposer.get_num_free_variables() << " free variables)" << std::endl;
+                }
+            } else {
+                // Write DIMACS file
+                if (args.verbose) std::cout << "[5/5] Writing DIMACS file..." << std::endl;
+                DimacsWriter writer(cnf_model);
+                writer.write_to_file(args.output_file);
+            }
         }
-
-        // Write DIMACS file
-        if (args.verbose) std::cout << "[5/5] Writing DIMACS file..." << std::endl;
-        DimacsWriter writer(cnf_model);
-        writer.write_to_file(args.output_file);
 
         // Apply backbone simplification if requested
         if (args.use_backbone) {
@@ -357,7 +929,9 @@ int main(int argc, char* argv[]) {
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
         std::cout << std::endl;
-        std::cout << "Success! DIMACS file created." << std::endl;
+        std::cout << "Success! " << (args.format == OutputFormat::OPB ? "OPB" :
+                                     args.format == OutputFormat::KNF ? "KNF" : "DIMACS")
+                  << " file created." << std::endl;
         if (args.verbose) {
             std::cout << "Time elapsed: " << duration.count() << " ms" << std::endl;
         }
@@ -14,10 +14,13 @@
 #define ASTNODE_H
 
 #include "CNFMode.hh"
+#include "ClauseSink.hh"
+#include "GateCache.hh"
 #include <string>
 #include <vector>
 #include <memory>
 #include <functional>
+#include <utility>
 
 /**
  * @enum ASTOperation
@@ -86,6 +89,19 @@ public:
         STRING        ///< Leaf node containing a string constant
     };
 
+    /**
+     * @enum Polarity
+     * @brief Occurrences of a subexpression, as needed by Plaisted-Greenbaum
+     *
+     * A gate occurring only positively needs just "gate → operation"; one
+     * occurring only negatively needs just "operation → gate".
+     */
+    enum class Polarity {
+        POSITIVE,     ///< Under an even number of negations only
+        NEGATIVE,     ///< Under an odd number of negations only
+        BOTH          ///< Both (e.g., under an equivalence): full definition
+    };
+
 private:
     Type type;                                             ///< Type of this node (operation or leaf)
     ASTOperation operation;                                ///< Operation type (used when type == OPERATION)
@@ -201,6 +217,28 @@ public:
         CNFMode mode
     ) const;
 
+    /**
+     * @brief Converts this AST to CNF clauses emitted to a sink
+     *
+     * Same conversion as the vector-returning overload, but each clause is
+     * passed to the sink as soon as it is final instead of being collected.
+     * Tseitin clauses are streamed while the tree is traversed.
+     *
+     * @param sink Destination of the generated clauses
+     * @param get_variable Function to map feature names to variable IDs
+     * @param create_aux_var Function to create new auxiliary variables (for Tseitin mode)
+     * @param mode Conversion mode (TSEITIN or STRAIGHTFORWARD)
+     * @param gates Gates shared with the rest of the conversion (Tseitin mode, optional);
+     *        a gate already in it is reused instead of defined again
+     */
+    void get_clauses(
+        ClauseSink& sink,
+        std::function<int(const std::string&)> get_variable,
+        std::function<int()> create_aux_var,
+        CNFMode mode,
+        GateCache* gates = nullptr
+    ) const;
+
     /**
      * @brief Checks if this is a simple literal node
      * @return true if this node is a LITERAL type
@@ -230,37 +268,75 @@ public:
     std::string to_string() const;
 
 private:
+    /// Operand of a flattened chain: subtree and whether it occurs negated
+    using Operand = std::pair<const ASTNode*, bool>;
+
+    /**
+     * @brief Asserts this AST in Tseitin mode
+     *
+     * Emits one clause per flattened conjunct of the root, so the root and
+     * its top-level disjunctions need no auxiliary variables.
+     *
+     * @param sink Destination of the generated clauses
+     * @param get_variable Function to map feature names to variable IDs
+     * @param create_aux_var Function to create new auxiliary variables
+     * @param polarity POSITIVE for Plaisted-Greenbaum, BOTH for plain Tseitin
+     * @param gates Shared gates (nullptr: every gate is defined anew)
+     */
+    void tseitin_assert(
+        ClauseSink& sink,
+        std::function<int(const std::string&)> get_variable,
+        std::function<int()> create_aux_var,
+        Polarity polarity,
+        GateCache* gates
+    ) const;
+
     /**
      * @brief Performs Tseitin transformation on this AST
      *
      * Converts the AST to CNF using Tseitin transformation, which introduces
-     * auxiliary variables to avoid clause explosion.
+     * auxiliary variables to avoid clause explosion. Negations are folded
+     * into literal signs and associative chains become n-ary gates.
+     *
+     * With a polarity other than BOTH (Plaisted-Greenbaum mode), each gate
+     * only gets the clauses of the implication direction it occurs in.
      *
-     * @param clauses Output vector to append generated clauses
+     * @param sink Destination of the generated clauses
      * @param get_variable Function to map feature names to variable IDs
      * @param create_aux_var Function to create new auxiliary variables
-     * @return Variable ID representing the result of this subtree
+     * @param polarity Occurrences of this subtree (BOTH for plain Tseitin)
+     * @param gates Shared gates (nullptr: every gate is defined anew)
+     * @return Literal representing the result of this subtree
      */
     int tseitin_transform(
-        std::vector<std::vector<int>>& clauses,
+        ClauseSink& sink,
         std::function<int(const std::string&)> get_variable,
-        std::function<int()> create_aux_var
+        std::function<int()> create_aux_var,
+        Polarity polarity,
+        GateCache* gates
     ) const;
 
-    /// @brief Adds clauses for NOT operation (result <=> ~child)
-    void add_not_clauses(int result, int child_var, std::vector<std::vector<int>>& clauses) const;
-
-    /// @brief Adds clauses for AND operation (result <=> left & right)
-    void add_and_clauses(int result, int left_var, int right_var, std::vector<std::vector<int>>& clauses) const;
+    /// @brief Flattens an AND or OR chain into signed operands, folding negations
+    void collect_operands(ASTOperation op, bool negated, std::vector<Operand>& operands) const;
 
-    /// @brief Adds clauses for OR operation (result <=> left | right)
-    void add_or_clauses(int result, int left_var, int right_var, std::vector<std::vector<int>>& clauses) const;
-
-    /// @brief Adds clauses for IMPLIES operation (result <=> left => right)
-    void add_implies_clauses(int result, int left_var, int right_var, std::vector<std::vector<int>>& clauses) const;
-
-    /// @brief Adds clauses for EQUIVALENCE operation (result <=> left <=> right)
-    void add_equivalence_clauses(int result, int left_var, int right_var, std::vector<std::vector<int>>& clauses) const;
+    /// @brief Transforms flattened operands to literals
+    static std::vector<int> tseitin_operands(
+        const std::vector<Operand>& operands,
+        ClauseSink& sink,
+        std::function<int(const std::string&)> get_variable,
+        std::function<int()> create_aux_var,
+        Polarity polarity,
+        GateCache* gates
+    );
+
+    /// @brief Adds (or reuses) an n-ary AND/OR gate over inputs[first..last), split to keep clauses at 3 literals
+    static int add_gate(GateType type, const std::vector<int>& inputs, size_t first, size_t last,
+                        ClauseSink& sink, const std::function<int()>& create_aux_var, Polarity polarity,
+                        GateCache* gates);
+
+    /// @brief Adds clauses for EQUIVALENCE operation (result <=> left <=> right, or one direction of it)
+    void add_equivalence_clauses(int result, int left_var, int right_var, ClauseSink& sink,
+                                 Polarity polarity) const;
 
     /**
      * @brief Converts AST to Negation Normal Form
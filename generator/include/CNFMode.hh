@@ -33,6 +33,22 @@
  * - Prevents clause explosion for deeply nested expressions
  * - Better for SAT solvers optimized for 3-CNF
  *
+ * **PLAISTED_GREENBAUM Mode** (3-CNF, satisfiability only):
+ * - Same auxiliary variables and 3-CNF structure as TSEITIN
+ * - Constraint gates only get the implication direction their polarity needs
+ *   (a gate under an even number of negations only implies its operation)
+ * - Roughly halves the constraint clauses
+ * - Equisatisfiable, and the solutions projected onto the features are
+ *   unchanged, but auxiliary variables are no longer fully defined: model
+ *   counts over all variables are NOT preserved
+ *
+ * **HYBRID Mode**:
+ * - Relations are encoded as in STRAIGHTFORWARD mode
+ * - Each constraint is converted directly unless its distributed CNF would
+ *   have more literals than its Tseitin encoding (nested OR-of-AND,
+ *   equivalences), in which case it is Tseitin-encoded
+ * - Preserves model counts; clause length is not bounded
+ *
  * The 3-CNF guarantee applies to:
  * - Boolean constraint expressions (AND, OR, NOT, IMPLIES, IFF)
  * - Feature tree relations (OR groups, ALTERNATIVE groups, CARDINALITY)
@@ -53,8 +69,20 @@
  * @endcode
  */
 enum class CNFMode {
-    TSEITIN,        ///< Tseitin transformation: guarantees 3-CNF (max 3 literals per clause)
-    STRAIGHTFORWARD ///< Direct conversion: fewer variables, potentially longer clauses
+    TSEITIN,            ///< Tseitin transformation: guarantees 3-CNF (max 3 literals per clause)
+    STRAIGHTFORWARD,    ///< Direct conversion: fewer variables, potentially longer clauses
+    PLAISTED_GREENBAUM, ///< Polarity-aware Tseitin: 3-CNF, fewer clauses, not count-preserving
+    HYBRID              ///< Direct or Tseitin per constraint, whichever is smaller
 };
 
+/**
+ * @brief Checks whether a mode decomposes clauses with auxiliary variables into 3-CNF
+ *
+ * @param mode CNF conversion mode
+ * @return true for TSEITIN and PLAISTED_GREENBAUM
+ */
+inline bool is_three_cnf(CNFMode mode) {
+    return mode == CNFMode::TSEITIN || mode == CNFMode::PLAISTED_GREENBAUM;
+}
+
 #endif // CNFMODE_H
@@ -4,7 +4,7 @@
  *
  * This file defines the CNFModel class which represents a boolean formula in CNF format.
  * It maintains mappings between feature names and variable IDs, manages auxiliary variables,
- * and stores the CNF clauses.
+ * and stores the CNF clauses in a flat literal arena.
  *
  * @author UVL2Dimacs Team
  * @date 2024
@@ -13,9 +13,96 @@
 #ifndef CNFMODEL_H
 #define CNFMODEL_H
 
+#include "ClauseSink.hh"
+#include "SpillBuffer.hh"
 #include <string>
 #include <vector>
-#include <map>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <ostream>
+
+/**
+ * @class ClauseView
+ * @brief Read-only view of one clause stored in a CNFModel literal arena
+ *
+ * A ClauseView points into the contiguous literal buffer of a CNFModel. The
+ * arena stores literals as 16-bit or 32-bit integers, so the view steps
+ * through them with the stored width and yields each literal as an int. It
+ * does not own its literals and is invalidated by any operation that appends
+ * to the model.
+ */
+class ClauseView {
+public:
+    /**
+     * @class iterator
+     * @brief Forward iterator yielding the literals of the clause as int
+     */
+    class iterator {
+    private:
+        const char* position;  ///< Current literal
+        size_t width;          ///< Size of a stored literal in bytes
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = int;
+
+        iterator(const char* literal, size_t literal_width) : position(literal), width(literal_width) {}
+
+        int operator*() const { return load(position, width); }
+        iterator& operator++() { position += width; return *this; }
+        iterator operator++(int) { iterator previous = *this; position += width; return previous; }
+        bool operator==(const iterator& other) const { return position == other.position; }
+        bool operator!=(const iterator& other) const { return position != other.position; }
+    };
+
+private:
+    const char* first;  ///< First literal of the clause
+    size_t count;       ///< Number of literals
+    size_t width;       ///< Size of a stored literal in bytes
+
+    static int load(const char* literal, size_t literal_width) {
+        return literal_width == sizeof(int16_t) ? *reinterpret_cast<const int16_t*>(literal)
+                                                : *reinterpret_cast<const int*>(literal);
+    }
+
+public:
+    template <typename Literal>
+    ClauseView(const Literal* begin_ptr, const Literal* end_ptr)
+        : first(reinterpret_cast<const char*>(begin_ptr)),
+          count(static_cast<size_t>(end_ptr - begin_ptr)), width(sizeof(Literal)) {}
+
+    iterator begin() const { return iterator(first, width); }
+    iterator end() const { return iterator(first + count * width, width); }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    int operator[](size_t i) const { return load(first + i * width, width); }
+};
+
+/**
+ * @struct ClauseSpan
+ * @brief Typed view of the whole clause arena of a CNFModel
+ *
+ * Passed to the visitor of CNFModel::visit_arena(), which instantiates the
+ * visitor for the literal and offset widths the arena currently uses, so
+ * clause-level loops run over the stored integers without any per-literal
+ * width dispatch. Clause c spans literals [offsets[c], offsets[c + 1]).
+ *
+ * @tparam Literal Stored literal type (int16_t or int)
+ * @tparam Offset Stored offset type (uint32_t or size_t)
+ */
+template <typename Literal, typename Offset>
+struct ClauseSpan {
+    const Literal* literals;   ///< Literals of all clauses, back to back
+    const Offset* offsets;     ///< Start of each clause plus end sentinel
+    size_t num_clauses;        ///< Number of clauses
+};
 
 /**
  * @class CNFModel
@@ -35,9 +122,31 @@
  * - Feature variables: Mapped from feature names to positive integers starting at 1
  * - Auxiliary variables: Additional variables created during Tseitin transformation
  * - Variable IDs are sequential and unique
+ * - Per-variable information is kept in a dense table indexed by variable ID
+ * - Auxiliary variables only store a small AuxKind tag and their ordinal; the
+ *   "aux_N_kind" name is materialized on demand (e.g., by DimacsWriter)
+ *
+ * **Clause Storage**:
+ * - All literals live in a single contiguous buffer (no per-clause allocation)
+ * - A second buffer holds the start offset of every clause plus a final sentinel,
+ *   so clause i spans literals [offsets[i], offsets[i+1])
+ * - Both buffers start narrow: literals are stored as int16_t while every
+ *   literal fits in 16 bits (models with up to 32767 variables, which covers
+ *   almost every feature model) and offsets as uint32_t while the arena holds
+ *   fewer than 2^32 literals. The first literal or offset that does not fit
+ *   widens the buffer once to int / size_t. Readers either use ClauseView or
+ *   visit_arena(), which runs code compiled for the current widths
+ * - Clauses can be appended from a container or written literal by literal
+ *   with begin_clause() / add_literal() / end_clause()
+ * - CNFModel is the in-memory ClauseSink; encoders can equally write into a
+ *   streaming sink and use a CNFModel only as the variable table
+ * - Both buffers are SpillBuffers: with set_spill_threshold(), a buffer that
+ *   outgrows the limit moves to a memory-mapped temporary file, so formulas
+ *   larger than RAM are paged to disk instead of exhausting memory
  *
  * @see FMToCNF for conversion from FeatureModel to CNFModel
  * @see DimacsWriter for writing CNFModel to DIMACS format
+ * @see ClauseSink for the clause destination interface
  *
  * Example:
  * @code
@@ -48,15 +157,52 @@
  * cnf.add_clause({-1, 2});       // ~GPS | Display (GPS => Display)
  * @endcode
  */
-class CNFModel {
+class CNFModel : public ClauseSink {
+public:
+    /**
+     * @enum AuxKind
+     * @brief Purpose tag of an auxiliary variable, used to build its name on demand
+     */
+    enum class AuxKind : uint8_t {
+        GENERIC,    ///< Plain auxiliary variable, named "aux_N"
+        OR_TREE     ///< Node of an OR tree decomposition, named "aux_N_or_tree"
+    };
+
 private:
-    std::map<std::string, int> variables;           ///< Feature name to variable ID mapping
-    std::map<int, std::string> features;            ///< Variable ID to feature name mapping
-    std::map<int, std::string> auxiliary_variables; ///< Auxiliary variable ID to description mapping
-    std::vector<std::vector<int>> clauses;          ///< CNF clauses (each clause is a vector of literals)
+    /**
+     * @brief Dense per-variable entry
+     *
+     * For features, index is the position in feature_names. For auxiliary
+     * variables, index is the 1-based auxiliary ordinal N used in "aux_N".
+     */
+    struct VariableEntry {
+        bool is_auxiliary;      ///< true for auxiliary variables
+        AuxKind aux_kind;       ///< Purpose tag (auxiliary variables only)
+        uint32_t index;         ///< Feature name index or auxiliary ordinal
+    };
+
+    /**
+     * @brief Variable that was merged into another variable by remap_variables()
+     */
+    struct VariableAlias {
+        VariableEntry entry;    ///< Entry of the merged variable
+        int literal;            ///< Literal of the current variable it is equal to
+    };
+
+    std::unordered_map<std::string, int> variables; ///< Feature name to variable ID mapping
+    std::vector<std::string> feature_names;         ///< Feature names in creation order
+    std::vector<VariableEntry> entries;             ///< Variable ID to entry (slot 0 unused)
+    SpillBuffer<int16_t> short_literals;            ///< Literals of all clauses while they fit in 16 bits
+    SpillBuffer<int> wide_literals;                 ///< Literals of all clauses once widened
+    SpillBuffer<uint32_t> short_offsets;            ///< Clause starts plus end sentinel while they fit in 32 bits
+    SpillBuffer<size_t> wide_offsets;               ///< Clause starts plus end sentinel once widened
+    bool has_wide_literals;                         ///< Literals live in wide_literals
+    bool has_wide_offsets;                          ///< Offsets live in wide_offsets
+    std::vector<VariableAlias> aliases;             ///< Variables merged away by remap_variables()
 
     int next_var_id;   ///< Next available variable ID (starts at 1)
     int aux_counter;   ///< Counter for auxiliary variable naming
+    int num_auxiliary; ///< Number of current variables that are auxiliary
 
 public:
     /**
@@ -71,6 +217,26 @@ public:
      */
     ~CNFModel() = default;
 
+    /**
+     * @brief Copy constructor (deep copy of the clause arena)
+     */
+    CNFModel(const CNFModel&) = default;
+
+    /**
+     * @brief Copy assignment (deep copy of the clause arena)
+     */
+    CNFModel& operator=(const CNFModel&) = default;
+
+    /**
+     * @brief Move constructor (hands the clause arena over without copying)
+     */
+    CNFModel(CNFModel&&) noexcept = default;
+
+    /**
+     * @brief Move assignment (hands the clause arena over without copying)
+     */
+    CNFModel& operator=(CNFModel&&) noexcept = default;
+
     /**
      * @brief Adds a feature variable to the model
      *
@@ -104,49 +270,276 @@ public:
      * Auxiliary variables are used in Tseitin transformation to represent
      * intermediate results of complex expressions.
      *
-     * @param description Optional description of what this auxiliary variable represents
+     * No string is built here: the variable only records its kind and ordinal,
+     * and get_variable_name() / write_variable_name() produce the name lazily.
+     *
+     * @param kind Purpose tag of the auxiliary variable
      * @return The variable ID of the newly created auxiliary variable
      */
-    int create_auxiliary_variable(const std::string& description = "");
+    int create_auxiliary_variable(AuxKind kind = AuxKind::GENERIC);
 
     /**
      * @brief Adds a clause to the CNF formula
      *
      * A clause is a disjunction (OR) of literals. Empty clauses represent
-     * contradictions and should be avoided.
+     * contradictions and should be avoided. The literals are copied into the
+     * arena; brace-enclosed lists and vectors are accepted through the
+     * ClauseSink::add_clause() overloads.
      *
-     * @param clause Vector of literals (positive for variable, negative for negation)
+     * @param first Pointer to the first literal
+     * @param last Pointer one past the last literal
      *
      * Example:
      * @code
      * cnf.add_clause({1, -2, 3});  // Adds clause: v1 | ~v2 | v3
      * @endcode
      */
-    void add_clause(const std::vector<int>& clause);
+    void add_clause(const int* first, const int* last) override;
+    using ClauseSink::add_clause;
+
+    /**
+     * @brief Starts a new clause to be filled with add_literal()
+     *
+     * Literals are written directly into the arena. The clause becomes part of
+     * the formula once end_clause() is called.
+     *
+     * Example:
+     * @code
+     * cnf.begin_clause();
+     * cnf.add_literal(-parent);
+     * for (int child : children) cnf.add_literal(child);
+     * cnf.end_clause();
+     * @endcode
+     */
+    void begin_clause() override {}
+
+    /**
+     * @brief Appends a literal to the clause opened with begin_clause()
+     * @param literal Non-zero literal
+     */
+    void add_literal(int literal) override {
+        if (has_wide_literals) {
+            wide_literals.push_back(literal);
+        } else if (is_short_literal(literal)) {
+            short_literals.push_back(static_cast<int16_t>(literal));
+        } else {
+            widen_literals();
+            wide_literals.push_back(literal);
+        }
+    }
+
+    /**
+     * @brief Closes the clause opened with begin_clause()
+     */
+    void end_clause() override { push_offset(get_num_literals()); }
+
+    /**
+     * @brief Reserves arena capacity for the expected formula size
+     *
+     * @param num_clauses Expected number of clauses
+     * @param num_literals Expected total number of literals
+     */
+    void reserve(size_t num_clauses, size_t num_literals);
+
+    /**
+     * @brief Sets the memory limit of the clause arena
+     *
+     * Each of the two arena buffers (literals and clause offsets) that grows
+     * beyond the limit is moved to a memory-mapped temporary file and keeps
+     * growing there. Clause access is unchanged; the kernel pages the file
+     * in and out as needed, e.g. while DimacsWriter streams it back.
+     *
+     * @param bytes Maximum heap size of each buffer in bytes (0 = never spill, the default)
+     */
+    void set_spill_threshold(size_t bytes);
+
+    /**
+     * @brief Checks whether part of the clause arena lives in a temporary file
+     * @return true if the literals or the offsets have spilled
+     */
+    bool is_spilled() const {
+        return short_literals.is_spilled() || wide_literals.is_spilled() ||
+               short_offsets.is_spilled() || wide_offsets.is_spilled();
+    }
+
+    /**
+     * @brief Checks whether the literals are stored as int rather than int16_t
+     * @return true once a literal outside the 16-bit range was added
+     */
+    bool has_wide_literal_storage() const { return has_wide_literals; }
+
+    /**
+     * @brief Replaces the clause arena with the given buffers
+     *
+     * Used by clause-level passes (e.g., ClauseNormalizer) that rebuild the
+     * clause set: the pass reads the current clauses, builds the new arena
+     * as int / size_t vectors and hands it over. The buffers must form a valid
+     * arena, i.e. new_offsets starts with 0 and ends with new_literals.size().
+     * They are narrowed if their values fit, and taken over without copying
+     * otherwise. The variable table is not touched.
+     *
+     * The replacement is built on the heap, so passes using it hold a full
+     * copy of the formula in memory regardless of the spill threshold.
+     *
+     * @param new_literals Literals of the new clauses (left empty)
+     * @param new_offsets Offsets of the new clauses (left empty)
+     * @throws std::invalid_argument if the buffers do not form a valid arena
+     */
+    void replace_clauses(std::vector<int>&& new_literals, std::vector<size_t>&& new_offsets);
+
+    /**
+     * @brief Renumbers, merges or drops variables
+     *
+     * literal_map[v] gives, for every current variable v, the literal of the
+     * new numbering it becomes (0 drops the variable). Several variables may
+     * map to the same new variable, possibly with opposite signs, when they
+     * are known to be equivalent. The new variables must be 1..K without
+     * gaps, and each of them must be the positive image of at least one old
+     * variable; the first such old variable (in old order) keeps its name and
+     * kind, the others are recorded as aliases of the literal they map to.
+     *
+     * All clause literals are rewritten. Merging can leave clauses with
+     * repeated literals or tautologies, which the caller is expected to clean
+     * (e.g., with ClauseNormalizer). Existing aliases are remapped as well.
+     *
+     * @param literal_map Map of size get_num_variables() + 1 (entry 0 unused)
+     * @throws std::invalid_argument if the map is malformed or drops a variable used in a clause
+     */
+    void remap_variables(const std::vector<int>& literal_map);
+
+    /**
+     * @brief Gets the number of variables merged away by remap_variables()
+     * @return Number of aliases
+     */
+    size_t get_num_aliases() const { return aliases.size(); }
+
+    /**
+     * @brief Gets the literal an alias is equal to
+     * @param i Alias index in [0, get_num_aliases())
+     * @return Literal of a current variable
+     */
+    int get_alias_literal(size_t i) const { return aliases[i].literal; }
+
+    /**
+     * @brief Checks whether an alias was an auxiliary variable
+     * @param i Alias index in [0, get_num_aliases())
+     * @return true for merged auxiliary variables, false for merged features
+     */
+    bool is_auxiliary_alias(size_t i) const { return aliases[i].entry.is_auxiliary; }
+
+    /**
+     * @brief Writes the name of an alias to a stream
+     *
+     * @param out Output stream
+     * @param i Alias index in [0, get_num_aliases())
+     */
+    void write_alias_name(std::ostream& out, size_t i) const { write_entry_name(out, aliases[i].entry); }
 
     /**
      * @brief Gets the feature name to variable ID mapping
      * @return Constant reference to the variables map
      */
-    const std::map<std::string, int>& get_variables() const { return variables; }
+    const std::unordered_map<std::string, int>& get_variables() const { return variables; }
+
+    /**
+     * @brief Checks whether a variable is auxiliary
+     * @param var Variable ID in [1, get_num_variables()]
+     * @return true if the variable was created by create_auxiliary_variable()
+     */
+    bool is_auxiliary(int var) const { return entries[var].is_auxiliary; }
+
+    /**
+     * @brief Gets the purpose tag of an auxiliary variable
+     * @param var Auxiliary variable ID in [1, get_num_variables()]
+     * @return Kind given to create_auxiliary_variable()
+     */
+    AuxKind get_aux_kind(int var) const { return entries[var].aux_kind; }
 
     /**
-     * @brief Gets the variable ID to feature name mapping
-     * @return Constant reference to the features map
+     * @brief Gets the name of a feature variable
+     * @param var Variable ID of a feature (not auxiliary)
+     * @return The feature name
+     */
+    const std::string& get_feature_name(int var) const { return feature_names[entries[var].index]; }
+
+    /**
+     * @brief Gets the name of any variable
+     *
+     * Returns the feature name for feature variables and materializes the
+     * "aux_N" / "aux_N_kind" name for auxiliary variables.
+     *
+     * @param var Variable ID in [1, get_num_variables()]
+     * @return The variable name
+     */
+    std::string get_variable_name(int var) const;
+
+    /**
+     * @brief Writes the name of any variable to a stream without building a string
+     *
+     * @param out Output stream
+     * @param var Variable ID in [1, get_num_variables()]
      */
-    const std::map<int, std::string>& get_features() const { return features; }
+    void write_variable_name(std::ostream& out, int var) const;
 
     /**
-     * @brief Gets the auxiliary variable descriptions
-     * @return Constant reference to the auxiliary variables map
+     * @brief Gets the number of feature variables
+     * @return Number of variables created with add_feature()
      */
-    const std::map<int, std::string>& get_auxiliary_variables() const { return auxiliary_variables; }
+    int get_num_features() const { return static_cast<int>(feature_names.size()); }
 
     /**
-     * @brief Gets all CNF clauses
-     * @return Constant reference to the clauses vector
+     * @brief Gets the number of auxiliary variables
+     * @return Number of variables created with create_auxiliary_variable()
      */
-    const std::vector<std::vector<int>>& get_clauses() const { return clauses; }
+    int get_num_auxiliary_variables() const { return num_auxiliary; }
+
+    /**
+     * @brief Gets a view of the i-th clause
+     * @param i Clause index in [0, get_num_clauses())
+     * @return View over the literals of the clause
+     */
+    ClauseView get_clause(size_t i) const {
+        size_t first = get_offset(i);
+        size_t last = get_offset(i + 1);
+        if (has_wide_literals) {
+            return ClauseView(wide_literals.data() + first, wide_literals.data() + last);
+        }
+        return ClauseView(short_literals.data() + first, short_literals.data() + last);
+    }
+
+    /**
+     * @brief Runs a visitor on the clause arena with its current storage widths
+     *
+     * The visitor is called once with a ClauseSpan<Literal, Offset> matching
+     * the stored types, so a generic lambda is compiled for each width
+     * combination and its loops read the arena directly.
+     *
+     * Example:
+     * @code
+     * cnf.visit_arena([&out](const auto& arena) {
+     *     for (size_t i = 0; i < arena.offsets[arena.num_clauses]; ++i) {
+     *         out << static_cast<int>(arena.literals[i]) << " ";
+     *     }
+     * });
+     * @endcode
+     *
+     * @param visitor Callable accepting any ClauseSpan
+     */
+    template <typename Visitor>
+    void visit_arena(Visitor&& visitor) const {
+        size_t num_clauses = static_cast<size_t>(get_num_clauses());
+        if (has_wide_literals) {
+            visit_offsets(wide_literals.data(), num_clauses, visitor);
+        } else {
+            visit_offsets(short_literals.data(), num_clauses, visitor);
+        }
+    }
+
+    /**
+     * @brief Gets the total number of literals over all clauses
+     * @return Size of the literal arena
+     */
+    size_t get_num_literals() const { return has_wide_literals ? wide_literals.size() : short_literals.size(); }
 
     /**
      * @brief Gets the total number of variables
@@ -161,13 +554,72 @@ public:
      * @brief Gets the total number of clauses
      * @return Number of clauses in the CNF formula
      */
-    int get_num_clauses() const { return clauses.size(); }
+    int get_num_clauses() const {
+        return static_cast<int>((has_wide_offsets ? wide_offsets.size() : short_offsets.size()) - 1);
+    }
 
     /**
      * @brief Creates a string representation of the CNF model
      * @return String representation for debugging
      */
     std::string to_string() const;
+
+private:
+    /**
+     * @brief Checks whether a literal can be stored as int16_t
+     */
+    static bool is_short_literal(int literal) {
+        return literal >= -std::numeric_limits<int16_t>::max() && literal <= std::numeric_limits<int16_t>::max();
+    }
+
+    /**
+     * @brief Gets the start of a clause (or the end sentinel)
+     */
+    size_t get_offset(size_t i) const { return has_wide_offsets ? wide_offsets[i] : short_offsets[i]; }
+
+    /**
+     * @brief Appends a clause boundary, widening the offsets if needed
+     */
+    void push_offset(size_t offset) {
+        if (has_wide_offsets) {
+            wide_offsets.push_back(offset);
+        } else if (offset <= std::numeric_limits<uint32_t>::max()) {
+            short_offsets.push_back(static_cast<uint32_t>(offset));
+        } else {
+            widen_offsets();
+            wide_offsets.push_back(offset);
+        }
+    }
+
+    /**
+     * @brief Moves the literals from int16_t to int storage
+     */
+    void widen_literals();
+
+    /**
+     * @brief Moves the offsets from uint32_t to size_t storage
+     */
+    void widen_offsets();
+
+    /**
+     * @brief Second step of visit_arena(): dispatches on the offset width
+     */
+    template <typename Literal, typename Visitor>
+    void visit_offsets(const Literal* literals, size_t num_clauses, Visitor& visitor) const {
+        if (has_wide_offsets) {
+            visitor(ClauseSpan<Literal, size_t>{literals, wide_offsets.data(), num_clauses});
+        } else {
+            visitor(ClauseSpan<Literal, uint32_t>{literals, short_offsets.data(), num_clauses});
+        }
+    }
+
+    /**
+     * @brief Writes the name described by a variable entry
+     *
+     * @param out Output stream
+     * @param entry Variable entry (feature or auxiliary)
+     */
+    void write_entry_name(std::ostream& out, const VariableEntry& entry) const;
 };
 
 #endif // CNFMODEL_H
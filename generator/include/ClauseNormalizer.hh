@@ -0,0 +1,182 @@
+/**
+ * @file ClauseNormalizer.hh
+ * @brief Clause-level cleanup of a CNF model before output
+ *
+ * This file defines the ClauseNormalizer class, which removes redundancy that
+ * the encoders introduce: repeated literals, tautologies, duplicate clauses
+ * and clauses subsumed by shorter ones.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef CLAUSENORMALIZER_H
+#define CLAUSENORMALIZER_H
+
+#include "CNFModel.hh"
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class ClauseNormalizer
+ * @brief Normalizes the clause set of a CNFModel in place
+ *
+ * The encoders can emit the same clause more than once (e.g., child => parent
+ * from an OPTIONAL group and again from an OR group, or repeated cross-tree
+ * constraints), and distribute_or() can produce clauses with repeated literals
+ * or with both polarities of a variable. normalize() removes all of these:
+ *
+ * 1. **Literal normalization**: literals of every clause are sorted by variable
+ *    (negative before positive) and repeated literals are dropped
+ * 2. **Tautologies**: clauses containing both x and -x are removed
+ * 3. **Duplicates**: exact duplicate clauses are detected by hashing and removed
+ * 4. **Forward subsumption**: a clause is removed when a (shorter) kept clause
+ *    is a subset of it. Each kept clause is indexed under its least frequent
+ *    literal, so a candidate clause only has to be compared against the clauses
+ *    indexed under its own literals. The total number of subset checks is
+ *    bounded by a budget; when it runs out, the remaining clauses are kept.
+ *
+ * All steps preserve the set of satisfying assignments, so the number of
+ * solutions is unchanged. The variable table is not modified, and the
+ * surviving clauses keep their relative order.
+ *
+ * @see CNFModel::replace_clauses() for how the rebuilt arena is installed
+ *
+ * Example:
+ * @code
+ * CNFModel cnf = transformer.transform(CNFMode::TSEITIN);
+ * ClauseNormalizer normalizer;
+ * normalizer.normalize(cnf);
+ * std::cout << normalizer.get_subsumed_clauses() << " subsumed clauses removed\n";
+ * @endcode
+ */
+class ClauseNormalizer {
+public:
+    /// Default bound on subset checks performed by forward subsumption
+    static constexpr uint64_t DEFAULT_SUBSUMPTION_BUDGET = 50000000;
+
+private:
+    bool use_subsumption;          ///< Whether forward subsumption is performed
+    uint64_t subsumption_budget;   ///< Maximum number of subset checks
+
+    size_t removed_literals;       ///< Repeated literals dropped from clauses
+    size_t tautologies;            ///< Tautological clauses removed
+    size_t duplicate_clauses;      ///< Exact duplicate clauses removed
+    size_t subsumed_clauses;       ///< Subsumed clauses removed
+    bool budget_exhausted;         ///< Whether subsumption stopped early
+
+public:
+    /**
+     * @brief Constructs a normalizer with subsumption enabled and the default budget
+     */
+    ClauseNormalizer();
+
+    /**
+     * @brief Enables or disables forward subsumption
+     * @param enabled false to only normalize literals and remove tautologies/duplicates
+     */
+    void set_subsumption(bool enabled) { use_subsumption = enabled; }
+
+    /**
+     * @brief Sets the maximum number of subset checks for forward subsumption
+     * @param budget Number of clause-pair comparisons allowed (0 disables subsumption)
+     */
+    void set_subsumption_budget(uint64_t budget) { subsumption_budget = budget; }
+
+    /**
+     * @brief Normalizes the clauses of a CNF model
+     *
+     * Statistics of the previous call are reset.
+     *
+     * @param model CNF model whose clause set is rewritten in place
+     */
+    void normalize(CNFModel& model);
+
+    /**
+     * @brief Rewrites the clauses of a CNF model in a canonical order
+     *
+     * Literals of every clause are sorted by variable (negative before
+     * positive) and clauses are sorted lexicographically by their literals,
+     * a clause before any longer clause it is a prefix of. No clause or
+     * literal is removed, so the result depends only on the clause set and
+     * the variable numbering, not on the order the encoders emitted it in.
+     * This makes DIMACS files of similar models compress and diff well.
+     *
+     * @param model CNF model whose clause set is reordered in place
+     */
+    static void sort_canonically(CNFModel& model);
+
+    /**
+     * @brief Gets the number of repeated literals dropped from clauses
+     * @return Number of removed literals (tautologies not included)
+     */
+    size_t get_removed_literals() const { return removed_literals; }
+
+    /**
+     * @brief Gets the number of tautological clauses removed
+     * @return Number of tautologies
+     */
+    size_t get_tautologies() const { return tautologies; }
+
+    /**
+     * @brief Gets the number of duplicate clauses removed
+     * @return Number of duplicates
+     */
+    size_t get_duplicate_clauses() const { return duplicate_clauses; }
+
+    /**
+     * @brief Gets the number of subsumed clauses removed
+     * @return Number of subsumed clauses
+     */
+    size_t get_subsumed_clauses() const { return subsumed_clauses; }
+
+    /**
+     * @brief Gets the total number of clauses removed
+     * @return Tautologies + duplicates + subsumed clauses
+     */
+    size_t get_removed_clauses() const { return tautologies + duplicate_clauses + subsumed_clauses; }
+
+    /**
+     * @brief Checks whether forward subsumption ran out of budget
+     * @return true if some clauses were not checked for subsumption
+     */
+    bool is_budget_exhausted() const { return budget_exhausted; }
+
+private:
+    /**
+     * @brief Sorts, deduplicates and tautology-checks every clause
+     *
+     * @param model Source model
+     * @param out_literals Literal buffer receiving the surviving clauses
+     * @param out_offsets Offset buffer receiving the surviving clauses
+     */
+    void normalize_literals(const CNFModel& model,
+                            std::vector<int>& out_literals,
+                            std::vector<size_t>& out_offsets);
+
+    /**
+     * @brief Marks exact duplicate clauses
+     *
+     * @param literals Normalized literal arena
+     * @param offsets Normalized offset arena
+     * @param removed Per-clause removal flags (updated)
+     */
+    void mark_duplicates(const std::vector<int>& literals,
+                         const std::vector<size_t>& offsets,
+                         std::vector<char>& removed);
+
+    /**
+     * @brief Marks clauses subsumed by other kept clauses
+     *
+     * @param literals Normalized literal arena
+     * @param offsets Normalized offset arena
+     * @param num_variables Number of variables of the model
+     * @param removed Per-clause removal flags (updated)
+     */
+    void mark_subsumed(const std::vector<int>& literals,
+                       const std::vector<size_t>& offsets,
+                       int num_variables,
+                       std::vector<char>& removed);
+};
+
+#endif // CLAUSENORMALIZER_H
@@ -0,0 +1,256 @@
+/**
+ * @file ClauseSink.hh
+ * @brief Destination interface for generated CNF clauses
+ *
+ * This file defines the ClauseSink interface that the encoders (RelationEncoder,
+ * ASTNode, FMToCNF) write clauses into, together with a counting-only
+ * implementation. CNFModel (in-memory storage) and DimacsStreamWriter (direct
+ * file output) are the other implementations.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef CLAUSESINK_H
+#define CLAUSESINK_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+class CNFModel;
+
+/**
+ * @class ClauseSink
+ * @brief Receives clauses one at a time as they are generated
+ *
+ * Encoders never need the clauses they produced, only the variable table, so
+ * they emit each clause to a sink as soon as it is built. Depending on the
+ * sink, clauses are stored (CNFModel), written to disk immediately
+ * (DimacsStreamWriter) or only counted (ClauseCounter). Streaming sinks keep
+ * peak memory independent of the number of clauses.
+ *
+ * A clause is either passed whole with add_clause() or written literal by
+ * literal between begin_clause() and end_clause().
+ *
+ * Sinks for formats with cardinality constraints (OpbStreamWriter,
+ * KnfStreamWriter) report has_native_cardinality(), and RelationEncoder then
+ * emits the count bounds of groups with add_at_least() instead of lowering
+ * them to clauses. Sinks that also take weighted literals (OpbStreamWriter)
+ * report has_weighted_cardinality() and receive the lower bound of a group
+ * as one add_guarded_at_least() constraint.
+ *
+ * FMToCNF calls begin_formula() once all feature variables exist and
+ * end_formula() after the last clause, so sinks that write headers can do so.
+ *
+ * @see CNFModel for the in-memory sink
+ * @see DimacsStreamWriter for the streaming DIMACS sink
+ * @see ClauseCounter for the counting-only sink
+ *
+ * Example:
+ * @code
+ * ClauseCounter counter;
+ * FMToCNF transformer(feature_model);
+ * transformer.transform(counter, CNFMode::TSEITIN);
+ * std::cout << counter.get_num_clauses() << " clauses\n";
+ * @endcode
+ */
+class ClauseSink {
+public:
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~ClauseSink() = default;
+
+    /**
+     * @brief Starts a new clause to be filled with add_literal()
+     */
+    virtual void begin_clause() = 0;
+
+    /**
+     * @brief Appends a literal to the clause opened with begin_clause()
+     * @param literal Non-zero literal
+     */
+    virtual void add_literal(int literal) = 0;
+
+    /**
+     * @brief Closes the clause opened with begin_clause()
+     */
+    virtual void end_clause() = 0;
+
+    /**
+     * @brief Adds a complete clause given as a literal range
+     *
+     * The default implementation forwards to begin_clause() / add_literal() /
+     * end_clause(); sinks override it when they can copy the range at once.
+     *
+     * @param first Pointer to the first literal
+     * @param last Pointer one past the last literal
+     */
+    virtual void add_clause(const int* first, const int* last);
+
+    /**
+     * @brief Adds a complete clause given as a vector
+     * @param clause Literals of the clause
+     */
+    void add_clause(const std::vector<int>& clause) {
+        add_clause(clause.data(), clause.data() + clause.size());
+    }
+
+    /**
+     * @brief Adds a complete clause given as a brace-enclosed list
+     * @param clause Literals of the clause
+     */
+    void add_clause(std::initializer_list<int> clause) {
+        add_clause(clause.begin(), clause.end());
+    }
+
+    /**
+     * @brief Checks whether the sink keeps cardinality constraints native
+     * @return true if add_at_least() may be called
+     */
+    virtual bool has_native_cardinality() const { return false; }
+
+    /**
+     * @brief Adds "at least bound of the literals are true" as one constraint
+     *
+     * Only called on sinks whose has_native_cardinality() is true; the
+     * default implementation throws std::logic_error.
+     *
+     * @param bound Smallest number of true literals (at least 1)
+     * @param first Pointer to the first literal
+     * @param last Pointer one past the last literal
+     */
+    virtual void add_at_least(int bound, const int* first, const int* last);
+
+    /**
+     * @brief Adds an at-least constraint given as a vector
+     * @param bound Smallest number of true literals
+     * @param literals Literals of the constraint
+     */
+    void add_at_least(int bound, const std::vector<int>& literals) {
+        add_at_least(bound, literals.data(), literals.data() + literals.size());
+    }
+
+    /**
+     * @brief Checks whether the sink takes guarded at-least constraints
+     * @return true if add_guarded_at_least() may be called
+     */
+    virtual bool has_weighted_cardinality() const { return false; }
+
+    /**
+     * @brief Adds "guard → at least bound of the literals are true" as one constraint
+     *
+     * Only called on sinks whose has_weighted_cardinality() is true; the
+     * default implementation throws std::logic_error. Sinks without
+     * weights need bound - 1 auxiliary copies of the guard instead (see
+     * RelationEncoder::encode_native_cardinality()).
+     *
+     * @param guard Literal that enables the constraint
+     * @param bound Smallest number of true literals if guard is true (at least 1)
+     * @param first Pointer to the first literal
+     * @param last Pointer one past the last literal
+     */
+    virtual void add_guarded_at_least(int guard, int bound, const int* first, const int* last);
+
+    /**
+     * @brief Adds a guarded at-least constraint given as a vector
+     * @param guard Literal that enables the constraint
+     * @param bound Smallest number of true literals if guard is true
+     * @param literals Literals of the constraint
+     */
+    void add_guarded_at_least(int guard, int bound, const std::vector<int>& literals) {
+        add_guarded_at_least(guard, bound, literals.data(), literals.data() + literals.size());
+    }
+
+    /**
+     * @brief Called once all feature variables have been created
+     *
+     * @param variables Variable table (features known, no auxiliaries yet)
+     */
+    virtual void begin_formula(const CNFModel& variables) { (void)variables; }
+
+    /**
+     * @brief Called after the last clause has been emitted
+     *
+     * @param variables Final variable table (including auxiliary variables)
+     */
+    virtual void end_formula(const CNFModel& variables) { (void)variables; }
+};
+
+/**
+ * @class ClauseCounter
+ * @brief Sink that only counts clauses and literals
+ *
+ * Useful to measure the size of an encoding without storing or writing it.
+ */
+class ClauseCounter : public ClauseSink {
+private:
+    uint64_t num_clauses;       ///< Number of completed clauses
+    uint64_t num_literals;      ///< Total number of literals
+    size_t max_clause_size;     ///< Length of the longest clause
+    size_t current_size;        ///< Length of the clause being written
+
+public:
+    /**
+     * @brief Constructs a counter with all counts at zero
+     */
+    ClauseCounter();
+
+    void begin_clause() override { current_size = 0; }
+    void add_literal(int literal) override { (void)literal; current_size++; }
+    void end_clause() override;
+    void add_clause(const int* first, const int* last) override;
+    using ClauseSink::add_clause;
+
+    /**
+     * @brief Gets the number of clauses seen
+     * @return Number of clauses
+     */
+    uint64_t get_num_clauses() const { return num_clauses; }
+
+    /**
+     * @brief Gets the total number of literals seen
+     * @return Sum of all clause lengths
+     */
+    uint64_t get_num_literals() const { return num_literals; }
+
+    /**
+     * @brief Gets the length of the longest clause seen
+     * @return Maximum clause length
+     */
+    size_t get_max_clause_size() const { return max_clause_size; }
+};
+
+/**
+ * @class ClauseBuffer
+ * @brief Sink that keeps clauses in one flat buffer to be replayed later
+ *
+ * As in DIMACS, each clause is stored as its literals followed by a 0, so
+ * a buffer can be filled on one thread and handed to another in one move.
+ */
+class ClauseBuffer : public ClauseSink {
+private:
+    std::vector<int> literals;  ///< Literals of all clauses, each clause terminated by 0
+
+public:
+    void begin_clause() override {}
+    void add_literal(int literal) override { literals.push_back(literal); }
+    void end_clause() override { literals.push_back(0); }
+    void add_clause(const int* first, const int* last) override;
+    using ClauseSink::add_clause;
+
+    /**
+     * @brief Gets the stored clauses
+     * @return Literals of all clauses, each clause terminated by 0
+     */
+    const std::vector<int>& get_literals() const { return literals; }
+
+    /**
+     * @brief Forgets all clauses and releases the buffer
+     */
+    void clear() { std::vector<int>().swap(literals); }
+};
+
+#endif // CLAUSESINK_H
@@ -0,0 +1,168 @@
+/**
+ * @file ComponentDecomposer.hh
+ * @brief Decomposition of a CNF model into independent components
+ *
+ * This file defines the ComponentDecomposer class, which splits a formula
+ * into sub-formulas over disjoint variable sets and writes them as separate
+ * DIMACS files plus a manifest.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef COMPONENTDECOMPOSER_H
+#define COMPONENTDECOMPOSER_H
+
+#include "CNFModel.hh"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @class ComponentDecomposer
+ * @brief Splits a CNF model into components that share no variables
+ *
+ * Feature models assembled from loosely coupled subsystems only meet at the
+ * root, so once the root (and everything it forces) is fixed, the formula
+ * falls apart into independent parts. The decomposer:
+ *
+ * 1. Unit-propagates the unit clauses of the formula; the fixed variables
+ *    form a "fixed" component made of unit clauses
+ * 2. Simplifies the other clauses (satisfied clauses are dropped, false
+ *    literals removed)
+ * 3. Joins the variables of every remaining clause with union-find; each
+ *    set is a "connected" component
+ * 4. Collects the variables that occur in no remaining clause into one
+ *    "free" component without clauses
+ *
+ * Every component is renumbered to 1..n, keeping the relative order of the
+ * variables, and keeps the feature-name comments of its variables. The
+ * components together have exactly the solutions of the original formula,
+ * so the model count of the formula is the product of the components' model
+ * counts (1 for the fixed component, 2^n for the free one).
+ *
+ * If propagation finds a conflict, the formula is unsatisfiable and it is
+ * kept as a single "unsatisfiable" component.
+ *
+ * Example:
+ * @code
+ * ComponentDecomposer decomposer(cnf);
+ * decomposer.decompose();
+ * decomposer.write_files("model.manifest");   // model_1.dimacs, model_2.dimacs, ...
+ * @endcode
+ */
+class ComponentDecomposer {
+public:
+    /**
+     * @struct Component
+     * @brief One independent sub-formula in local numbering
+     */
+    struct Component {
+        std::string kind;                  ///< "fixed", "connected", "free" or "unsatisfiable"
+        std::vector<int> variables;        ///< Original variable IDs; local ID = position + 1
+        std::vector<int> literals;         ///< Clause literals in local numbering
+        std::vector<size_t> offsets;       ///< Clause offsets into literals, plus end sentinel
+
+        size_t get_num_clauses() const { return offsets.size() - 1; }
+    };
+
+private:
+    const CNFModel& cnf_model;             ///< Model being decomposed
+    std::vector<Component> components;     ///< Components in output order
+    std::vector<int> component_of;         ///< Variable ID to component index
+    std::vector<int> local_id;             ///< Variable ID to local ID in its component
+    size_t num_fixed;                      ///< Variables fixed by unit propagation
+    size_t num_free;                       ///< Unfixed variables occurring in no clause
+    bool unsatisfiable;                    ///< Whether propagation found a conflict
+
+public:
+    /**
+     * @brief Constructs a decomposer for the given CNF model
+     *
+     * @param model CNF model to decompose (must outlive the decomposer)
+     */
+    explicit ComponentDecomposer(const CNFModel& model);
+
+    /**
+     * @brief Computes the components of the model
+     *
+     * Results of a previous call are discarded.
+     */
+    void decompose();
+
+    /**
+     * @brief Gets the number of components
+     * @return Number of components, including the fixed and free ones
+     */
+    size_t get_num_components() const { return components.size(); }
+
+    /**
+     * @brief Gets a component
+     * @param k Component index
+     * @return The component
+     */
+    const Component& get_component(size_t k) const { return components[k]; }
+
+    /**
+     * @brief Gets the number of variables fixed by unit propagation
+     * @return Size of the fixed component
+     */
+    size_t get_num_fixed_variables() const { return num_fixed; }
+
+    /**
+     * @brief Gets the number of unconstrained variables
+     * @return Size of the free component
+     */
+    size_t get_num_free_variables() const { return num_free; }
+
+    /**
+     * @brief Checks whether unit propagation found the formula unsatisfiable
+     * @return true if the formula was kept as a single component
+     */
+    bool is_unsatisfiable() const { return unsatisfiable; }
+
+    /**
+     * @brief Writes one component in DIMACS format
+     *
+     * Uses the layout of DimacsWriter: header comments, problem line, feature,
+     * auxiliary and equivalent-feature comments in local numbering, clauses.
+     *
+     * @param k Component index
+     * @param out Output stream
+     */
+    void write_component(size_t k, std::ostream& out) const;
+
+    /**
+     * @brief Writes every component to its own file and a manifest
+     *
+     * Component k (1-based) is written to "<stem>_<k>.dimacs", where stem is
+     * manifest_path without its extension. The manifest lists one line per
+     * component: "component <k> <file> <variables> <clauses> <kind>".
+     *
+     * @param manifest_path Path of the manifest file
+     * @throws std::runtime_error if a file cannot be opened for writing
+     */
+    void write_files(const std::string& manifest_path) const;
+
+private:
+    /**
+     * @brief Unit-propagates the unit clauses of the model
+     *
+     * @param values Receives per variable 1 (true), -1 (false) or 0 (unknown)
+     * @return false if a conflict was found
+     */
+    bool propagate(std::vector<int8_t>& values) const;
+
+    /**
+     * @brief Creates a component and assigns local IDs to its variables
+     *
+     * @param kind Component kind
+     * @param variables Original variable IDs in ascending order
+     * @return Index of the new component
+     */
+    size_t add_component(const std::string& kind, const std::vector<int>& variables);
+};
+
+#endif // COMPONENTDECOMPOSER_H
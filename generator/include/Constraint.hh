@@ -112,6 +112,25 @@ public:
         CNFMode mode
     ) const;
 
+    /**
+     * @brief Converts this constraint to CNF clauses emitted to a sink
+     *
+     * @param sink Destination of the generated clauses
+     * @param get_variable Function to map feature names to variable IDs
+     * @param create_aux_var Function to create new auxiliary variables (for Tseitin mode)
+     * @param mode Conversion mode (TSEITIN or STRAIGHTFORWARD)
+     * @param gates Gates shared with the rest of the conversion (Tseitin mode, optional)
+     *
+     * @see ASTNode::get_clauses(ClauseSink&, ...) for the streaming conversion
+     */
+    void get_clauses(
+        ClauseSink& sink,
+        std::function<int(const std::string&)> get_variable,
+        std::function<int()> create_aux_var,
+        CNFMode mode,
+        GateCache* gates = nullptr
+    ) const;
+
     /**
      * @brief Checks if this constraint contains only boolean operations
      *
@@ -0,0 +1,115 @@
+/**
+ * @file DimacsStreamWriter.hh
+ * @brief Clause sink that writes DIMACS directly to a file
+ *
+ * This file defines the DimacsStreamWriter class, a ClauseSink that writes each
+ * clause to the output file as soon as it is generated, so arbitrarily large
+ * formulas are emitted in constant memory.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef DIMACSSTREAMWRITER_H
+#define DIMACSSTREAMWRITER_H
+
+#include "ClauseSink.hh"
+#include "CNFModel.hh"
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+/**
+ * @class DimacsStreamWriter
+ * @brief Streams clauses to a DIMACS file and patches the header at the end
+ *
+ * The number of variables and clauses is only known once the transformation
+ * has finished, so begin_formula() writes the header with fixed-width,
+ * space-padded placeholders and end_formula() seeks back and fills them in.
+ * The output therefore requires a seekable file (not a pipe).
+ *
+ * **Output layout**:
+ * - Header comments and `p cnf <variables> <clauses>` (counts padded with spaces)
+ * - Comment lines for feature variables: `c <var_id> <feature_name>`
+ * - Clauses, one per line, written as they are generated
+ * - Comment lines for auxiliary variables, written after the clauses since
+ *   auxiliaries are created during encoding
+ *
+ * Apart from the padding and the position of the auxiliary comments, the file
+ * has the same content as DimacsWriter output for the same model.
+ *
+ * @see DimacsWriter for the in-memory writer
+ * @see FMToCNF::transform(ClauseSink&, CNFMode) for producing the clauses
+ *
+ * Example:
+ * @code
+ * DimacsStreamWriter writer("model.dimacs");
+ * FMToCNF transformer(feature_model);
+ * transformer.transform(writer, CNFMode::TSEITIN);
+ * @endcode
+ */
+class DimacsStreamWriter : public ClauseSink {
+private:
+    std::string filepath;                   ///< Output file path (for error messages)
+    const char* problem_type;               ///< Format name of the problem line ("cnf")
+    std::ofstream::pos_type aux_count_pos;  ///< Position of the auxiliary count placeholder
+    std::ofstream::pos_type total_pos;      ///< Position of the total variables placeholder
+    std::ofstream::pos_type problem_pos;    ///< Position of the "p cnf" counts placeholder
+    bool header_written;                    ///< Whether begin_formula() has run
+
+protected:
+    std::ofstream out;                      ///< Output file
+    uint64_t num_clauses;                   ///< Lines counted in the problem line so far
+
+    /**
+     * @brief Opens the output file of a DIMACS dialect
+     *
+     * @param path Path to the output file (created or overwritten)
+     * @param type Format name written in the problem line (e.g. "knf")
+     * @throws std::runtime_error if the file cannot be opened for writing
+     */
+    DimacsStreamWriter(const std::string& path, const char* type);
+
+public:
+    /**
+     * @brief Opens the output file
+     *
+     * @param path Path to the output file (created or overwritten)
+     * @throws std::runtime_error if the file cannot be opened for writing
+     */
+    explicit DimacsStreamWriter(const std::string& path);
+
+    /**
+     * @brief Destructor
+     */
+    ~DimacsStreamWriter() override = default;
+
+    void begin_clause() override {}
+    void add_literal(int literal) override { out << literal << ' '; }
+    void end_clause() override;
+    void add_clause(const int* first, const int* last) override;
+    using ClauseSink::add_clause;
+
+    /**
+     * @brief Writes the header placeholders and the feature comment lines
+     *
+     * @param variables Variable table with all feature variables
+     */
+    void begin_formula(const CNFModel& variables) override;
+
+    /**
+     * @brief Writes auxiliary comment lines and patches the header counts
+     *
+     * @param variables Final variable table
+     * @throws std::runtime_error if the file could not be written
+     */
+    void end_formula(const CNFModel& variables) override;
+
+    /**
+     * @brief Gets the number of clauses written
+     * @return Number of clauses
+     */
+    uint64_t get_num_clauses() const { return num_clauses; }
+};
+
+#endif // DIMACSSTREAMWRITER_H
@@ -31,6 +31,8 @@
  * - Start with 'c' character
  * - Used for variable mappings and auxiliary variable descriptions
  * - Example: `c 1 GPS`, `c 2 Display`
+ * - Features merged into another variable are listed with the literal they
+ *   are equal to, e.g. `c -2 Manual (equivalent)`
  *
  * **Clause Lines**:
  * - Each clause on a separate line
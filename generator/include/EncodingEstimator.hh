@@ -0,0 +1,251 @@
+/**
+ * @file EncodingEstimator.hh
+ * @brief Dry-run size prediction of the CNF encoding of a feature model
+ *
+ * This file defines the EncodingEstimator class, which computes how many
+ * variables, clauses and literals FMToCNF would generate for each relation
+ * and constraint without generating any clause.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef ENCODINGESTIMATOR_H
+#define ENCODINGESTIMATOR_H
+
+#include "FeatureModel.hh"
+#include "CNFMode.hh"
+#include "ASTNode.hh"
+#include "Constraint.hh"
+#include "Relation.hh"
+#include "RelationEncoder.hh"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @struct EncodingCost
+ * @brief Size of (part of) a CNF encoding
+ *
+ * Counts saturate at UINT64_MAX (see EncodingEstimator::UNBOUNDED) instead of
+ * overflowing.
+ */
+struct EncodingCost {
+    uint64_t variables = 0;  ///< Variables created (features or auxiliary variables)
+    uint64_t clauses = 0;    ///< Clauses emitted
+    uint64_t literals = 0;   ///< Literals over all emitted clauses
+
+    /**
+     * @brief Adds another cost to this one (saturating)
+     * @param other Cost to add
+     * @return Reference to this cost
+     */
+    EncodingCost& operator+=(const EncodingCost& other);
+};
+
+/**
+ * @struct EncodingCostItem
+ * @brief Predicted cost of one relation or constraint
+ */
+struct EncodingCostItem {
+    /**
+     * @enum Kind
+     * @brief Source of the clauses
+     */
+    enum class Kind {
+        RELATION,    ///< Parent-child relation of the feature tree
+        CONSTRAINT   ///< Cross-tree constraint
+    };
+
+    Kind kind;           ///< Relation or constraint
+    std::string name;    ///< "<type> <parent>" (plus " -> <child>" for single-child relations) or the constraint name
+    EncodingCost cost;   ///< Predicted size of its clauses
+};
+
+/**
+ * @class EncodingEstimator
+ * @brief Predicts the size of the CNF encoding for a conversion mode
+ *
+ * The estimator mirrors the encodings of RelationEncoder and ASTNode in
+ * closed form:
+ *
+ * - **Relations**: group sizes give the clause counts directly (pairwise
+ *   at-most-one, OR trees with n - 1 auxiliary variables, and the 2^n
+ *   combination clauses of cardinality groups). Linear at-most-one and
+ *   cardinality counter encodings are counted by running them into a
+ *   ClauseCounter, which is polynomial in the group size.
+ * - **Straightforward constraints**: for each AST node, the number of
+ *   clauses and literals of its positive and negative NNF are computed
+ *   bottom-up (AND adds, OR multiplies as distribute_or() does), so nested
+ *   equivalences are costed in linear time without being expanded.
+ * - **Tseitin constraints**: the transformation is run into a ClauseCounter,
+ *   since flattening decides which operators need a gate; it is linear in
+ *   the expression size.
+ *
+ * Constraints that FMToCNF skips (non-boolean ones) are not listed. The
+ * prediction is exact for the plain transformation. Gates that FMToCNF
+ * shares between items in the 3-CNF modes (see GateCache), structural
+ * simplification and the post-processing passes only make the output
+ * smaller, so it is then an upper bound.
+ *
+ * Example:
+ * @code
+ * EncodingEstimator estimator(feature_model);
+ * estimator.estimate(CNFMode::STRAIGHTFORWARD);
+ * if (estimator.get_total().clauses > limit) {
+ *     estimator.estimate(CNFMode::TSEITIN);
+ * }
+ * @endcode
+ */
+class EncodingEstimator {
+public:
+    /// Value of saturated counts
+    static constexpr uint64_t UNBOUNDED = UINT64_MAX;
+
+private:
+    std::shared_ptr<FeatureModel> source_model;  ///< The feature model to estimate
+    EncodingCost total;                          ///< Cost of the whole encoding
+    std::vector<EncodingCostItem> items;         ///< Cost per relation and constraint
+    AtMostOnePolicy amo_policy;                  ///< At-most-one encoding of alternative groups
+    CardinalityPolicy card_policy;               ///< Count-bound encoding of cardinality groups
+
+public:
+    /**
+     * @brief Constructs an estimator for the given feature model
+     *
+     * @param model Shared pointer to the feature model
+     */
+    explicit EncodingEstimator(std::shared_ptr<FeatureModel> model);
+
+    /**
+     * @brief Sets the at-most-one encoding the conversion will use
+     *
+     * @param policy Encoding and pairwise threshold
+     */
+    void set_at_most_one_policy(const AtMostOnePolicy& policy) { amo_policy = policy; }
+
+    /**
+     * @brief Sets the cardinality encoding the conversion will use
+     *
+     * @param policy Encoding and enumeration threshold
+     */
+    void set_cardinality_policy(const CardinalityPolicy& policy) { card_policy = policy; }
+
+    /**
+     * @brief Predicts the encoding size for a conversion mode
+     *
+     * Results of the previous call are replaced.
+     *
+     * @param mode CNF conversion mode
+     * @throws std::runtime_error if the feature model has no root
+     */
+    void estimate(CNFMode mode);
+
+    /**
+     * @brief Gets the predicted size of the whole formula
+     *
+     * Includes the feature variables and the root unit clause.
+     *
+     * @return Total cost
+     */
+    const EncodingCost& get_total() const { return total; }
+
+    /**
+     * @brief Gets the predicted cost of each relation and encoded constraint
+     * @return Items in encoding order (relations first)
+     */
+    const std::vector<EncodingCostItem>& get_items() const { return items; }
+
+    /**
+     * @brief Gets the indices of the most expensive items
+     *
+     * @param count Maximum number of indices returned
+     * @return Indices into get_items(), by decreasing number of literals
+     */
+    std::vector<size_t> get_largest_items(size_t count) const;
+
+    /**
+     * @brief Predicts the memory of the clause arena of a CNFModel
+     *
+     * Literals are counted as 16-bit while the variable count fits (an upper
+     * bound of the largest literal) and offsets as 32-bit while the literal
+     * count does, as CNFModel stores them.
+     *
+     * @param cost Encoding cost
+     * @return Bytes of literals and clause offsets (saturating)
+     */
+    static uint64_t get_arena_bytes(const EncodingCost& cost);
+
+    /**
+     * @brief Predicts the cost of one relation
+     *
+     * @param relation Relation of the feature tree
+     * @param mode CNF conversion mode
+     * @param policy At-most-one encoding of alternative groups
+     * @param cardinality Count-bound encoding of cardinality groups
+     * @return Item with the relation's cost
+     */
+    static EncodingCostItem estimate_relation(const Relation& relation, CNFMode mode,
+                                              const AtMostOnePolicy& policy = AtMostOnePolicy(),
+                                              const CardinalityPolicy& cardinality = CardinalityPolicy());
+
+    /**
+     * @brief Predicts the cost of one boolean constraint
+     *
+     * @param constraint Cross-tree constraint (must be pure boolean)
+     * @param mode CNF conversion mode
+     * @return Item with the constraint's cost
+     */
+    static EncodingCostItem estimate_constraint(const Constraint& constraint, CNFMode mode);
+
+    /**
+     * @brief Chooses how HYBRID mode converts a constraint
+     *
+     * @param constraint Cross-tree constraint (must be pure boolean)
+     * @return TSEITIN if the direct conversion would have more literals, else STRAIGHTFORWARD
+     */
+    static CNFMode choose_constraint_mode(const Constraint& constraint);
+
+private:
+    /**
+     * @brief Predicts the Tseitin cost of a constraint expression
+     *
+     * @param node AST node
+     * @param mode TSEITIN or PLAISTED_GREENBAUM
+     * @return Auxiliary variables and clauses of the expression
+     */
+    static EncodingCost estimate_tseitin(const ASTNode& node, CNFMode mode);
+
+    /**
+     * @brief Predicts the cost of an at-most-one constraint over n literals
+     *
+     * @param n Number of literals
+     * @param mode CNF conversion mode
+     * @param policy At-most-one encoding
+     * @return Auxiliary variables and clauses of the encoding
+     */
+    static EncodingCost estimate_at_most_one(uint64_t n, CNFMode mode, const AtMostOnePolicy& policy);
+
+    /**
+     * @brief Predicts the cost of the count bounds of a cardinality group
+     *
+     * @param relation Cardinality relation
+     * @param mode CNF conversion mode
+     * @param policy Count-bound encoding
+     * @return Auxiliary variables and clauses of the bounds (without "child implies parent")
+     */
+    static EncodingCost estimate_cardinality(const Relation& relation, CNFMode mode, const CardinalityPolicy& policy);
+
+    /**
+     * @brief Predicts the straightforward cost of a constraint expression
+     *
+     * @param node AST node
+     * @param positive Output: clauses and literals of the NNF of the node
+     * @param negative Output: clauses and literals of the NNF of its negation
+     */
+    static void estimate_direct(const ASTNode& node, EncodingCost& positive, EncodingCost& negative);
+};
+
+#endif // ENCODINGESTIMATOR_H
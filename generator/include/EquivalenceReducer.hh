@@ -0,0 +1,115 @@
+/**
+ * @file EquivalenceReducer.hh
+ * @brief Equivalent-literal substitution on a CNF model
+ *
+ * This file defines the EquivalenceReducer class, which merges variables that
+ * the binary clauses of the formula force to be equal (or opposite).
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef EQUIVALENCEREDUCER_H
+#define EQUIVALENCEREDUCER_H
+
+#include "CNFModel.hh"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class EquivalenceReducer
+ * @brief Substitutes equivalent literals by a single representative
+ *
+ * Mandatory relations (parent <=> child), <=> constraints and Tseitin gate
+ * definitions produce pairs of binary clauses (-a | b) and (-b | a), which
+ * make a and b provably equal. The reducer:
+ *
+ * 1. Builds the binary implication graph: clause (a | b) yields the edges
+ *    -a -> b and -b -> a over the 2n literal nodes
+ * 2. Finds its strongly connected components (iterative Tarjan); all literals
+ *    in a component are equivalent
+ * 3. Picks the literal with the smallest variable ID as representative, so a
+ *    feature is preferred over an auxiliary variable
+ * 4. Renumbers the variables with CNFModel::remap_variables(), rewriting all
+ *    clauses, and removes the resulting tautologies and duplicates
+ *
+ * Substitution repeats while it keeps finding new equivalences, since merged
+ * clauses can become binary. The number of satisfying assignments is
+ * preserved, because every removed variable is a function of a kept one.
+ * Merged features stay visible in the DIMACS output as
+ * `c <literal> <name> (equivalent)` lines, so solutions map back to features.
+ *
+ * If some variable is equivalent to its own negation the formula is
+ * unsatisfiable; the model is then left unchanged and is_unsatisfiable()
+ * returns true.
+ *
+ * @see CNFModel::remap_variables() for the renumbering
+ * @see ClauseNormalizer for the clause cleanup after substitution
+ *
+ * Example:
+ * @code
+ * CNFModel cnf = transformer.transform(CNFMode::STRAIGHTFORWARD);
+ * EquivalenceReducer reducer;
+ * reducer.reduce(cnf);
+ * std::cout << reducer.get_merged_variables() << " variables merged\n";
+ * @endcode
+ */
+class EquivalenceReducer {
+private:
+    size_t merged_variables;   ///< Variables removed by substitution
+    size_t removed_clauses;    ///< Clauses removed after substitution
+    size_t rounds;             ///< Substitution rounds performed
+    bool unsatisfiable;        ///< Whether a variable is equivalent to its negation
+
+public:
+    /**
+     * @brief Constructs a reducer with all statistics at zero
+     */
+    EquivalenceReducer();
+
+    /**
+     * @brief Merges equivalent variables of a CNF model in place
+     *
+     * Statistics of the previous call are reset.
+     *
+     * @param model CNF model to reduce
+     */
+    void reduce(CNFModel& model);
+
+    /**
+     * @brief Gets the number of variables merged into a representative
+     * @return Number of removed variables
+     */
+    size_t get_merged_variables() const { return merged_variables; }
+
+    /**
+     * @brief Gets the number of clauses removed after substitution
+     * @return Tautologies and duplicates created by the substitution
+     */
+    size_t get_removed_clauses() const { return removed_clauses; }
+
+    /**
+     * @brief Gets the number of substitution rounds performed
+     * @return Rounds that merged at least one variable
+     */
+    size_t get_rounds() const { return rounds; }
+
+    /**
+     * @brief Checks whether a contradiction was found
+     * @return true if some variable is equivalent to its own negation
+     */
+    bool is_unsatisfiable() const { return unsatisfiable; }
+
+private:
+    /**
+     * @brief Computes the representative literal of every variable
+     *
+     * @param model CNF model whose binary clauses are analyzed
+     * @param representative Output: representative[v] is the literal equal to v
+     * @return Number of variables whose representative is another variable,
+     *         or 0 if a contradiction was found
+     */
+    size_t find_representatives(const CNFModel& model, std::vector<int>& representative);
+};
+
+#endif // EQUIVALENCEREDUCER_H
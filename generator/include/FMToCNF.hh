@@ -16,6 +16,14 @@
 #include "FeatureModel.hh"
 #include "CNFModel.hh"
 #include "CNFMode.hh"
+#include "ClauseSink.hh"
+#include "StructuralAnalyzer.hh"
+#include "ResourceBudget.hh"
+#include "RelationEncoder.hh"
+#include "GateCache.hh"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
 #include <memory>
 
 /**
@@ -39,6 +47,10 @@
  * - **STRAIGHTFORWARD**: Direct conversion without auxiliary variables
  * - **TSEITIN**: Tseitin transformation with auxiliary variables (3-CNF)
  *
+ * With set_num_threads(), straightforward relations and constraints are
+ * encoded by worker threads and merged in model order, so the output is
+ * identical to the sequential one.
+ *
  * @see FeatureModel for the input feature model structure
  * @see CNFModel for the output CNF representation
  * @see CNFMode for conversion mode options
@@ -56,6 +68,19 @@ private:
     std::shared_ptr<FeatureModel> source_model;  ///< The feature model to convert
     CNFModel cnf_model;                          ///< The resulting CNF model
     CNFMode mode;                                ///< Conversion mode for constraints
+    ClauseSink* sink;                            ///< Destination of the generated clauses
+    bool use_structural;                         ///< Whether core/dead features simplify clauses
+    std::vector<int8_t> fixed_values;            ///< Per variable: 1 core, -1 dead, 0 unknown
+    size_t num_core_features;                    ///< Core features found by structural analysis
+    size_t num_dead_features;                    ///< Dead features found by structural analysis
+    size_t num_simplified_clauses;               ///< Clauses dropped as satisfied by fixed features
+    bool void_model;                             ///< Whether structural analysis proved the model void
+    size_t num_tseitin_constraints;              ///< Constraints converted with auxiliary variables
+    ResourceBudget* budget;                      ///< Limits charged while encoding (nullptr = none)
+    AtMostOnePolicy amo_policy;                  ///< At-most-one encoding of alternative groups
+    CardinalityPolicy card_policy;               ///< Count-bound encoding of cardinality groups
+    GateCache gate_cache;                        ///< Tseitin gates shared across relations and constraints
+    unsigned num_threads;                        ///< Threads encoding relations and constraints (1 = sequential)
 
 public:
     /**
@@ -79,6 +104,9 @@ public:
      * 3. Encodes all parent-child relations
      * 4. Converts all cross-tree constraints
      *
+     * The CNF model is moved out of the transformer (no copy of the clause
+     * arena), so each FMToCNF instance should be transformed only once.
+     *
      * @param conversion_mode CNF conversion mode (STRAIGHTFORWARD or TSEITIN)
      * @return The resulting CNF model
      *
@@ -86,6 +114,159 @@ public:
      */
     CNFModel transform(CNFMode conversion_mode = CNFMode::STRAIGHTFORWARD);
 
+    /**
+     * @brief Transforms the feature model to CNF, emitting clauses to a sink
+     *
+     * Same transformation as transform(CNFMode), but clauses are passed to
+     * the given sink instead of being stored. The variable table is still
+     * built internally and is available through get_cnf_model() afterwards
+     * (it holds no clauses). The sink's begin_formula() is called once all
+     * feature variables exist and end_formula() after the last clause.
+     *
+     * @param out Destination of the generated clauses
+     * @param conversion_mode CNF conversion mode (STRAIGHTFORWARD or TSEITIN)
+     *
+     * @see DimacsStreamWriter for writing clauses directly to a file
+     */
+    void transform(ClauseSink& out, CNFMode conversion_mode = CNFMode::STRAIGHTFORWARD);
+
+    /**
+     * @brief Enables or disables structural simplification
+     *
+     * When enabled, StructuralAnalyzer derives core and dead features from
+     * the tree and small constraints before any clause is emitted. Each fixed
+     * feature is asserted by a unit clause right after the root clause, and
+     * all relation and constraint clauses are simplified with these values:
+     * satisfied clauses are dropped and false literals removed. The number of
+     * solutions is unchanged. If the analysis finds the model void, no
+     * simplification is applied.
+     *
+     * @param enabled true to simplify with structural core/dead features
+     */
+    void set_structural_simplification(bool enabled) { use_structural = enabled; }
+
+    /**
+     * @brief Sets the memory limit of the clause arena of the resulting model
+     *
+     * @param bytes Heap limit per arena buffer before it spills to a
+     *        memory-mapped temporary file (0 = never spill)
+     *
+     * @see CNFModel::set_spill_threshold()
+     */
+    void set_spill_threshold(size_t bytes) { cnf_model.set_spill_threshold(bytes); }
+
+    /**
+     * @brief Sets the resource budget of the transformation
+     *
+     * Before each relation and constraint is encoded, its predicted size is
+     * reserved from the budget, and every emitted clause is charged to it.
+     * When a limit is exceeded, transform() throws BudgetExceeded naming the
+     * relation or constraint. The budget must outlive the transformation and
+     * is not started here (see ResourceBudget::start()).
+     *
+     * @param resource_budget Budget to enforce (nullptr = unlimited)
+     */
+    void set_resource_budget(ResourceBudget* resource_budget) { budget = resource_budget; }
+
+    /**
+     * @brief Sets the at-most-one encoding of alternative groups
+     *
+     * @param policy Encoding and pairwise threshold (default: pairwise)
+     * @see RelationEncoder::set_at_most_one_policy()
+     */
+    void set_at_most_one_policy(const AtMostOnePolicy& policy) { amo_policy = policy; }
+
+    /**
+     * @brief Sets the count-bound encoding of cardinality groups
+     *
+     * @param policy Encoding and enumeration threshold (default: enumeration)
+     * @see RelationEncoder::set_cardinality_policy()
+     */
+    void set_cardinality_policy(const CardinalityPolicy& policy) { card_policy = policy; }
+
+    /**
+     * @brief Sets the number of threads encoding relations and constraints
+     *
+     * Relations and constraints are split into chunks of consecutive items
+     * that idle workers pick up in order. Each worker numbers its auxiliary
+     * variables privately; the chunks are merged in model order, giving the
+     * auxiliaries their final IDs, so variables and clauses are exactly those
+     * of the sequential transformation.
+     *
+     * Only straightforward transformations without a resource budget run in
+     * parallel: the Tseitin modes share gates across the whole model, and the
+     * budget is charged item by item before encoding. Sinks with native
+     * cardinality constraints are also encoded sequentially, since the
+     * workers buffer plain clauses.
+     *
+     * @param threads Number of worker threads (0 = one per hardware thread, 1 = sequential)
+     */
+    void set_num_threads(unsigned threads);
+
+    /**
+     * @brief Checks whether a transformation can use the threads of set_num_threads()
+     *
+     * Callers use it to report a thread count that will be ignored.
+     *
+     * @param conversion_mode Transformation mode
+     * @param native_cardinality Whether the sink has native cardinality constraints
+     * @return true for STRAIGHTFORWARD mode without a resource budget or native sink
+     */
+    bool supports_threads(CNFMode conversion_mode, bool native_cardinality) const {
+        return conversion_mode == CNFMode::STRAIGHTFORWARD && budget == nullptr && !native_cardinality;
+    }
+
+    /**
+     * @brief Gets the number of core features found by the last transformation
+     * @return Core features (0 if structural simplification is disabled)
+     */
+    size_t get_num_core_features() const { return num_core_features; }
+
+    /**
+     * @brief Gets the number of dead features found by the last transformation
+     * @return Dead features (0 if structural simplification is disabled)
+     */
+    size_t get_num_dead_features() const { return num_dead_features; }
+
+    /**
+     * @brief Gets the number of clauses dropped by structural simplification
+     * @return Clauses satisfied by core/dead features
+     */
+    size_t get_num_simplified_clauses() const { return num_simplified_clauses; }
+
+    /**
+     * @brief Checks whether the last transformation found the model void
+     * @return true if structural analysis derived conflicting values (no configuration exists)
+     */
+    bool is_void_model() const { return void_model; }
+
+    /**
+     * @brief Gets the number of Tseitin gates reused by the last transformation
+     *
+     * In the 3-CNF modes, structurally identical gates (OR trees of groups,
+     * counter gates and constraint subexpressions) share one auxiliary
+     * variable across the whole model.
+     *
+     * @return Gates that were not defined again (0 in straightforward mode)
+     */
+    uint64_t get_num_shared_gates() const { return gate_cache.get_num_hits(); }
+
+    /**
+     * @brief Gets the number of constraints Tseitin-encoded by the last transformation
+     *
+     * In HYBRID mode these are the constraints whose direct conversion
+     * would have been larger.
+     *
+     * @return Tseitin-encoded constraints (all boolean ones in the 3-CNF modes)
+     */
+    size_t get_num_tseitin_constraints() const { return num_tseitin_constraints; }
+
+    /**
+     * @brief Gets the variable table built by transform(ClauseSink&, CNFMode)
+     * @return The internal CNF model
+     */
+    const CNFModel& get_cnf_model() const { return cnf_model; }
+
 private:
     /**
      * @brief Adds all features as variables to the CNF model
@@ -94,11 +275,29 @@ private:
      */
     void add_features();
 
+    /**
+     * @brief Emits the root, relation and constraint clauses
+     *
+     * With a resource budget, the sink is wrapped in a BudgetSink for the
+     * duration of the call.
+     */
+    void add_clauses();
+
+    /**
+     * @brief Derives core and dead features and records their variable values
+     *
+     * Only runs when structural simplification is enabled.
+     *
+     * @see StructuralAnalyzer
+     */
+    void analyze_structure();
+
     /**
      * @brief Adds the root constraint
      *
      * Adds a unit clause asserting that the root feature must be selected.
-     * This ensures at least one valid configuration exists.
+     * This ensures at least one valid configuration exists. With structural
+     * simplification, unit clauses for all other core and dead features follow.
      */
     void add_root();
 
@@ -109,6 +308,7 @@ private:
      * into the corresponding CNF clauses.
      *
      * @see RelationEncoder for encoding details
+     * @throws BudgetExceeded if a relation does not fit the resource budget
      */
     void add_relations();
 
@@ -116,8 +316,20 @@ private:
      * @brief Converts all cross-tree constraints to CNF clauses
      *
      * Converts each constraint expression to CNF using the specified mode.
+     *
+     * @throws BudgetExceeded if a constraint does not fit the resource budget
      */
     void add_constraints();
+
+    /**
+     * @brief Encodes relations and constraints on worker threads
+     *
+     * Emits the same variables and clauses as add_relations() followed by
+     * add_constraints() in STRAIGHTFORWARD mode.
+     *
+     * @see set_num_threads()
+     */
+    void add_in_parallel();
 };
 
 #endif // FMTOCNF_H
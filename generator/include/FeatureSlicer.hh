@@ -0,0 +1,160 @@
+/**
+ * @file FeatureSlicer.hh
+ * @brief Projection of a CNF model onto a subset of its features
+ *
+ * This file defines the FeatureSlicer class, which removes every variable
+ * outside a list of features to keep by resolution-based variable
+ * elimination.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef FEATURESLICER_H
+#define FEATURESLICER_H
+
+#include "CNFModel.hh"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class FeatureSlicer
+ * @brief Eliminates all variables except the kept features
+ *
+ * Eliminating a variable x by resolution (Davis-Putnam) replaces the clauses
+ * containing x or -x by all their non-tautological resolvents on x. The
+ * result is equivalent to "exists x. F", so after eliminating every variable
+ * that is not kept, the solutions of the formula are exactly the projections
+ * of the original configurations onto the kept features.
+ *
+ * Elimination runs in three phases:
+ *
+ * 1. **Tree order**: auxiliary variables first, then features in decreasing
+ *    ID. Feature IDs follow the depth-first order of the tree, so every
+ *    feature is eliminated before its parent, while it is still a leaf
+ *    that only occurs in its group clauses. A variable is eliminated here
+ *    only if the number of clauses does not grow; alternative groups and
+ *    optional subtrees typically resolve away completely.
+ * 2. **Bounded elimination**: the remaining variables, cheapest first (by
+ *    the product of their positive and negative occurrences), are
+ *    eliminated if the number of clauses grows by at most the growth limit.
+ *    Passes repeat while they make progress.
+ * 3. **Unbounded elimination**: the variables left over, cheapest first,
+ *    are eliminated whatever the growth, as long as the formula stays
+ *    within the clause limit (set_max_clauses()). Past the limit, slice()
+ *    fails instead of leaving variables that are not kept.
+ *
+ * The result is cleaned with ClauseNormalizer, and the eliminated variables
+ * are removed from the variable table with CNFModel::remap_variables(); kept
+ * variables preserve their relative order.
+ *
+ * Example:
+ * @code
+ * FeatureSlicer slicer({"Engine", "Navigation"});
+ * slicer.slice(cnf);
+ * std::cout << slicer.get_eliminated_variables() << " variables eliminated\n";
+ * @endcode
+ */
+class FeatureSlicer {
+public:
+    /// Default number of clauses an elimination may add in the bounded phase
+    static constexpr size_t DEFAULT_MAX_GROWTH = 16;
+    /// Default number of clauses the formula may reach in the unbounded phase
+    static constexpr size_t DEFAULT_MAX_CLAUSES = 1000000;
+
+private:
+    std::vector<std::string> keep_features;   ///< Names of the features to keep
+    size_t max_growth;                        ///< Allowed clause growth per elimination
+    size_t max_clauses;                       ///< Clause limit of the unbounded phase
+
+    size_t kept_variables;                    ///< Variables of kept features
+    size_t eliminated_variables;              ///< Variables removed by elimination
+
+    std::vector<std::vector<int>> clauses;    ///< Clause database during elimination
+    size_t num_live_clauses;                  ///< Clauses not deleted
+    std::vector<char> deleted;                ///< Per-clause deletion flags
+    std::vector<std::vector<uint32_t>> occurrences;  ///< Per literal index: clauses containing it
+    std::vector<uint32_t> stamp;              ///< Per literal index: marker for resolvent building
+    uint32_t current_stamp;                   ///< Marker value of the current resolvent
+
+public:
+    /**
+     * @brief Constructs a slicer keeping the given features
+     *
+     * @param features Names of the features to keep
+     */
+    explicit FeatureSlicer(const std::vector<std::string>& features);
+
+    /**
+     * @brief Sets the growth limit of the bounded elimination phase
+     * @param growth Number of clauses an elimination may add (0 = never grow)
+     */
+    void set_max_growth(size_t growth) { max_growth = growth; }
+
+    /**
+     * @brief Sets the clause limit of the unbounded elimination phase
+     * @param limit Number of clauses the formula may reach
+     */
+    void set_max_clauses(size_t limit) { max_clauses = limit; }
+
+    /**
+     * @brief Projects a CNF model onto the kept features
+     *
+     * Statistics of the previous call are reset.
+     *
+     * @param model CNF model rewritten in place
+     * @throws std::invalid_argument if a kept feature is not in the model
+     * @throws std::runtime_error if eliminating a variable exceeds the clause limit
+     */
+    void slice(CNFModel& model);
+
+    /**
+     * @brief Gets the number of variables of kept features
+     * @return Kept variables
+     */
+    size_t get_kept_variables() const { return kept_variables; }
+
+    /**
+     * @brief Gets the number of variables removed by elimination
+     * @return Eliminated variables
+     */
+    size_t get_eliminated_variables() const { return eliminated_variables; }
+
+private:
+    /**
+     * @brief Marks the variables of the kept features
+     *
+     * @param model CNF model
+     * @return Per variable ID: 1 if kept
+     * @throws std::invalid_argument if a feature is not in the model
+     */
+    std::vector<char> find_kept_variables(const CNFModel& model) const;
+
+    /**
+     * @brief Adds a clause to the database and its occurrence lists
+     *
+     * @param clause Sorted clause without repeated literals
+     */
+    void add_clause(std::vector<int>&& clause);
+
+    /**
+     * @brief Gets the live clauses containing a literal, dropping deleted ones
+     *
+     * @param literal Literal
+     * @return Occurrence list of the literal
+     */
+    const std::vector<uint32_t>& live_occurrences(int literal);
+
+    /**
+     * @brief Eliminates a variable if the clause growth stays within a limit
+     *
+     * @param var Variable to eliminate
+     * @param growth Number of clauses the elimination may add
+     * @return true if the variable was eliminated
+     */
+    bool try_eliminate(int var, size_t growth);
+};
+
+#endif // FEATURESLICER_H
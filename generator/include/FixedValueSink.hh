@@ -0,0 +1,86 @@
+/**
+ * @file FixedValueSink.hh
+ * @brief Clause sink that simplifies clauses with known variable values
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef FIXEDVALUESINK_H
+#define FIXEDVALUESINK_H
+
+#include "ClauseSink.hh"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class FixedValueSink
+ * @brief Forwards clauses to another sink after applying fixed literals
+ *
+ * Given values for some variables that are implied by the formula (e.g.,
+ * core and dead features found by StructuralAnalyzer), each incoming clause
+ * is simplified before it is passed on:
+ * - clauses containing a true literal are dropped (already satisfied)
+ * - false literals are removed from the remaining clauses
+ * - at-least constraints lose their false literals, and each true literal
+ *   lowers the bound; they are dropped once the bound is reached
+ *
+ * The fixed values themselves must be asserted separately as unit clauses
+ * (FMToCNF does so), so the simplified formula has exactly the same
+ * solutions as the original one.
+ *
+ * @see StructuralAnalyzer for deriving the fixed values
+ * @see FMToCNF::set_structural_simplification()
+ */
+class FixedValueSink : public ClauseSink {
+private:
+    ClauseSink& target;                 ///< Sink receiving the simplified clauses
+    const std::vector<int8_t>& values;  ///< Per variable: 1 true, -1 false, 0 unknown
+    std::vector<int> buffer;            ///< Literals of the clause being simplified
+    bool satisfied;                     ///< Whether the current clause has a true literal
+    size_t removed_clauses;             ///< Clauses dropped as satisfied
+    size_t removed_literals;            ///< False literals removed
+
+    /**
+     * @brief Fills the buffer with the unknown literals of an at-least constraint
+     * @return Bound left after subtracting the true literals
+     */
+    int simplify_at_least(int bound, const int* first, const int* last);
+
+public:
+    /**
+     * @brief Constructs a sink forwarding to target
+     *
+     * @param target_sink Sink receiving the simplified clauses
+     * @param fixed_values Value per variable ID (1 true, -1 false, 0 unknown);
+     *        variables beyond its size are unknown
+     */
+    FixedValueSink(ClauseSink& target_sink, const std::vector<int8_t>& fixed_values);
+
+    void begin_clause() override;
+    void add_literal(int literal) override;
+    void end_clause() override;
+
+    bool has_native_cardinality() const override { return target.has_native_cardinality(); }
+    void add_at_least(int bound, const int* first, const int* last) override;
+    using ClauseSink::add_at_least;
+
+    bool has_weighted_cardinality() const override { return target.has_weighted_cardinality(); }
+    void add_guarded_at_least(int guard, int bound, const int* first, const int* last) override;
+    using ClauseSink::add_guarded_at_least;
+
+    /**
+     * @brief Gets the number of clauses dropped because they were satisfied
+     * @return Number of removed clauses
+     */
+    size_t get_removed_clauses() const { return removed_clauses; }
+
+    /**
+     * @brief Gets the number of false literals removed from clauses
+     * @return Number of removed literals
+     */
+    size_t get_removed_literals() const { return removed_literals; }
+};
+
+#endif // FIXEDVALUESINK_H
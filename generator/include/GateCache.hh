@@ -0,0 +1,152 @@
+/**
+ * @file GateCache.hh
+ * @brief Structural hashing of Tseitin gate definitions
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef GATECACHE_H
+#define GATECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @enum GateType
+ * @brief Kinds of gates shared through a GateCache
+ */
+enum class GateType {
+    AND,          ///< result ⟺ (in_1 ∧ ... ∧ in_k)
+    OR,           ///< result ⟺ (in_1 ∨ ... ∨ in_k)
+    EQUIVALENCE   ///< result ⟺ (in_1 ⟺ in_2)
+};
+
+/**
+ * @class GateCache
+ * @brief Remembers the auxiliary literal defined for each gate
+ *
+ * Gates are keyed by their canonical form, so structurally identical gates
+ * map to one entry no matter where they were built:
+ * - inputs of AND and OR are sorted and deduplicated (commutativity)
+ * - OR is stored as the negated AND of the negated inputs (De Morgan)
+ * - an equivalence is stored over unsigned inputs, the input signs moving
+ *   to the result (¬a ⟺ b is the negation of a ⟺ b)
+ *
+ * Each entry also records which directions of the definition were emitted
+ * ("result → gate" and "gate → result"), so a one-sided Plaisted-Greenbaum
+ * gate is only reused where that direction suffices.
+ *
+ * Reusing a literal is sound wherever its definition is part of the same
+ * formula, which is why one cache is shared across a whole conversion and
+ * cleared before the next.
+ *
+ * Example:
+ * @code
+ * GateCache gates;
+ * int found = gates.find(GateType::OR, inputs.data(), inputs.data() + inputs.size(), true, true);
+ * if (found == 0) {
+ *     found = ...;  // create and define the auxiliary variable
+ *     gates.insert(GateType::OR, inputs.data(), inputs.data() + inputs.size(), true, true, found);
+ * }
+ * @endcode
+ */
+class GateCache {
+private:
+    /**
+     * @brief Canonical form of a gate
+     */
+    struct Key {
+        bool equivalence;         ///< EQUIVALENCE rather than AND
+        std::vector<int> inputs;  ///< Sorted, deduplicated input literals
+
+        bool operator==(const Key& other) const {
+            return equivalence == other.equivalence && inputs == other.inputs;
+        }
+    };
+
+    /**
+     * @brief Hash of a canonical gate
+     */
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    /**
+     * @brief Defined literal of a canonical gate
+     */
+    struct Entry {
+        int literal;    ///< Literal equivalent to the canonical gate
+        bool positive;  ///< "literal → gate" clauses were emitted
+        bool negative;  ///< "gate → literal" clauses were emitted
+    };
+
+    std::unordered_map<Key, Entry, KeyHash> gates;  ///< Defined gates by canonical form
+    Key scratch;                                    ///< Reused key of the last lookup
+    uint64_t num_hits;                              ///< Lookups answered from the cache
+
+public:
+    /**
+     * @brief Constructs an empty cache
+     */
+    GateCache();
+
+    /**
+     * @brief Looks up a gate
+     *
+     * @param type Gate type
+     * @param first Pointer to the first input literal
+     * @param last Pointer past the last input literal
+     * @param positive Whether "result → gate" is needed
+     * @param negative Whether "gate → result" is needed
+     * @return Literal defined for the gate with at least these directions, or 0
+     */
+    int find(GateType type, const int* first, const int* last, bool positive, bool negative);
+
+    /**
+     * @brief Records the literal defined for a gate
+     *
+     * An existing entry is only replaced if the new definition has a
+     * direction the old one lacks.
+     *
+     * @param type Gate type
+     * @param first Pointer to the first input literal
+     * @param last Pointer past the last input literal
+     * @param positive Whether "result → gate" clauses were emitted
+     * @param negative Whether "gate → result" clauses were emitted
+     * @param result Literal defined for the gate
+     */
+    void insert(GateType type, const int* first, const int* last, bool positive, bool negative, int result);
+
+    /**
+     * @brief Forgets all gates and resets the statistics
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of distinct gates recorded
+     * @return Number of entries
+     */
+    size_t get_num_gates() const { return gates.size(); }
+
+    /**
+     * @brief Gets the number of gates reused instead of defined again
+     * @return Successful lookups
+     */
+    uint64_t get_num_hits() const { return num_hits; }
+
+private:
+    /**
+     * @brief Builds the canonical key of a gate into scratch
+     *
+     * @param type Gate type
+     * @param first Pointer to the first input literal
+     * @param last Pointer past the last input literal
+     * @return Sign relating the gate to its canonical form (-1: negated)
+     */
+    int canonicalize(GateType type, const int* first, const int* last);
+};
+
+#endif // GATECACHE_H
@@ -0,0 +1,59 @@
+/**
+ * @file KnfStreamWriter.hh
+ * @brief Clause sink that writes KNF (DIMACS with cardinality lines) to a file
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef KNFSTREAMWRITER_H
+#define KNFSTREAMWRITER_H
+
+#include "DimacsStreamWriter.hh"
+#include <string>
+#include <cstdint>
+
+/**
+ * @class KnfStreamWriter
+ * @brief Streams clauses and native at-least constraints to a KNF file
+ *
+ * KNF is the DIMACS dialect read by cardinality-aware SAT solvers. The
+ * problem line is `p knf <variables> <constraints>`, clauses are written as
+ * in DIMACS, and "at least k of the literals" is a line
+ * `k <k> <lit_1> ... <lit_n> 0`. Both kinds of lines count as constraints.
+ *
+ * The file layout is otherwise that of DimacsStreamWriter (patched header,
+ * feature comments first, auxiliary comments last).
+ *
+ * Example:
+ * @code
+ * KnfStreamWriter writer("model.knf");
+ * FMToCNF transformer(feature_model);
+ * transformer.transform(writer, CNFMode::STRAIGHTFORWARD);
+ * @endcode
+ */
+class KnfStreamWriter : public DimacsStreamWriter {
+private:
+    uint64_t num_cardinality;  ///< Cardinality lines written so far
+
+public:
+    /**
+     * @brief Opens the output file
+     *
+     * @param path Path to the output file (created or overwritten)
+     * @throws std::runtime_error if the file cannot be opened for writing
+     */
+    explicit KnfStreamWriter(const std::string& path);
+
+    bool has_native_cardinality() const override { return true; }
+    void add_at_least(int bound, const int* first, const int* last) override;
+    using ClauseSink::add_at_least;
+
+    /**
+     * @brief Gets the number of cardinality lines written
+     * @return Number of "k" lines (also counted by get_num_clauses())
+     */
+    uint64_t get_num_cardinality_constraints() const { return num_cardinality; }
+};
+
+#endif // KNFSTREAMWRITER_H
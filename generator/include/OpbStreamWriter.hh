@@ -0,0 +1,111 @@
+/**
+ * @file OpbStreamWriter.hh
+ * @brief Clause sink that writes pseudo-Boolean OPB constraints to a file
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef OPBSTREAMWRITER_H
+#define OPBSTREAMWRITER_H
+
+#include "ClauseSink.hh"
+#include "CNFModel.hh"
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+/**
+ * @class OpbStreamWriter
+ * @brief Streams clauses and native at-least constraints to an OPB file
+ *
+ * OPB is the input format of pseudo-Boolean solvers. Variable v is written
+ * as `x<v>`, and every constraint is a linear inequality
+ * `<coefficient> x<v> ... >= <degree> ;`. A negative literal ¬x counts as
+ * (1 - x), so "at least k of the literals" becomes
+ * `+1 x<p> ... -1 x<n> ... >= k - <number of negative literals> ;`
+ * and a clause is the case k = 1. The lower bound of a group is guarded by
+ * its parent p with the coefficient k: `-k x<p> ... >= 0 ;` when all
+ * literals are positive. No objective is written.
+ *
+ * As with DimacsStreamWriter, the counts in the first line
+ * (`* #variable= N #constraint= M`) are space-padded placeholders patched by
+ * end_formula(), so the output must be a seekable file. Feature names
+ * follow as `* x<v> <name>` comments, and auxiliary names after the
+ * constraints.
+ *
+ * Example:
+ * @code
+ * OpbStreamWriter writer("model.opb");
+ * FMToCNF transformer(feature_model);
+ * transformer.transform(writer, CNFMode::STRAIGHTFORWARD);
+ * @endcode
+ */
+class OpbStreamWriter : public ClauseSink {
+private:
+    std::string filepath;                    ///< Output file path (for error messages)
+    std::ofstream out;                       ///< Output file
+    std::ofstream::pos_type variables_pos;   ///< Position of the variable count placeholder
+    std::ofstream::pos_type constraints_pos; ///< Position of the constraint count placeholder
+    uint64_t num_constraints;                ///< Constraints written so far
+    uint64_t num_cardinality;                ///< At-least constraints (bound above 1) written so far
+    int num_negative;                        ///< Negative literals of the clause being written
+    bool header_written;                     ///< Whether begin_formula() has run
+
+public:
+    /**
+     * @brief Opens the output file
+     *
+     * @param path Path to the output file (created or overwritten)
+     * @throws std::runtime_error if the file cannot be opened for writing
+     */
+    explicit OpbStreamWriter(const std::string& path);
+
+    /**
+     * @brief Destructor
+     */
+    ~OpbStreamWriter() override = default;
+
+    void begin_clause() override { num_negative = 0; }
+    void add_literal(int literal) override;
+    void end_clause() override;
+    void add_clause(const int* first, const int* last) override;
+    using ClauseSink::add_clause;
+
+    bool has_native_cardinality() const override { return true; }
+    void add_at_least(int bound, const int* first, const int* last) override;
+    using ClauseSink::add_at_least;
+
+    bool has_weighted_cardinality() const override { return true; }
+    void add_guarded_at_least(int guard, int bound, const int* first, const int* last) override;
+    using ClauseSink::add_guarded_at_least;
+
+    /**
+     * @brief Writes the header placeholders and the feature comment lines
+     *
+     * @param variables Variable table with all feature variables
+     */
+    void begin_formula(const CNFModel& variables) override;
+
+    /**
+     * @brief Writes auxiliary comment lines and patches the header counts
+     *
+     * @param variables Final variable table
+     * @throws std::runtime_error if the file could not be written
+     */
+    void end_formula(const CNFModel& variables) override;
+
+    /**
+     * @brief Gets the number of constraints written
+     * @return Number of clauses and at-least constraints
+     */
+    uint64_t get_num_constraints() const { return num_constraints; }
+
+    /**
+     * @brief Gets the number of native cardinality constraints written
+     * @return Number of at-least constraints (also counted by get_num_constraints())
+     */
+    uint64_t get_num_cardinality_constraints() const { return num_cardinality; }
+};
+
+#endif // OPBSTREAMWRITER_H
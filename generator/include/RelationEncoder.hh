@@ -14,10 +14,101 @@
 
 #include "Relation.hh"
 #include "CNFModel.hh"
+#include "ClauseSink.hh"
 #include "CNFMode.hh"
+#include "GateCache.hh"
+#include <cstddef>
 #include <vector>
 #include <memory>
 
+/**
+ * @enum AtMostOneEncoding
+ * @brief Encoding of the "at most one child" part of ALTERNATIVE groups
+ *
+ * All encodings other than PAIRWISE introduce auxiliary variables. Every
+ * auxiliary variable is fully defined by the children (e.g., as the OR of a
+ * subset of them), so each assignment of the features extends to exactly
+ * one satisfying assignment of the auxiliaries and the number of solutions
+ * is preserved. In TSEITIN mode, every clause keeps at most 3 literals.
+ */
+enum class AtMostOneEncoding {
+    PAIRWISE,    ///< (¬xi ∨ ¬xj) for every pair: n(n-1)/2 clauses, no auxiliary variables
+    SEQUENTIAL,  ///< Sequential counter: prefix ORs p_i = p_{i-1} ∨ x_i, 4n-7 clauses, n-2 auxiliaries
+    LADDER,      ///< Ladder: suffix ORs y_i channelled to x_i = y_i ∧ ¬y_{i+1}, 4(n-1) clauses, n-1 auxiliaries
+    COMMANDER,   ///< Commander: pairwise within groups of 3, recursion on the ORs of the groups
+    BIMANDER,    ///< Bimander: pairwise within groups of 2, groups told apart by ⌈log2(n/2)⌉ OR-defined bits
+    PRODUCT      ///< 2-product: children on a √n × √n grid, recursion on the row and column ORs
+};
+
+/**
+ * @struct AtMostOnePolicy
+ * @brief Chooses the at-most-one encoding by group size
+ *
+ * Groups with fewer than threshold children (and always groups of at most 2)
+ * keep the pairwise encoding, which is smaller for them; larger groups use
+ * the selected linear encoding. The default policy is pairwise everywhere.
+ */
+struct AtMostOnePolicy {
+    /// Default size from which linear encodings are used (pairwise is smaller below it)
+    static constexpr size_t DEFAULT_THRESHOLD = 8;
+
+    AtMostOneEncoding encoding = AtMostOneEncoding::PAIRWISE;  ///< Encoding of large groups
+    size_t threshold = DEFAULT_THRESHOLD;                      ///< Smallest group size using it
+
+    /**
+     * @brief Checks whether a group of n literals is encoded pairwise
+     * @param n Number of literals
+     * @return true if the pairwise encoding is used
+     */
+    bool is_pairwise(size_t n) const {
+        return encoding == AtMostOneEncoding::PAIRWISE || n <= 2 || n < threshold;
+    }
+};
+
+/**
+ * @enum CardinalityEncoding
+ * @brief Encoding of the count bounds of CARDINALITY groups
+ *
+ * The counter encodings build unary outputs o_1..o_K over the children, with
+ * o_k true exactly when at least k children are selected, and bound them with
+ * (¬parent ∨ o_min) and (¬parent ∨ ¬o_{max+1}). The outputs are only built up
+ * to the largest bound needed. Every auxiliary variable is fully defined by
+ * the children, so the number of solutions is preserved, and every clause
+ * has at most 3 literals.
+ */
+enum class CardinalityEncoding {
+    ENUMERATION,         ///< One clause per subset of the children: 2^n clauses, no auxiliary variables
+    SEQUENTIAL_COUNTER,  ///< Sequential counter s_{i,k} = s_{i-1,k} ∨ (s_{i-1,k-1} ∧ x_i): O(n·K) clauses
+    TOTALIZER,           ///< Totalizer: unary sums merged along a balanced tree, O(n·K) clauses
+    SORTING_NETWORK,     ///< Odd-even merge sorting network of OR/AND comparators: O(n log² n) clauses
+    AUTO                 ///< The smallest of the three counters, by number of literals
+};
+
+/**
+ * @struct CardinalityPolicy
+ * @brief Chooses the cardinality encoding by group size
+ *
+ * Groups with fewer than threshold children keep the enumeration, which is
+ * small for them; larger groups use the selected counter encoding. The
+ * default policy is enumeration everywhere.
+ */
+struct CardinalityPolicy {
+    /// Default size from which counter encodings are used (2^8 enumeration clauses)
+    static constexpr size_t DEFAULT_THRESHOLD = 8;
+
+    CardinalityEncoding encoding = CardinalityEncoding::ENUMERATION;  ///< Encoding of large groups
+    size_t threshold = DEFAULT_THRESHOLD;                             ///< Smallest group size using it
+
+    /**
+     * @brief Checks whether a group of n children is encoded by enumeration
+     * @param n Number of children
+     * @return true if the enumeration is used
+     */
+    bool is_enumeration(size_t n) const {
+        return encoding == CardinalityEncoding::ENUMERATION || n < threshold;
+    }
+};
+
 /**
  * @class RelationEncoder
  * @brief Encodes feature model relations as CNF clauses
@@ -43,11 +134,19 @@
  * - Clauses: (~parent | child1 | ... | childN) [at least one]
  * - Plus: (~childi | ~childj) for all pairs [at most one]
  * - Plus: each child => parent
+ * - With set_at_most_one_policy(), large groups use a linear-size
+ *   at-most-one encoding instead of the pairwise clauses
  *
  * **CARDINALITY** (parent => min..max children):
  * - If parent is selected, between min and max children must be selected
  * - Uses enumeration approach with combinations
  * - Generates clauses enforcing min and max bounds
+ * - With set_cardinality_policy(), large groups use a counter encoding
+ *   with a polynomial number of clauses instead
+ *
+ * If the sink has native cardinality constraints (OPB, KNF), the "at most
+ * one" part of ALTERNATIVE groups and the bounds of CARDINALITY groups are
+ * emitted with ClauseSink::add_at_least() instead of being lowered to clauses.
  *
  * @see Relation for relation types and cardinality semantics
  * @see CNFModel for the CNF representation
@@ -66,8 +165,12 @@
  */
 class RelationEncoder {
 private:
-    CNFModel& cnf_model;  ///< Reference to the CNF model to add clauses to
-    CNFMode mode;         ///< CNF conversion mode (STRAIGHTFORWARD or TSEITIN)
+    CNFModel& cnf_model;            ///< Variable table (feature lookups and auxiliary variables)
+    ClauseSink& sink;               ///< Destination of the generated clauses
+    CNFMode mode;                   ///< CNF conversion mode (STRAIGHTFORWARD or TSEITIN)
+    AtMostOnePolicy amo_policy;     ///< Encoding of the "at most one child" constraints
+    CardinalityPolicy card_policy;  ///< Encoding of the count bounds of cardinality groups
+    GateCache* gate_cache;          ///< Gates shared across the conversion (nullptr = none)
 
 public:
     /**
@@ -78,6 +181,18 @@ public:
      */
     explicit RelationEncoder(CNFModel& model, CNFMode conversion_mode = CNFMode::STRAIGHTFORWARD);
 
+    /**
+     * @brief Constructs an encoder that writes clauses to a separate sink
+     *
+     * Variables are still looked up and created in the CNF model, but clauses
+     * go to the sink (e.g., a DimacsStreamWriter), so they need not be stored.
+     *
+     * @param model CNF model used as variable table
+     * @param clause_sink Destination of the generated clauses
+     * @param conversion_mode CNF mode: STRAIGHTFORWARD or TSEITIN (3-CNF)
+     */
+    RelationEncoder(CNFModel& model, ClauseSink& clause_sink, CNFMode conversion_mode);
+
     /**
      * @brief Destructor
      */
@@ -87,12 +202,61 @@ public:
      * @brief Encodes a relation into CNF clauses
      *
      * Determines the relation type and calls the appropriate encoding method.
-     * The generated clauses are added directly to the CNF model.
+     * The generated clauses are emitted directly to the clause sink.
      *
      * @param relation The relation to encode
      */
     void encode_relation(std::shared_ptr<Relation> relation);
 
+    /**
+     * @brief Sets how "at most one child" is encoded in ALTERNATIVE groups
+     * @param policy Encoding and size threshold (default: pairwise)
+     */
+    void set_at_most_one_policy(const AtMostOnePolicy& policy) { amo_policy = policy; }
+
+    /**
+     * @brief Emits the clauses allowing at most one of the literals to be true
+     *
+     * Uses the encoding chosen by the at-most-one policy for this number of
+     * literals; linear encodings recurse through this method on the smaller
+     * sets of auxiliaries they build (group commanders, grid rows, ...).
+     *
+     * @param literals Literals of which at most one may be true
+     */
+    void encode_at_most_one(const std::vector<int>& literals);
+
+    /**
+     * @brief Sets how the count bounds of CARDINALITY groups are encoded
+     * @param policy Encoding and size threshold (default: enumeration)
+     */
+    void set_cardinality_policy(const CardinalityPolicy& policy) { card_policy = policy; }
+
+    /**
+     * @brief Sets the cache through which OR-tree and AND gates are shared
+     *
+     * A gate over the same inputs as one defined earlier in the conversion
+     * (by this encoder or by a Tseitin constraint) reuses its auxiliary
+     * variable instead of defining a new one.
+     *
+     * @param gates Cache outliving the encoder, or nullptr to define every gate
+     */
+    void set_gate_cache(GateCache* gates) { gate_cache = gates; }
+
+    /**
+     * @brief Emits the clauses bounding the selected children of a selected parent
+     *
+     * A selected parent needs between max(card_min, 1) and card_max children
+     * (card_max < 0 stands for "*", i.e. all children), as the enumeration
+     * has always encoded it. The "child implies parent" clauses are not
+     * emitted here.
+     *
+     * @param parent_var Parent literal
+     * @param child_vars Child literals
+     * @param card_min Lower bound of the group
+     * @param card_max Upper bound of the group (negative for "*")
+     */
+    void encode_cardinality_bounds(int parent_var, const std::vector<int>& child_vars, int card_min, int card_max);
+
 private:
     /**
      * @brief Encodes a mandatory relation (parent <=> child)
@@ -151,18 +315,138 @@ private:
     void encode_cardinality(std::shared_ptr<Relation> relation);
 
     /**
-     * @brief Generates all combinations of k elements from n
+     * @brief Steps a combination to the next one in lexicographic order
      *
-     * Helper method for cardinality encoding. Generates C(n,k) combinations
-     * used to construct cardinality constraint clauses.
+     * Helper method for cardinality encoding. Starting from {0, 1, ..., k-1},
+     * repeated calls visit all C(n,k) combinations in place, without
+     * materializing them.
      *
+     * @param combo Increasing indices in [0, n), updated in place
      * @param n Total number of elements
-     * @param k Number of elements to choose
-     * @return Vector of all k-combinations (each combination is a vector of indices)
+     * @return false (leaving combo unspecified) if combo was the last combination
+     *
+     * Example: for n = 3, {0,1} → {0,2} → {1,2} → false
+     */
+    static bool next_combination(std::vector<int>& combo, int n);
+
+    /**
+     * @brief Encodes the count bounds by enumerating every subset of the children
+     *
+     * For each subset C, emits (¬parent ∨ ¬(exactly C)) if |C| is an invalid
+     * count and (parent ∨ ¬(exactly C)) otherwise; the empty subset always
+     * gets (¬parent ∨ x1 ∨ ... ∨ xn). Groups of up to 8 children take their
+     * subsets from a table built at compile time instead of stepping combinations.
+     *
+     * @param parent_var Parent literal
+     * @param child_vars Child literals
+     * @param lower Smallest valid count
+     * @param upper Largest valid count
+     */
+    void encode_enumeration(int parent_var, const std::vector<int>& child_vars, int lower, int upper);
+
+    /**
+     * @brief Emits (first_lit ∨ l_1 ∨ ... ∨ l_n) for one enumerated subset
+     *
+     * In the 3-CNF modes, longer clauses go through an OR tree.
+     *
+     * @param first_lit Parent literal of the clause
+     * @param literals Child literals of the subset
+     */
+    void add_exclusion_clause(int first_lit, const std::vector<int>& literals);
+
+    /**
+     * @brief Emits the count bounds of a group as native cardinality constraints
+     *
+     * Used instead of encode_cardinality_bounds() when the sink has native
+     * cardinality constraints. A lower bound above 1 is guarded by the
+     * parent, as a weighted literal or with auxiliary copies of the parent;
+     * the upper bound relies on the (¬child ∨ parent) clauses.
      *
-     * Example: generate_combinations(3, 2) returns {{0,1}, {0,2}, {1,2}}
+     * @param parent_var Parent literal
+     * @param child_vars Child literals
+     * @param card_min Lower bound of the group
+     * @param card_max Upper bound of the group (negative for "*")
      */
-    std::vector<std::vector<int>> generate_combinations(int n, int k);
+    void encode_native_cardinality(int parent_var, const std::vector<int>& child_vars, int card_min, int card_max);
+
+    /**
+     * @brief Emits "at most bound of the literals" as a native constraint
+     *
+     * @param literals Literals to bound
+     * @param bound Largest number of true literals
+     */
+    void add_native_at_most(const std::vector<int>& literals, int bound);
+
+    /**
+     * @brief Resolves AUTO to the counter encoding with the fewest literals
+     *
+     * The candidates are run into a ClauseCounter on placeholder literals.
+     *
+     * @param n Number of children
+     * @param bound Number of counter outputs needed
+     * @return SEQUENTIAL_COUNTER, TOTALIZER or SORTING_NETWORK
+     */
+    CardinalityEncoding choose_counter(size_t n, size_t bound);
+
+    /**
+     * @brief Builds the unary count of the literals with the given encoding
+     *
+     * @param encoding SEQUENTIAL_COUNTER, TOTALIZER or SORTING_NETWORK
+     * @param literals Literals to count
+     * @param bound Number of outputs needed
+     * @return Outputs o_1..o_m (m = min(n, bound)), o_k true iff at least k literals are
+     */
+    std::vector<int> build_counter(CardinalityEncoding encoding, const std::vector<int>& literals, size_t bound);
+
+    /**
+     * @brief Sequential counter over the literals
+     *
+     * Keeps the outputs s_{i,1..m} of the first i literals, with
+     * s_{i,k} = s_{i-1,k} ∨ (s_{i-1,k-1} ∧ x_i).
+     *
+     * @param literals Literals to count
+     * @param bound Number of outputs needed
+     * @return Outputs o_1..o_m
+     */
+    std::vector<int> build_sequential_counter(const std::vector<int>& literals, size_t bound);
+
+    /**
+     * @brief Totalizer over literals [first, last)
+     *
+     * Splits the range in halves and merges their unary counts with
+     * (¬a_i ∨ ¬b_j ∨ o_{i+j}) and (a_{i+1} ∨ b_{j+1} ∨ ¬o_{i+j+1}), which
+     * define each output in both directions.
+     *
+     * @param literals Literals to count
+     * @param first Index of the first literal of the range
+     * @param last Index past the last literal of the range
+     * @param bound Number of outputs needed
+     * @return Outputs o_1..o_m of the range
+     */
+    std::vector<int> build_totalizer(const std::vector<int>& literals, size_t first, size_t last, size_t bound);
+
+    /**
+     * @brief Odd-even merge sorting network over the literals
+     *
+     * Each comparator maps (a, b) to (a ∨ b, a ∧ b); the inputs are padded to
+     * a power of two with constant false wires, whose comparators are free.
+     *
+     * @param literals Literals to count
+     * @param bound Number of outputs needed
+     * @return Outputs o_1..o_m
+     */
+    std::vector<int> build_sorting_network(const std::vector<int>& literals, size_t bound);
+
+    /**
+     * @brief Gets a literal equivalent to a ∧ b
+     *
+     * Creates an auxiliary variable c with (¬c ∨ a), (¬c ∨ b) and (¬a ∨ ¬b ∨ c).
+     *
+     * @param a First literal
+     * @param b Second literal
+     * @return The AND literal
+     */
+    int define_and(int a, int b);
 
     /**
      * @brief Builds an OR tree with auxiliary variables for 3-CNF encoding
@@ -180,6 +464,88 @@ private:
      *   aux1 = (1 | 2), aux2 = (3 | 4), result = (aux1 | aux2)
      */
     int encode_or_tree(const std::vector<int>& vars);
+
+    /**
+     * @brief Builds an OR tree over the literals [first, last)
+     *
+     * @param first Pointer to the first literal (the range is non-empty)
+     * @param last Pointer past the last literal
+     * @return Literal representing the OR of the range
+     */
+    int encode_or_tree(const int* first, const int* last);
+
+    /**
+     * @brief Gets a literal equivalent to the OR of the given literals
+     *
+     * Returns the literal itself for a single input. Otherwise, in TSEITIN
+     * mode, builds an OR tree; in STRAIGHTFORWARD mode, creates one auxiliary
+     * variable a with (¬x ∨ a) for each input x and (¬a ∨ x1 ∨ ... ∨ xn).
+     *
+     * @param literals Non-empty list of literals
+     * @return Literal that is true exactly when one of the inputs is
+     */
+    int define_or(const std::vector<int>& literals);
+
+    /**
+     * @brief Pairwise at-most-one: (¬xi ∨ ¬xj) for every pair
+     * @param literals Literals of which at most one may be true
+     */
+    void encode_amo_pairwise(const std::vector<int>& literals);
+
+    /**
+     * @brief Sequential-counter at-most-one over prefix ORs
+     *
+     * p_1 = x_1 and p_i = p_{i-1} ∨ x_i (i < n), with (¬x_i ∨ ¬p_{i-1}) for
+     * every i > 1.
+     *
+     * @param literals Literals of which at most one may be true (n >= 3)
+     */
+    void encode_amo_sequential(const std::vector<int>& literals);
+
+    /**
+     * @brief Ladder at-most-one over suffix ORs
+     *
+     * y_n = x_n and, for i < n, an auxiliary y_i with the ladder clauses
+     * (¬y_{i+1} ∨ y_i) and the channelling clauses (¬x_i ∨ y_i),
+     * (¬x_i ∨ ¬y_{i+1}) and (¬y_i ∨ y_{i+1} ∨ x_i), which make y_i the OR of
+     * x_i..x_n.
+     *
+     * @param literals Literals of which at most one may be true (n >= 3)
+     */
+    void encode_amo_ladder(const std::vector<int>& literals);
+
+    /**
+     * @brief Commander at-most-one
+     *
+     * Splits the literals into groups of 3, encodes each group pairwise and
+     * recurses on the ORs (commanders) of the groups.
+     *
+     * @param literals Literals of which at most one may be true (n >= 3)
+     */
+    void encode_amo_commander(const std::vector<int>& literals);
+
+    /**
+     * @brief Bimander at-most-one
+     *
+     * Splits the literals into groups of 2 encoded pairwise, numbers the
+     * groups in binary, and defines bit t as the OR of the literals of the
+     * groups whose number has bit t set. Each literal excludes the bits its
+     * group number does not have, so two groups cannot both be selected.
+     *
+     * @param literals Literals of which at most one may be true (n >= 3)
+     */
+    void encode_amo_bimander(const std::vector<int>& literals);
+
+    /**
+     * @brief 2-product at-most-one
+     *
+     * Places the literals on a p × q grid (p = ⌈√n⌉), defines each row and
+     * column as the OR of its literals and recurses on the rows and on the
+     * columns.
+     *
+     * @param literals Literals of which at most one may be true (n >= 3)
+     */
+    void encode_amo_product(const std::vector<int>& literals);
 };
 
 #endif // RELATIONENCODER_H
@@ -0,0 +1,266 @@
+/**
+ * @file ResourceBudget.hh
+ * @brief Limits on the size, time and memory of a conversion
+ *
+ * This file defines the ResourceBudget class, the BudgetExceeded exception it
+ * throws, and the BudgetSink clause sink that charges emitted clauses to a
+ * budget.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef RESOURCEBUDGET_H
+#define RESOURCEBUDGET_H
+
+#include "ClauseSink.hh"
+#include "EncodingEstimator.hh"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @class BudgetExceeded
+ * @brief Thrown when a conversion exceeds one of its resource limits
+ *
+ * The message names the limit and the relation or constraint being encoded,
+ * e.g. "Resource limit exceeded in relation 'cardinality Root': predicted
+ * 1099511627776 clauses exceed the limit of 10000000".
+ */
+class BudgetExceeded : public std::runtime_error {
+public:
+    /**
+     * @brief Constructs the exception
+     * @param message Description of the exceeded limit
+     */
+    explicit BudgetExceeded(const std::string& message) : std::runtime_error(message) {}
+};
+
+/**
+ * @class ResourceBudget
+ * @brief Caps the clauses, literals, wall time and resident memory of a conversion
+ *
+ * Every limit is optional (0 = unlimited). FMToCNF uses the budget in two ways:
+ *
+ * - **Before** encoding a relation or constraint, reserve() compares its
+ *   size predicted by EncodingEstimator with the remaining clause and
+ *   literal budget, and the memory needed to expand it with the remaining
+ *   memory. Encodings that materialize their clauses first (distribution of
+ *   nested straightforward constraints) are thus rejected before any memory
+ *   is spent.
+ * - **While** clauses are emitted, BudgetSink charges them with charge(),
+ *   which enforces the clause and literal limits exactly and checks the
+ *   wall time and resident memory every CHECK_INTERVAL clauses.
+ *
+ * The prediction ignores structural simplification, so with it enabled a
+ * budget may reject a model whose simplified output would fit.
+ *
+ * Example:
+ * @code
+ * ResourceBudget budget;
+ * budget.set_max_clauses(10000000);
+ * budget.set_max_seconds(60);
+ * budget.start();
+ * FMToCNF transformer(feature_model);
+ * transformer.set_resource_budget(&budget);
+ * CNFModel cnf = transformer.transform(CNFMode::STRAIGHTFORWARD);  // may throw BudgetExceeded
+ * @endcode
+ */
+class ResourceBudget {
+public:
+    /// Number of charged clauses between two wall-time and memory checks
+    static constexpr uint64_t CHECK_INTERVAL = 4096;
+
+private:
+    uint64_t max_clauses;        ///< Clause limit (0 = unlimited)
+    uint64_t max_literals;       ///< Literal limit (0 = unlimited)
+    double max_seconds;          ///< Wall-time limit in seconds (0 = unlimited)
+    uint64_t max_rss;            ///< Resident memory limit in bytes (0 = unlimited)
+
+    uint64_t used_clauses;       ///< Clauses charged so far
+    uint64_t used_literals;      ///< Literals charged so far
+    uint64_t next_check;         ///< Clause count of the next time/memory check
+    std::chrono::steady_clock::time_point start_time;  ///< Start of the conversion
+    std::string context;         ///< Relation or constraint being encoded
+
+public:
+    /**
+     * @brief Constructs an unlimited budget started now
+     */
+    ResourceBudget();
+
+    /**
+     * @brief Sets the maximum number of clauses
+     * @param clauses Clause limit (0 = unlimited)
+     */
+    void set_max_clauses(uint64_t clauses) { max_clauses = clauses; }
+
+    /**
+     * @brief Sets the maximum number of literals
+     * @param literals Literal limit (0 = unlimited)
+     */
+    void set_max_literals(uint64_t literals) { max_literals = literals; }
+
+    /**
+     * @brief Sets the maximum wall time
+     * @param seconds Time limit measured from start() (0 = unlimited)
+     */
+    void set_max_seconds(double seconds) { max_seconds = seconds; }
+
+    /**
+     * @brief Sets the maximum resident memory of the process
+     * @param bytes Memory limit (0 = unlimited)
+     */
+    void set_max_rss(uint64_t bytes) { max_rss = bytes; }
+
+    /**
+     * @brief Checks whether any limit is set
+     * @return true if at least one limit is non-zero
+     */
+    bool is_limited() const {
+        return max_clauses != 0 || max_literals != 0 || max_seconds > 0 || max_rss != 0;
+    }
+
+    /**
+     * @brief Resets the counters and starts the wall-time clock
+     */
+    void start();
+
+    /**
+     * @brief Sets the relation or constraint named in error messages
+     * @param description Description, e.g. "relation 'or Engine'"
+     */
+    void set_context(const std::string& description) { context = description; }
+
+    /**
+     * @brief Checks that an encoding of the predicted size still fits
+     *
+     * Only encodings built in memory before being emitted (straightforward
+     * constraints) need memory for their expansion; the others are emitted
+     * clause by clause and only need the current memory to be within the limit.
+     *
+     * @param predicted Size predicted by EncodingEstimator
+     * @param materialized Whether the clauses are built in memory before being emitted
+     * @throws BudgetExceeded if a limit would be exceeded
+     */
+    void reserve(const EncodingCost& predicted, bool materialized);
+
+    /**
+     * @brief Charges an emitted clause
+     *
+     * @param literals Length of the clause
+     * @throws BudgetExceeded if a limit is exceeded
+     */
+    void charge(size_t literals) {
+        used_clauses++;
+        used_literals += literals;
+        if ((max_clauses != 0 && used_clauses > max_clauses) ||
+            (max_literals != 0 && used_literals > max_literals) ||
+            used_clauses >= next_check) {
+            check_usage();
+        }
+    }
+
+    /**
+     * @brief Checks the wall time and resident memory now
+     *
+     * @param description Step named in the error message
+     * @throws BudgetExceeded if a limit is exceeded
+     */
+    void check(const std::string& description);
+
+    /**
+     * @brief Gets the number of clauses charged so far
+     * @return Charged clauses
+     */
+    uint64_t get_used_clauses() const { return used_clauses; }
+
+    /**
+     * @brief Gets the number of literals charged so far
+     * @return Charged literals
+     */
+    uint64_t get_used_literals() const { return used_literals; }
+
+    /**
+     * @brief Gets the current resident memory of the process
+     * @return Bytes (0 if unavailable on this platform)
+     */
+    static uint64_t get_current_rss();
+
+private:
+    /**
+     * @brief Enforces all limits against the charged usage
+     *
+     * @throws BudgetExceeded if a limit is exceeded
+     */
+    void check_usage();
+
+    /**
+     * @brief Throws a BudgetExceeded naming the current context
+     *
+     * @param reason Description of the exceeded limit
+     */
+    [[noreturn]] void fail(const std::string& reason) const;
+};
+
+/**
+ * @class BudgetSink
+ * @brief Forwards clauses to another sink while charging them to a budget
+ */
+class BudgetSink : public ClauseSink {
+private:
+    ClauseSink& target;        ///< Sink receiving the clauses
+    ResourceBudget& budget;    ///< Budget charged per clause
+    size_t current_size;       ///< Length of the clause being written
+
+public:
+    /**
+     * @brief Constructs a sink forwarding to target
+     *
+     * @param target_sink Sink receiving the clauses
+     * @param resource_budget Budget charged for each clause
+     */
+    BudgetSink(ClauseSink& target_sink, ResourceBudget& resource_budget)
+        : target(target_sink), budget(resource_budget), current_size(0) {}
+
+    void begin_clause() override {
+        current_size = 0;
+        target.begin_clause();
+    }
+
+    void add_literal(int literal) override {
+        current_size++;
+        target.add_literal(literal);
+    }
+
+    void end_clause() override {
+        target.end_clause();
+        budget.charge(current_size);
+    }
+
+    void add_clause(const int* first, const int* last) override {
+        target.add_clause(first, last);
+        budget.charge(static_cast<size_t>(last - first));
+    }
+    using ClauseSink::add_clause;
+
+    bool has_native_cardinality() const override { return target.has_native_cardinality(); }
+
+    void add_at_least(int bound, const int* first, const int* last) override {
+        target.add_at_least(bound, first, last);
+        budget.charge(static_cast<size_t>(last - first));
+    }
+    using ClauseSink::add_at_least;
+
+    bool has_weighted_cardinality() const override { return target.has_weighted_cardinality(); }
+
+    void add_guarded_at_least(int guard, int bound, const int* first, const int* last) override {
+        target.add_guarded_at_least(guard, bound, first, last);
+        budget.charge(static_cast<size_t>(last - first) + 1);
+    }
+    using ClauseSink::add_guarded_at_least;
+};
+
+#endif // RESOURCEBUDGET_H
@@ -0,0 +1,135 @@
+/**
+ * @file SatPreprocessor.hh
+ * @brief CNF preprocessing with MiniSat's SimpSolver and blocked-clause elimination
+ *
+ * This file defines the SatPreprocessor class, which shrinks a generated
+ * formula before it is written while keeping every feature variable.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef SATPREPROCESSOR_H
+#define SATPREPROCESSOR_H
+
+#include "CNFModel.hh"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class SatPreprocessor
+ * @brief Removes auxiliary variables and redundant clauses from a CNF model
+ *
+ * The clauses are loaded into the bundled MiniSat SimpSolver
+ * (backbone_solver/src/minisat) with every feature variable frozen, and
+ * SimpSolver::eliminate() runs:
+ * - unit propagation at the top level
+ * - subsumption and self-subsuming resolution (clause strengthening)
+ * - bounded variable elimination of the non-frozen (auxiliary) variables
+ *
+ * The simplified clauses are then passed through blocked-clause elimination:
+ * a clause C is removed when it contains a literal l of an auxiliary variable
+ * such that every resolvent of C on l is a tautology. Any model of the
+ * remaining clauses can be repaired by flipping that auxiliary variable, so
+ * the feature projection is unchanged.
+ *
+ * Feature variables keep their IDs (they precede all auxiliary variables),
+ * features fixed by propagation are written as unit clauses, and auxiliary
+ * variables that no longer occur are dropped. The result is equisatisfiable
+ * and has exactly the same feature assignments as solutions; the remaining
+ * auxiliary variables may no longer be defined by the features, so model
+ * counters should project onto the feature variables.
+ *
+ * If MiniSat finds the formula unsatisfiable, the model is left unchanged and
+ * is_unsatisfiable() returns true.
+ *
+ * Example:
+ * @code
+ * CNFModel cnf = transformer.transform(CNFMode::TSEITIN);
+ * SatPreprocessor preprocessor;
+ * preprocessor.preprocess(cnf);
+ * std::cout << preprocessor.get_eliminated_variables() << " auxiliary variables eliminated\n";
+ * @endcode
+ */
+class SatPreprocessor {
+public:
+    /// Default bound on literal visits performed by blocked-clause elimination
+    static constexpr uint64_t DEFAULT_BLOCKED_CLAUSE_BUDGET = 50000000;
+
+private:
+    bool use_blocked_clauses;        ///< Whether blocked-clause elimination runs
+    uint64_t blocked_clause_budget;  ///< Maximum literal visits of blocked-clause elimination
+
+    size_t eliminated_variables;     ///< Auxiliary variables removed from the model
+    size_t removed_clauses;          ///< Net reduction of the number of clauses
+    size_t blocked_clauses;          ///< Clauses removed as blocked
+    bool unsatisfiable;              ///< Whether MiniSat found the formula unsatisfiable
+
+public:
+    /**
+     * @brief Constructs a preprocessor with blocked-clause elimination enabled
+     */
+    SatPreprocessor();
+
+    /**
+     * @brief Enables or disables blocked-clause elimination
+     * @param enabled false to only run MiniSat's simplification
+     */
+    void set_blocked_clause_elimination(bool enabled) { use_blocked_clauses = enabled; }
+
+    /**
+     * @brief Sets the work bound of blocked-clause elimination
+     * @param budget Number of literal visits allowed (0 disables it)
+     */
+    void set_blocked_clause_budget(uint64_t budget) { blocked_clause_budget = budget; }
+
+    /**
+     * @brief Preprocesses a CNF model in place
+     *
+     * Statistics of the previous call are reset.
+     *
+     * @param model CNF model whose clauses and auxiliary variables are rewritten
+     */
+    void preprocess(CNFModel& model);
+
+    /**
+     * @brief Gets the number of auxiliary variables removed from the model
+     * @return Eliminated auxiliary variables
+     */
+    size_t get_eliminated_variables() const { return eliminated_variables; }
+
+    /**
+     * @brief Gets the net reduction of the number of clauses
+     * @return Clauses before minus clauses after (0 if the formula grew)
+     */
+    size_t get_removed_clauses() const { return removed_clauses; }
+
+    /**
+     * @brief Gets the number of clauses removed as blocked
+     * @return Blocked clauses
+     */
+    size_t get_blocked_clauses() const { return blocked_clauses; }
+
+    /**
+     * @brief Checks whether the formula was found unsatisfiable
+     * @return true if the model was left unchanged because it has no solution
+     */
+    bool is_unsatisfiable() const { return unsatisfiable; }
+
+private:
+    /**
+     * @brief Removes blocked clauses on auxiliary literals
+     *
+     * @param clauses Clause database (original variable IDs)
+     * @param removed Per-clause removal flags (updated)
+     * @param frozen Per variable ID: 1 for feature variables
+     * @param num_variables Number of variables of the model
+     */
+    void eliminate_blocked_clauses(const std::vector<std::vector<int>>& clauses,
+                                   std::vector<char>& removed,
+                                   const std::vector<char>& frozen,
+                                   int num_variables);
+};
+
+#endif // SATPREPROCESSOR_H
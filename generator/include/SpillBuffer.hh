@@ -0,0 +1,267 @@
+/**
+ * @file SpillBuffer.hh
+ * @brief Append-only buffer that moves to a memory-mapped file when it grows large
+ *
+ * This file defines the MappedFile helper and the SpillBuffer template used by
+ * CNFModel for its clause arena, so that formulas larger than the available
+ * RAM are backed by a temporary file instead of anonymous memory.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef SPILLBUFFER_H
+#define SPILLBUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class MappedFile
+ * @brief Anonymous temporary file mapped into memory
+ *
+ * The file is created in $TMPDIR (or /tmp) on the first resize() and unlinked
+ * immediately, so it disappears when the mapping is released or the process
+ * exits. The mapping is shared, so the kernel can write dirty pages back to
+ * the file and evict them under memory pressure instead of failing.
+ */
+class MappedFile {
+private:
+    int fd;            ///< File descriptor (-1 before the first resize)
+    void* address;     ///< Start of the mapping (nullptr if none)
+    size_t length;     ///< Size of the file and of the mapping in bytes
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Grows or shrinks the file and maps it again
+     *
+     * The contents up to min(old size, new size) are preserved; the mapping
+     * address may change.
+     *
+     * @param bytes New size in bytes (must be > 0)
+     * @throws std::runtime_error if the file cannot be created, resized or mapped
+     */
+    void resize(size_t bytes);
+
+    /**
+     * @brief Gets the start of the mapping
+     * @return Mapped address, or nullptr before the first resize()
+     */
+    void* data() const { return address; }
+
+    /**
+     * @brief Gets the size of the mapping
+     * @return Size in bytes
+     */
+    size_t size() const { return length; }
+};
+
+/**
+ * @class SpillBuffer
+ * @brief Contiguous buffer of trivially copyable values with a memory limit
+ *
+ * Behaves like an append-only std::vector until its contents would exceed a
+ * threshold (in bytes). At that point, instead of reallocating, the contents
+ * are copied to a MappedFile and the heap memory is released; further values
+ * are appended to the mapped file, which grows geometrically. Because the
+ * storage stays contiguous, data() and raw pointers keep working (until the
+ * next append), so readers such as ClauseView and DimacsWriter are unaware
+ * of where the values live.
+ *
+ * A threshold of 0 (the default) disables spilling; the buffer is then a
+ * plain std::vector with no overhead besides one extra comparison when the
+ * vector is full.
+ *
+ * @tparam T Element type (must be trivially copyable)
+ */
+template <typename T>
+class SpillBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "SpillBuffer requires trivially copyable values");
+
+private:
+    std::vector<T> memory;              ///< Storage while not spilled
+    std::unique_ptr<MappedFile> file;   ///< Storage once spilled (nullptr before)
+    size_t count;                       ///< Number of values while spilled
+    size_t threshold;                   ///< Heap limit in bytes (0 = never spill)
+
+public:
+    SpillBuffer() : count(0), threshold(0) {}
+
+    SpillBuffer(const SpillBuffer& other) : count(0), threshold(other.threshold) {
+        append(other.data(), other.data() + other.size());
+    }
+
+    SpillBuffer(SpillBuffer&& other) noexcept = default;
+
+    SpillBuffer& operator=(const SpillBuffer& other) {
+        if (this != &other) {
+            SpillBuffer copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    SpillBuffer& operator=(SpillBuffer&& other) noexcept = default;
+
+    /**
+     * @brief Sets the heap limit
+     *
+     * Takes effect at the next append; a buffer that already spilled stays
+     * in its file.
+     *
+     * @param bytes Maximum heap size in bytes before spilling (0 = never spill)
+     */
+    void set_threshold(size_t bytes) { threshold = bytes; }
+
+    /**
+     * @brief Gets the heap limit
+     * @return Threshold in bytes (0 = never spill)
+     */
+    size_t get_threshold() const { return threshold; }
+
+    /**
+     * @brief Checks whether the values live in a mapped file
+     * @return true once the buffer has spilled
+     */
+    bool is_spilled() const { return file != nullptr; }
+
+    size_t size() const { return file ? count : memory.size(); }
+    bool empty() const { return size() == 0; }
+    T* data() { return file ? static_cast<T*>(file->data()) : memory.data(); }
+    const T* data() const { return file ? static_cast<const T*>(file->data()) : memory.data(); }
+    T& operator[](size_t i) { return data()[i]; }
+    const T& operator[](size_t i) const { return data()[i]; }
+    const T& back() const { return data()[size() - 1]; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+
+    /**
+     * @brief Appends one value
+     * @param value Value to append
+     */
+    void push_back(T value) {
+        if (file) {
+            ensure_mapped(count + 1);
+            static_cast<T*>(file->data())[count++] = value;
+            return;
+        }
+        if (memory.size() == memory.capacity() && exceeds_threshold(memory.size() + 1)) {
+            spill(memory.size() + 1);
+            push_back(value);
+            return;
+        }
+        memory.push_back(value);
+    }
+
+    /**
+     * @brief Appends a range of values
+     *
+     * @param first Pointer to the first value
+     * @param last Pointer one past the last value
+     */
+    void append(const T* first, const T* last) {
+        size_t n = static_cast<size_t>(last - first);
+        if (!file && exceeds_threshold(memory.size() + n) && memory.size() + n > memory.capacity()) {
+            spill(memory.size() + n);
+        }
+        if (file) {
+            ensure_mapped(count + n);
+            if (n > 0) {
+                std::memcpy(static_cast<T*>(file->data()) + count, first, n * sizeof(T));
+            }
+            count += n;
+            return;
+        }
+        memory.insert(memory.end(), first, last);
+    }
+
+    /**
+     * @brief Removes all values and releases the heap memory or mapped file
+     */
+    void clear() {
+        std::vector<T>().swap(memory);
+        file.reset();
+        count = 0;
+    }
+
+    /**
+     * @brief Reserves capacity, without exceeding the heap limit
+     * @param n Expected number of values
+     */
+    void reserve(size_t n) {
+        if (file) {
+            ensure_mapped(n);
+        } else if (threshold == 0) {
+            memory.reserve(n);
+        } else {
+            memory.reserve(std::min(n, threshold / sizeof(T)));
+        }
+    }
+
+    /**
+     * @brief Exchanges the contents with a vector
+     *
+     * If the buffer had spilled, its values are copied into the vector and the
+     * file is released. The new contents spill again if they exceed the limit.
+     *
+     * @param other Vector to exchange with
+     */
+    void swap(std::vector<T>& other) {
+        if (file) {
+            std::vector<T> spilled(data(), data() + count);
+            file.reset();
+            count = 0;
+            memory.swap(other);
+            other.swap(spilled);
+        } else {
+            memory.swap(other);
+        }
+        if (exceeds_threshold(memory.size())) {
+            spill(memory.size());
+        }
+    }
+
+private:
+    /**
+     * @brief Checks whether n values exceed the heap limit
+     */
+    bool exceeds_threshold(size_t n) const {
+        return threshold != 0 && n * sizeof(T) > threshold;
+    }
+
+    /**
+     * @brief Grows the mapped file geometrically to hold at least n values
+     */
+    void ensure_mapped(size_t n) {
+        size_t capacity = file->size() / sizeof(T);
+        if (n > capacity) {
+            file->resize(std::max(n, 2 * capacity) * sizeof(T));
+        }
+    }
+
+    /**
+     * @brief Moves the heap contents into a new mapped file
+     *
+     * @param n Number of values the file must be able to hold
+     */
+    void spill(size_t n) {
+        file.reset(new MappedFile());
+        file->resize(std::max(std::max(n, 2 * memory.size()), threshold / sizeof(T) + 1) * sizeof(T));
+        count = memory.size();
+        if (count > 0) {
+            std::memcpy(file->data(), memory.data(), count * sizeof(T));
+        }
+        std::vector<T>().swap(memory);
+    }
+};
+
+#endif // SPILLBUFFER_H
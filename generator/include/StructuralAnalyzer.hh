@@ -0,0 +1,182 @@
+/**
+ * @file StructuralAnalyzer.hh
+ * @brief Core and dead feature detection from the feature tree
+ *
+ * This file defines the StructuralAnalyzer class, which derives features that
+ * are selected in every configuration (core) or in none (dead) by propagating
+ * over the feature tree and simple cross-tree constraints, without SAT calls.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef STRUCTURALANALYZER_H
+#define STRUCTURALANALYZER_H
+
+#include "FeatureModel.hh"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @class StructuralAnalyzer
+ * @brief Finds core and dead features by linear-time propagation
+ *
+ * A large part of a model's backbone follows from the tree alone: the root
+ * and its mandatory closure are core, every feature below a dead feature is
+ * dead, and so on. The analyzer propagates these facts with a work queue:
+ *
+ * - **Root**: the root feature is core
+ * - **Upward**: a selected child selects its parent; a deselected parent
+ *   deselects all its children
+ * - **Groups**: every relation bounds the number of selected children when
+ *   the parent is selected (mandatory 1..1, optional 0..1, or 1..n,
+ *   alternative 1..1, cardinality as encoded by RelationEncoder). When the
+ *   children that can still be selected reach the lower bound they become
+ *   core; when the selected ones reach the upper bound the rest become dead;
+ *   when fewer than the lower bound can be selected the parent becomes dead
+ * - **Constraints**: small pure-boolean constraints (at most
+ *   MAX_CONSTRAINT_LITERALS feature references) are converted to clauses and
+ *   unit-propagated, which covers unit constraints and requires/excludes
+ *
+ * Every derived fact is implied by the CNF encoding of the model, so fixing
+ * the corresponding literals does not change the set of solutions. If both
+ * values are derived for some feature the model is void.
+ *
+ * @see FMToCNF::set_structural_simplification() for how the result is used
+ *
+ * Example:
+ * @code
+ * StructuralAnalyzer analyzer(feature_model);
+ * analyzer.analyze();
+ * for (const auto& name : analyzer.get_dead_features()) {
+ *     std::cout << "dead: " << name << std::endl;
+ * }
+ * @endcode
+ */
+class StructuralAnalyzer {
+public:
+    /**
+     * @enum State
+     * @brief Derived value of a feature
+     */
+    enum class State : int8_t {
+        DEAD = -1,      ///< Deselected in every configuration
+        UNKNOWN = 0,    ///< Not determined by structural propagation
+        CORE = 1        ///< Selected in every configuration
+    };
+
+    /// Constraints with more feature references than this are not analyzed
+    static constexpr int MAX_CONSTRAINT_LITERALS = 8;
+
+private:
+    /**
+     * @brief Relation in index form
+     */
+    struct Group {
+        int parent;                 ///< Parent feature index
+        std::vector<int> children;  ///< Child feature indices
+        int lower;                  ///< Minimum selected children when parent is selected
+        int upper;                  ///< Maximum selected children when parent is selected
+        int num_core;               ///< Children currently core
+        int num_dead;               ///< Children currently dead
+    };
+
+    std::shared_ptr<FeatureModel> source_model;         ///< Model to analyze
+    std::unordered_map<std::string, int> feature_index; ///< Feature name to index
+    std::vector<std::string> feature_names;             ///< Index to feature name
+    std::vector<State> states;                          ///< Derived value per feature
+    std::vector<Group> groups;                          ///< All relations
+    std::vector<std::vector<int>> parent_groups;        ///< Groups in which a feature is the parent
+    std::vector<std::vector<int>> child_groups;         ///< Groups in which a feature is a child
+    std::vector<std::vector<int>> clauses;              ///< Constraint clauses (literal = +/-(index + 1))
+    std::vector<std::vector<int>> clause_occurrences;   ///< Clauses per literal slot
+    std::vector<int> queue;                             ///< Features assigned but not yet propagated
+    bool conflict;                                      ///< Whether a feature got both values
+
+public:
+    /**
+     * @brief Constructs an analyzer for the given feature model
+     *
+     * @param model Shared pointer to the feature model to analyze
+     */
+    explicit StructuralAnalyzer(std::shared_ptr<FeatureModel> model);
+
+    /**
+     * @brief Runs the propagation
+     *
+     * Can be called again after the model changed; previous results are discarded.
+     */
+    void analyze();
+
+    /**
+     * @brief Gets the derived value of a feature
+     *
+     * @param name Feature name
+     * @return CORE, DEAD or UNKNOWN (also for names not in the model)
+     */
+    State get_state(const std::string& name) const;
+
+    /**
+     * @brief Gets the names of all core features
+     * @return Core features in depth-first order
+     */
+    std::vector<std::string> get_core_features() const;
+
+    /**
+     * @brief Gets the names of all dead features
+     * @return Dead features in depth-first order
+     */
+    std::vector<std::string> get_dead_features() const;
+
+    /**
+     * @brief Checks whether the model has no valid configuration
+     * @return true if propagation derived both values for some feature
+     */
+    bool is_void() const { return conflict; }
+
+private:
+    /**
+     * @brief Builds the index form of features, relations and constraints
+     */
+    void build();
+
+    /**
+     * @brief Converts small pure-boolean constraints into clauses
+     */
+    void build_constraint_clauses();
+
+    /**
+     * @brief Records a derived value and schedules its propagation
+     *
+     * @param feature Feature index
+     * @param value CORE or DEAD
+     */
+    void assign(int feature, State value);
+
+    /**
+     * @brief Applies the group bounds of a relation
+     *
+     * @param group Group index
+     */
+    void check_group(int group);
+
+    /**
+     * @brief Unit-propagates a constraint clause
+     *
+     * @param clause Clause index
+     */
+    void check_clause(int clause);
+
+    /**
+     * @brief Gets the value of a literal (+/-(index + 1)) under the current states
+     *
+     * @param literal Literal
+     * @return CORE if true, DEAD if false, UNKNOWN otherwise
+     */
+    State literal_value(int literal) const;
+};
+
+#endif // STRUCTURALANALYZER_H
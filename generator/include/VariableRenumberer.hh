@@ -0,0 +1,139 @@
+/**
+ * @file VariableRenumberer.hh
+ * @brief Variable renumbering strategies for solver locality
+ *
+ * This file defines the VariableRenumberer class and the RenumberStrategy
+ * enum. Renumbering changes only the variable IDs (and therefore the
+ * feature-name comments), never the formula itself.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#ifndef VARIABLERENUMBERER_H
+#define VARIABLERENUMBERER_H
+
+#include "CNFModel.hh"
+#include "FeatureModel.hh"
+#include <memory>
+#include <vector>
+
+/**
+ * @enum RenumberStrategy
+ * @brief Order in which variables receive their new IDs
+ */
+enum class RenumberStrategy {
+    NONE,                    ///< Keep the IDs assigned during transformation
+    TREE_BFS,                ///< Features in breadth-first tree order, auxiliaries after them
+    CUTHILL_MCKEE,           ///< Reverse Cuthill-McKee on the variable interaction graph
+    AUX_NEXT_TO_DEFINITION   ///< Features keep their order, each auxiliary follows its inputs
+};
+
+/**
+ * @class VariableRenumberer
+ * @brief Permutes the variable IDs of a CNF model
+ *
+ * Variable IDs are assigned in FeatureModel::get_features() preorder and
+ * auxiliary variables are appended in creation order, so literals that occur
+ * together in clauses can be far apart in the ID space. CDCL solvers keep
+ * per-variable data (watch lists, activity heap, assignment trail) in arrays
+ * indexed by ID, so clustering related variables improves cache behaviour.
+ *
+ * Strategies:
+ * - **TREE_BFS**: features are numbered level by level from the root, so
+ *   siblings (which share group clauses) get consecutive IDs
+ * - **CUTHILL_MCKEE**: reverse Cuthill-McKee ordering of the graph where two
+ *   variables are adjacent if they share a clause (clauses longer than
+ *   MAX_CLIQUE_CLAUSE only link consecutive literals). Each connected
+ *   component starts from a pseudo-peripheral vertex; the result minimizes
+ *   the bandwidth, i.e. the ID span of clauses
+ * - **AUX_NEXT_TO_DEFINITION**: features keep their IDs' relative order and
+ *   each auxiliary variable is placed right after the latest input of its
+ *   defining clauses (the first clause it appears in)
+ *
+ * The formula and its solutions are unchanged; CNFModel::remap_variables()
+ * rewrites the clauses and keeps the feature-name mapping consistent.
+ *
+ * Example:
+ * @code
+ * VariableRenumberer renumberer(RenumberStrategy::CUTHILL_MCKEE);
+ * renumberer.renumber(cnf, feature_model);
+ * std::cout << renumberer.get_bandwidth_before() << " -> "
+ *           << renumberer.get_bandwidth_after() << std::endl;
+ * @endcode
+ */
+class VariableRenumberer {
+public:
+    /// Clauses up to this length add all literal pairs to the interaction graph
+    static constexpr size_t MAX_CLIQUE_CLAUSE = 16;
+
+private:
+    RenumberStrategy strategy;   ///< Selected ordering
+    int bandwidth_before;        ///< Largest clause ID span before renumbering
+    int bandwidth_after;         ///< Largest clause ID span after renumbering
+
+public:
+    /**
+     * @brief Constructs a renumberer for the given strategy
+     *
+     * @param renumber_strategy Ordering to apply
+     */
+    explicit VariableRenumberer(RenumberStrategy renumber_strategy);
+
+    /**
+     * @brief Renumbers the variables of a CNF model
+     *
+     * @param model CNF model to renumber in place
+     * @param feature_model Feature tree (only used by TREE_BFS; may be null otherwise)
+     * @throws std::invalid_argument if TREE_BFS is requested without a feature model
+     */
+    void renumber(CNFModel& model, std::shared_ptr<FeatureModel> feature_model = nullptr);
+
+    /**
+     * @brief Gets the bandwidth before the last renumbering
+     * @return Largest difference between variable IDs within one clause
+     */
+    int get_bandwidth_before() const { return bandwidth_before; }
+
+    /**
+     * @brief Gets the bandwidth after the last renumbering
+     * @return Largest difference between variable IDs within one clause
+     */
+    int get_bandwidth_after() const { return bandwidth_after; }
+
+    /**
+     * @brief Computes the bandwidth of a CNF model
+     *
+     * @param model CNF model
+     * @return Largest difference between variable IDs within one clause
+     */
+    static int compute_bandwidth(const CNFModel& model);
+
+private:
+    /**
+     * @brief Features in breadth-first tree order, then auxiliaries
+     *
+     * @param model CNF model
+     * @param feature_model Feature tree
+     * @return Old variable IDs in their new order
+     */
+    std::vector<int> order_tree_bfs(const CNFModel& model, const FeatureModel& feature_model) const;
+
+    /**
+     * @brief Reverse Cuthill-McKee order of the variable interaction graph
+     *
+     * @param model CNF model
+     * @return Old variable IDs in their new order
+     */
+    std::vector<int> order_cuthill_mckee(const CNFModel& model) const;
+
+    /**
+     * @brief Features in current order, each auxiliary after its latest input
+     *
+     * @param model CNF model
+     * @return Old variable IDs in their new order
+     */
+    std::vector<int> order_aux_next_to_definition(const CNFModel& model) const;
+};
+
+#endif // VARIABLERENUMBERER_H
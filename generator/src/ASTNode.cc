@@ -17,6 +17,50 @@
 #include "ASTNode.hh"
 #include <stdexcept>
 #include <sstream>
+#include <utility>
+
+namespace {
+    /**
+     * @brief Sink that collects clauses into vectors
+     *
+     * Backs the vector-returning ASTNode::get_clauses() overload.
+     */
+    class ClauseCollector : public ClauseSink {
+    public:
+        std::vector<std::vector<int>> clauses;  ///< Collected clauses
+
+        void begin_clause() override { clauses.emplace_back(); }
+        void add_literal(int literal) override { clauses.back().push_back(literal); }
+        void end_clause() override {}
+        void add_clause(const int* first, const int* last) override { clauses.emplace_back(first, last); }
+        using ClauseSink::add_clause;
+    };
+
+    /**
+     * @brief Polarity of an operand under a negation
+     */
+    ASTNode::Polarity flip(ASTNode::Polarity polarity) {
+        switch (polarity) {
+            case ASTNode::Polarity::POSITIVE: return ASTNode::Polarity::NEGATIVE;
+            case ASTNode::Polarity::NEGATIVE: return ASTNode::Polarity::POSITIVE;
+            default: return ASTNode::Polarity::BOTH;
+        }
+    }
+
+    /**
+     * @brief Whether a gate needs its "gate → operation" clauses
+     */
+    inline bool needs_positive(ASTNode::Polarity polarity) {
+        return polarity != ASTNode::Polarity::NEGATIVE;
+    }
+
+    /**
+     * @brief Whether a gate needs its "operation → gate" clauses
+     */
+    inline bool needs_negative(ASTNode::Polarity polarity) {
+        return polarity != ASTNode::Polarity::POSITIVE;
+    }
+}
 
 /**
  * @brief Constructs a binary operation node
@@ -260,7 +304,7 @@ std::string ASTNode::to_string() const {
  *
  * **Tseitin Mode**:
  * - Uses Tseitin transformation
- * - Creates auxiliary variables for each operation
+ * - Creates auxiliary variables for nested AND/OR chains and equivalences
  * - Results in linear-size CNF with shorter clauses (max 3 literals)
  * - More variables but often faster for SAT solvers
  *
@@ -274,47 +318,204 @@ std::vector<std::vector<int>> ASTNode::get_clauses(
     std::function<int()> create_aux_var,
     CNFMode mode
 ) const {
-    if (mode == CNFMode::TSEITIN) {
+    ClauseCollector collector;
+    get_clauses(collector, get_variable, create_aux_var, mode);
+    return std::move(collector.clauses);
+}
+
+/**
+ * @brief Converts AST to CNF clauses emitted to a sink
+ *
+ * In Tseitin mode the gate definitions are emitted while the tree is
+ * traversed, followed by the clauses asserting the root. In
+ * straightforward mode the distributed clauses are computed first and then
+ * emitted in order.
+ *
+ * In Plaisted-Greenbaum mode the root is asserted, so it occurs positively
+ * and each gate only gets the direction its polarity needs.
+ *
+ * @param sink Destination of the generated clauses
+ * @param get_variable Function to map feature names to variable IDs
+ * @param create_aux_var Function to create new auxiliary variables (Tseitin mode)
+ * @param mode Conversion mode (STRAIGHTFORWARD, TSEITIN or PLAISTED_GREENBAUM)
+ * @param gates Gates shared with the rest of the conversion (Tseitin mode, optional)
+ */
+void ASTNode::get_clauses(
+    ClauseSink& sink,
+    std::function<int(const std::string&)> get_variable,
+    std::function<int()> create_aux_var,
+    CNFMode mode,
+    GateCache* gates
+) const {
+    if (is_three_cnf(mode)) {
         // Use Tseitin transformation with auxiliary variables
-        std::vector<std::vector<int>> clauses;
-        int root_var = tseitin_transform(clauses, get_variable, create_aux_var);
-        // The root expression must be true
-        clauses.push_back({root_var});
-        return clauses;
+        Polarity polarity = mode == CNFMode::PLAISTED_GREENBAUM ? Polarity::POSITIVE : Polarity::BOTH;
+        tseitin_assert(sink, get_variable, create_aux_var, polarity, gates);
     } else {
         // Use straightforward conversion without auxiliary variables
         // Step 1: Convert to NNF
         auto nnf = to_nnf(false);  // false = not negated
         // Step 2: Convert NNF to CNF
-        return nnf->to_cnf_direct(get_variable);
+        for (const auto& clause : nnf->to_cnf_direct(get_variable)) {
+            sink.add_clause(clause);
+        }
     }
 }
 
 /**
- * @brief Performs Tseitin transformation on AST
+ * @brief Asserts this AST in Tseitin mode
+ *
+ * The root is split into its flattened conjuncts, and each conjunct is
+ * emitted as one clause over its flattened disjuncts, so only nested
+ * subexpressions need gates. A conjunct that is an equivalence is emitted
+ * as its two implications. A clause longer than 3 literals keeps its first
+ * two literals and replaces the rest with an OR gate.
+ *
+ * @param sink Destination of the generated clauses
+ * @param get_variable Function to map feature names to variable IDs
+ * @param create_aux_var Function to create new auxiliary variables
+ * @param polarity POSITIVE for Plaisted-Greenbaum, BOTH for plain Tseitin
+ * @param gates Shared gates (nullptr: every gate is defined anew)
+ */
+void ASTNode::tseitin_assert(
+    ClauseSink& sink,
+    std::function<int(const std::string&)> get_variable,
+    std::function<int()> create_aux_var,
+    Polarity polarity,
+    GateCache* gates
+) const {
+    std::vector<Operand> conjuncts;
+    collect_operands(ASTOperation::AND, false, conjuncts);
+
+    for (const auto& conjunct : conjuncts) {
+        std::vector<Operand> disjuncts;
+        conjunct.first->collect_operands(ASTOperation::OR, conjunct.second, disjuncts);
+
+        const ASTNode* single = disjuncts.size() == 1 ? disjuncts[0].first : nullptr;
+        if (single && single->type == Type::OPERATION && single->operation == ASTOperation::EQUIVALENCE) {
+            if (single->children.size() != 2) {
+                throw std::runtime_error("EQUIVALENCE operation must have exactly 2 children");
+            }
+            int left = single->children[0]->tseitin_transform(sink, get_variable, create_aux_var,
+                                                              Polarity::BOTH, gates);
+            int right = single->children[1]->tseitin_transform(sink, get_variable, create_aux_var,
+                                                               Polarity::BOTH, gates);
+            // (left <=> right), or its negation (left xor right)
+            int sign = disjuncts[0].second ? -1 : 1;
+            sink.add_clause({-left, sign * right});
+            sink.add_clause({left, -sign * right});
+            continue;
+        }
+
+        std::vector<int> clause = tseitin_operands(disjuncts, sink, get_variable, create_aux_var, polarity, gates);
+        if (clause.size() > 3) {
+            int rest = add_gate(GateType::OR, clause, 2, clause.size(), sink, create_aux_var, polarity, gates);
+            clause.resize(2);
+            clause.push_back(rest);
+        }
+        sink.add_clause(clause);
+    }
+}
+
+/**
+ * @brief Flattens an associative chain into its operands
+ *
+ * Negations are folded into the operand signs, and De Morgan's laws and
+ * (A => B) = (!A | B) are applied, so e.g. !(A | B) & C yields the AND
+ * operands !A, !B and C. Subtrees of any other kind become single operands.
+ *
+ * @param op AND or OR, the chain to flatten
+ * @param negated Whether this subtree occurs negated
+ * @param operands Receives (node, negated) pairs, left to right
+ */
+void ASTNode::collect_operands(ASTOperation op, bool negated, std::vector<Operand>& operands) const {
+    if (type == Type::OPERATION && operation == ASTOperation::NOT) {
+        if (children.size() != 1) {
+            throw std::runtime_error("NOT operation must have exactly 1 child");
+        }
+        children[0]->collect_operands(op, !negated, operands);
+        return;
+    }
+
+    bool disjunctive = type == Type::OPERATION &&
+        (operation == ASTOperation::OR || operation == ASTOperation::IMPLIES);
+    bool conjunctive = type == Type::OPERATION && operation == ASTOperation::AND;
+    // A negated chain becomes the dual chain
+    bool matches = (op == ASTOperation::AND) == (negated ? disjunctive : conjunctive);
+    if ((conjunctive || disjunctive) && matches) {
+        if (children.size() != 2) {
+            throw std::runtime_error("Binary operation must have exactly 2 children");
+        }
+        bool antecedent = operation == ASTOperation::IMPLIES;
+        children[0]->collect_operands(op, antecedent ? !negated : negated, operands);
+        children[1]->collect_operands(op, negated, operands);
+        return;
+    }
+
+    operands.emplace_back(this, negated);
+}
+
+/**
+ * @brief Transforms flattened operands to literals
+ *
+ * A negated operand occurs with the opposite polarity.
  *
- * Recursively transforms the AST into CNF using the Tseitin encoding.
- * For each operation node, creates an auxiliary variable and adds clauses
- * expressing the equivalence between the auxiliary variable and the operation result.
+ * @param operands Operands from collect_operands()
+ * @param sink Destination of the generated clauses
+ * @param get_variable Function to map feature names to variable IDs
+ * @param create_aux_var Function to create new auxiliary variables
+ * @param polarity Occurrences of the operand list
+ * @param gates Shared gates (nullptr: every gate is defined anew)
+ * @return One literal per operand
+ */
+std::vector<int> ASTNode::tseitin_operands(
+    const std::vector<Operand>& operands,
+    ClauseSink& sink,
+    std::function<int(const std::string&)> get_variable,
+    std::function<int()> create_aux_var,
+    Polarity polarity,
+    GateCache* gates
+) {
+    std::vector<int> literals;
+    literals.reserve(operands.size());
+    for (const auto& operand : operands) {
+        Polarity occurrence = operand.second ? flip(polarity) : polarity;
+        int literal = operand.first->tseitin_transform(sink, get_variable, create_aux_var, occurrence, gates);
+        literals.push_back(operand.second ? -literal : literal);
+    }
+    return literals;
+}
+
+/**
+ * @brief Performs Tseitin transformation on AST
  *
- * The transformation guarantees linear-size output and clauses with at most 3 literals.
+ * Recursively transforms the AST into CNF using the Tseitin encoding and
+ * returns the literal standing for this subtree:
  *
- * For each operator:
- * - NOT: result ⟺ ¬child
- * - AND: result ⟺ (left ∧ right)
- * - OR: result ⟺ (left ∨ right)
- * - IMPLIES: result ⟺ (left → right)
+ * - Feature: its variable
+ * - NOT: the negated literal of the child (no auxiliary variable)
+ * - AND, OR, IMPLIES: one n-ary gate over the flattened chain (see
+ *   collect_operands()), split only where a clause would exceed 3 literals
  * - EQUIVALENCE: result ⟺ (left ⟺ right)
  *
- * @param clauses Output vector to append generated clauses to
+ * With a polarity other than BOTH, only the clauses of the direction the
+ * gate occurs in are added (Plaisted-Greenbaum). Operands keep the polarity
+ * of AND and OR, a NOT and the antecedent of an IMPLIES flip it, and the
+ * operands of an EQUIVALENCE occur in both.
+ *
+ * @param sink Destination of the generated clauses
  * @param get_variable Function to map feature names to variable IDs
  * @param create_aux_var Function to create new auxiliary variables
- * @return Variable ID representing the result of this subtree
+ * @param polarity Occurrences of this subtree (BOTH for plain Tseitin)
+ * @param gates Shared gates (nullptr: every gate is defined anew)
+ * @return Literal representing the result of this subtree
  */
 int ASTNode::tseitin_transform(
-    std::vector<std::vector<int>>& clauses,
+    ClauseSink& sink,
     std::function<int(const std::string&)> get_variable,
-    std::function<int()> create_aux_var
+    std::function<int()> create_aux_var,
+    Polarity polarity,
+    GateCache* gates
 ) const {
     // Base case: literal
     if (type == Type::LITERAL) {
@@ -334,53 +535,38 @@ int ASTNode::tseitin_transform(
             if (children.size() != 1) {
                 throw std::runtime_error("NOT operation must have exactly 1 child");
             }
-            int child_var = children[0]->tseitin_transform(clauses, get_variable, create_aux_var);
-            int result_var = create_aux_var();
-            add_not_clauses(result_var, child_var, clauses);
-            return result_var;
-        }
-
-        case ASTOperation::AND: {
-            if (children.size() != 2) {
-                throw std::runtime_error("AND operation must have exactly 2 children");
-            }
-            int left_var = children[0]->tseitin_transform(clauses, get_variable, create_aux_var);
-            int right_var = children[1]->tseitin_transform(clauses, get_variable, create_aux_var);
-            int result_var = create_aux_var();
-            add_and_clauses(result_var, left_var, right_var, clauses);
-            return result_var;
-        }
-
-        case ASTOperation::OR: {
-            if (children.size() != 2) {
-                throw std::runtime_error("OR operation must have exactly 2 children");
-            }
-            int left_var = children[0]->tseitin_transform(clauses, get_variable, create_aux_var);
-            int right_var = children[1]->tseitin_transform(clauses, get_variable, create_aux_var);
-            int result_var = create_aux_var();
-            add_or_clauses(result_var, left_var, right_var, clauses);
-            return result_var;
+            return -children[0]->tseitin_transform(sink, get_variable, create_aux_var, flip(polarity), gates);
         }
 
+        case ASTOperation::AND:
+        case ASTOperation::OR:
         case ASTOperation::IMPLIES: {
-            if (children.size() != 2) {
-                throw std::runtime_error("IMPLIES operation must have exactly 2 children");
-            }
-            int left_var = children[0]->tseitin_transform(clauses, get_variable, create_aux_var);
-            int right_var = children[1]->tseitin_transform(clauses, get_variable, create_aux_var);
-            int result_var = create_aux_var();
-            add_implies_clauses(result_var, left_var, right_var, clauses);
-            return result_var;
+            bool is_and = operation == ASTOperation::AND;
+            std::vector<Operand> operands;
+            collect_operands(is_and ? ASTOperation::AND : ASTOperation::OR, false, operands);
+            std::vector<int> inputs = tseitin_operands(operands, sink, get_variable, create_aux_var, polarity, gates);
+            return add_gate(is_and ? GateType::AND : GateType::OR, inputs, 0, inputs.size(), sink, create_aux_var,
+                            polarity, gates);
         }
 
         case ASTOperation::EQUIVALENCE: {
             if (children.size() != 2) {
                 throw std::runtime_error("EQUIVALENCE operation must have exactly 2 children");
             }
-            int left_var = children[0]->tseitin_transform(clauses, get_variable, create_aux_var);
-            int right_var = children[1]->tseitin_transform(clauses, get_variable, create_aux_var);
-            int result_var = create_aux_var();
-            add_equivalence_clauses(result_var, left_var, right_var, clauses);
+            int inputs[2] = {
+                children[0]->tseitin_transform(sink, get_variable, create_aux_var, Polarity::BOTH, gates),
+                children[1]->tseitin_transform(sink, get_variable, create_aux_var, Polarity::BOTH, gates)
+            };
+            bool positive = needs_positive(polarity);
+            bool negative = needs_negative(polarity);
+            int result_var = gates ? gates->find(GateType::EQUIVALENCE, inputs, inputs + 2, positive, negative) : 0;
+            if (result_var == 0) {
+                result_var = create_aux_var();
+                add_equivalence_clauses(result_var, inputs[0], inputs[1], sink, polarity);
+                if (gates) {
+                    gates->insert(GateType::EQUIVALENCE, inputs, inputs + 2, positive, negative, result_var);
+                }
+            }
             return result_var;
         }
 
@@ -390,85 +576,93 @@ int ASTNode::tseitin_transform(
 }
 
 /**
- * @brief Adds Tseitin clauses for NOT operation
- *
- * Encodes: result ⟺ ¬child
- *
- * Generated clauses:
- * 1. (result ∨ child) - if result is true, child must be false
- * 2. (¬result ∨ ¬child) - if child is true, result must be false
- *
- * @param result Variable ID representing the NOT result
- * @param child_var Variable ID of the operand
- * @param clauses Output vector to append clauses to
+ * @brief Adds an n-ary AND or OR gate over a range of literals
+ *
+ * Encodes result ⟺ AND/OR(inputs[first..last)):
+ * - AND: (¬result ∨ input) per input [positive], (result ∨ ¬input...) [negative]
+ * - OR: (¬result ∨ input...) [positive], (result ∨ ¬input) per input [negative]
+ *
+ * When the long clause is needed and would exceed 3 literals, the range is
+ * split in half and the halves are combined by a binary gate. A single
+ * input is returned as it is. With a gate cache, a gate (or split gate)
+ * over the same inputs that was defined before is reused.
+ *
+ * @param type AND or OR
+ * @param inputs Input literals
+ * @param first Index of the first input
+ * @param last Index past the last input
+ * @param sink Destination of the generated clauses
+ * @param create_aux_var Function to create new auxiliary variables
+ * @param polarity Which of the clauses are needed
+ * @param gates Shared gates (nullptr: every gate is defined anew)
+ * @return Literal representing the gate
  */
-void ASTNode::add_not_clauses(int result, int child_var, std::vector<std::vector<int>>& clauses) const {
-    clauses.push_back({result, child_var});
-    clauses.push_back({-result, -child_var});
-}
+int ASTNode::add_gate(
+    GateType type,
+    const std::vector<int>& inputs,
+    size_t first,
+    size_t last,
+    ClauseSink& sink,
+    const std::function<int()>& create_aux_var,
+    Polarity polarity,
+    GateCache* gates
+) {
+    size_t count = last - first;
+    if (count == 1) {
+        return inputs[first];
+    }
 
-/**
- * @brief Adds Tseitin clauses for AND operation
- *
- * Encodes: result ⟺ (left ∧ right)
- *
- * Generated clauses:
- * 1. (¬result ∨ left) - if result is true, left must be true
- * 2. (¬result ∨ right) - if result is true, right must be true
- * 3. (result ∨ ¬left ∨ ¬right) - if both are true, result must be true
- *
- * @param result Variable ID representing the AND result
- * @param left_var Variable ID of left operand
- * @param right_var Variable ID of right operand
- * @param clauses Output vector to append clauses to
- */
-void ASTNode::add_and_clauses(int result, int left_var, int right_var, std::vector<std::vector<int>>& clauses) const {
-    clauses.push_back({-result, left_var});
-    clauses.push_back({-result, right_var});
-    clauses.push_back({result, -left_var, -right_var});
-}
+    bool positive = needs_positive(polarity);
+    bool negative = needs_negative(polarity);
+    const int* range = inputs.data() + first;
+    if (gates) {
+        int found = gates->find(type, range, range + count, positive, negative);
+        if (found != 0) {
+            return found;
+        }
+    }
 
-/**
- * @brief Adds Tseitin clauses for OR operation
- *
- * Encodes: result ⟺ (left ∨ right)
- *
- * Generated clauses:
- * 1. (¬result ∨ left ∨ right) - if result is true, at least one must be true
- * 2. (result ∨ ¬left) - if left is true, result must be true
- * 3. (result ∨ ¬right) - if right is true, result must be true
- *
- * @param result Variable ID representing the OR result
- * @param left_var Variable ID of left operand
- * @param right_var Variable ID of right operand
- * @param clauses Output vector to append clauses to
- */
-void ASTNode::add_or_clauses(int result, int left_var, int right_var, std::vector<std::vector<int>>& clauses) const {
-    clauses.push_back({-result, left_var, right_var});
-    clauses.push_back({result, -left_var});
-    clauses.push_back({result, -right_var});
-}
+    bool is_and = type == GateType::AND;
+    int result;
+    if ((is_and ? negative : positive) && count > 2) {
+        size_t mid = first + count / 2;
+        std::vector<int> halves = {
+            add_gate(type, inputs, first, mid, sink, create_aux_var, polarity, gates),
+            add_gate(type, inputs, mid, last, sink, create_aux_var, polarity, gates)
+        };
+        result = add_gate(type, halves, 0, 2, sink, create_aux_var, polarity, gates);
+    } else {
+        result = create_aux_var();
+        if (positive) {
+            if (is_and) {
+                for (size_t i = first; i < last; ++i) {
+                    sink.add_clause({-result, inputs[i]});
+                }
+            } else {
+                std::vector<int> clause = {-result};
+                clause.insert(clause.end(), inputs.begin() + first, inputs.begin() + last);
+                sink.add_clause(clause);
+            }
+        }
+        if (negative) {
+            if (is_and) {
+                std::vector<int> clause = {result};
+                for (size_t i = first; i < last; ++i) {
+                    clause.push_back(-inputs[i]);
+                }
+                sink.add_clause(clause);
+            } else {
+                for (size_t i = first; i < last; ++i) {
+                    sink.add_clause({result, -inputs[i]});
+                }
+            }
+        }
+    }
 
-/**
- * @brief Adds Tseitin clauses for IMPLIES operation
- *
- * Encodes: result ⟺ (left → right)
- * Equivalent to: result ⟺ (¬left ∨ right)
- *
- * Generated clauses:
- * 1. (¬result ∨ ¬left ∨ right) - if result is true, implication holds
- * 2. (result ∨ left) - if left is false, result can be true
- * 3. (result ∨ ¬right) - if right is false, result can be true
- *
- * @param result Variable ID representing the IMPLIES result
- * @param left_var Variable ID of left operand (antecedent)
- * @param right_var Variable ID of right operand (consequent)
- * @param clauses Output vector to append clauses to
- */
-void ASTNode::add_implies_clauses(int result, int left_var, int right_var, std::vector<std::vector<int>>& clauses) const {
-    clauses.push_back({-result, -left_var, right_var});
-    clauses.push_back({result, left_var});
-    clauses.push_back({result, -right_var});
+    if (gates) {
+        gates->insert(type, inputs.data() + first, inputs.data() + last, positive, negative, result);
+    }
+    return result;
 }
 
 /**
@@ -478,21 +672,27 @@ void ASTNode::add_implies_clauses(int result, int left_var, int right_var, std::
  * Equivalent to: result ⟺ ((left ∧ right) ∨ (¬left ∧ ¬right))
  *
  * Generated clauses:
- * 1. (¬result ∨ left ∨ ¬right) - covers case where both are same
- * 2. (¬result ∨ ¬left ∨ right) - covers case where both are same
- * 3. (result ∨ left ∨ right) - if different, result is false
- * 4. (result ∨ ¬left ∨ ¬right) - if different, result is false
+ * 1. (¬result ∨ left ∨ ¬right) - covers case where both are same [positive]
+ * 2. (¬result ∨ ¬left ∨ right) - covers case where both are same [positive]
+ * 3. (result ∨ left ∨ right) - if different, result is false [negative]
+ * 4. (result ∨ ¬left ∨ ¬right) - if different, result is false [negative]
  *
  * @param result Variable ID representing the EQUIVALENCE result
  * @param left_var Variable ID of left operand
  * @param right_var Variable ID of right operand
- * @param clauses Output vector to append clauses to
+ * @param sink Destination of the generated clauses
+ * @param polarity Which of the clauses are needed
  */
-void ASTNode::add_equivalence_clauses(int result, int left_var, int right_var, std::vector<std::vector<int>>& clauses) const {
-    clauses.push_back({-result, left_var, -right_var});
-    clauses.push_back({-result, -left_var, right_var});
-    clauses.push_back({result, left_var, right_var});
-    clauses.push_back({result, -left_var, -right_var});
+void ASTNode::add_equivalence_clauses(int result, int left_var, int right_var, ClauseSink& sink,
+                                      Polarity polarity) const {
+    if (needs_positive(polarity)) {
+        sink.add_clause({-result, left_var, -right_var});
+        sink.add_clause({-result, -left_var, right_var});
+    }
+    if (needs_negative(polarity)) {
+        sink.add_clause({result, left_var, right_var});
+        sink.add_clause({result, -left_var, -right_var});
+    }
 }
 
 // ===== Straightforward CNF Conversion (No Auxiliary Variables) =====
@@ -5,8 +5,8 @@
  * This file implements the CNFModel class which represents a boolean formula
  * in CNF format. It manages:
  * - Feature variables (mapped from feature names)
- * - Auxiliary variables (created during Tseitin transformation)
- * - CNF clauses (vectors of literals)
+ * - Auxiliary variables (created during Tseitin transformation, named lazily)
+ * - CNF clauses (a flat literal arena indexed by clause offsets)
  *
  * The model assigns unique integer IDs to variables and stores clauses
  * for output in DIMACS format.
@@ -18,6 +18,10 @@
 #include "CNFModel.hh"
 #include <stdexcept>
 #include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
 
 /**
  * @brief Constructs an empty CNF model
@@ -26,7 +30,10 @@
  * Variable 0 is reserved as the clause terminator in DIMACS format.
  */
 CNFModel::CNFModel()
-    : next_var_id(1), aux_counter(0) {
+    : entries(1, VariableEntry{false, AuxKind::GENERIC, 0}),
+      has_wide_literals(false), has_wide_offsets(false),
+      next_var_id(1), aux_counter(0), num_auxiliary(0) {
+    short_offsets.push_back(0);
 }
 
 /**
@@ -38,9 +45,11 @@ CNFModel::CNFModel()
  * @param name Feature name to add
  */
 void CNFModel::add_feature(const std::string& name) {
-    if (variables.find(name) == variables.end()) {
-        variables[name] = next_var_id;
-        features[next_var_id] = name;
+    auto inserted = variables.emplace(name, next_var_id);
+    if (inserted.second) {
+        entries.push_back(VariableEntry{false, AuxKind::GENERIC,
+                                        static_cast<uint32_t>(feature_names.size())});
+        feature_names.push_back(name);
         next_var_id++;
     }
 }
@@ -77,28 +86,74 @@ bool CNFModel::has_variable(const std::string& name) const {
  * @brief Creates a new auxiliary variable for Tseitin transformation
  *
  * Generates a unique auxiliary variable with an auto-incremented counter.
- * Auxiliary variables are named "aux_N" or "aux_N_description" where N is
- * a sequential counter starting from 1.
+ * Auxiliary variables are named "aux_N" or "aux_N_kind" where N is
+ * a sequential counter starting from 1. The name is not stored; only the
+ * kind tag and N are recorded, and the name is produced on request.
  *
  * These variables are used in Tseitin transformation to represent
  * intermediate boolean operation results.
  *
- * @param description Optional description for debugging (e.g., "and", "or")
+ * @param kind Purpose tag of the variable (e.g., OR_TREE)
  * @return Variable ID for the new auxiliary variable
  */
-int CNFModel::create_auxiliary_variable(const std::string& description) {
+int CNFModel::create_auxiliary_variable(AuxKind kind) {
     int var_id = next_var_id++;
     aux_counter++;
+    num_auxiliary++;
+    entries.push_back(VariableEntry{true, kind, static_cast<uint32_t>(aux_counter)});
+    return var_id;
+}
 
-    std::string aux_name;
-    if (description.empty()) {
-        aux_name = "aux_" + std::to_string(aux_counter);
-    } else {
-        aux_name = "aux_" + std::to_string(aux_counter) + "_" + description;
+/**
+ * @brief Returns the name suffix of an auxiliary variable kind
+ *
+ * @param kind Auxiliary variable kind
+ * @return Suffix appended to "aux_N" (empty for GENERIC)
+ */
+static const char* aux_kind_suffix(CNFModel::AuxKind kind) {
+    switch (kind) {
+        case CNFModel::AuxKind::OR_TREE: return "_or_tree";
+        case CNFModel::AuxKind::GENERIC: break;
     }
+    return "";
+}
 
-    auxiliary_variables[var_id] = aux_name;
-    return var_id;
+/**
+ * @brief Materializes the name of a variable
+ *
+ * @param var Variable ID
+ * @return Feature name, or "aux_N[_kind]" for auxiliary variables
+ */
+std::string CNFModel::get_variable_name(int var) const {
+    const VariableEntry& entry = entries[var];
+    if (!entry.is_auxiliary) {
+        return feature_names[entry.index];
+    }
+    return "aux_" + std::to_string(entry.index) + aux_kind_suffix(entry.aux_kind);
+}
+
+/**
+ * @brief Streams the name of a variable without allocating
+ *
+ * @param out Output stream
+ * @param var Variable ID
+ */
+void CNFModel::write_variable_name(std::ostream& out, int var) const {
+    write_entry_name(out, entries[var]);
+}
+
+/**
+ * @brief Streams the name described by a variable entry
+ *
+ * @param out Output stream
+ * @param entry Variable entry
+ */
+void CNFModel::write_entry_name(std::ostream& out, const VariableEntry& entry) const {
+    if (!entry.is_auxiliary) {
+        out << feature_names[entry.index];
+    } else {
+        out << "aux_" << entry.index << aux_kind_suffix(entry.aux_kind);
+    }
 }
 
 /**
@@ -111,10 +166,226 @@ int CNFModel::create_auxiliary_variable(const std::string& description) {
  *
  * Example: {1, -2, 3} represents (v1 ∨ ¬v2 ∨ v3)
  *
- * @param clause Vector of literals (non-zero integers)
+ * The literals are copied into the arena in one step once it stores ints;
+ * while it is narrow they are converted one by one.
+ *
+ * @param first Pointer to the first literal (non-zero integers)
+ * @param last Pointer one past the last literal
+ */
+void CNFModel::add_clause(const int* first, const int* last) {
+    if (!has_wide_literals && !std::all_of(first, last, is_short_literal)) {
+        widen_literals();
+    }
+    if (has_wide_literals) {
+        wide_literals.append(first, last);
+    } else {
+        for (const int* literal = first; literal != last; ++literal) {
+            short_literals.push_back(static_cast<int16_t>(*literal));
+        }
+    }
+    push_offset(get_num_literals());
+}
+
+/**
+ * @brief Moves the literals from int16_t to int storage
+ *
+ * Happens at most once per model, when the first literal beyond the 16-bit
+ * range (i.e. variable 32768) is added.
+ */
+void CNFModel::widen_literals() {
+    wide_literals.reserve(std::max<size_t>(2 * short_literals.size(), 1024));
+    for (int16_t literal : short_literals) {
+        wide_literals.push_back(literal);
+    }
+    short_literals.clear();
+    has_wide_literals = true;
+}
+
+/**
+ * @brief Moves the offsets from uint32_t to size_t storage
+ *
+ * Happens at most once per model, when the arena reaches 2^32 literals.
+ */
+void CNFModel::widen_offsets() {
+    wide_offsets.reserve(2 * short_offsets.size());
+    for (uint32_t offset : short_offsets) {
+        wide_offsets.push_back(offset);
+    }
+    short_offsets.clear();
+    has_wide_offsets = true;
+}
+
+/**
+ * @brief Reserves capacity in the clause arena
+ *
+ * @param num_clauses Expected number of clauses
+ * @param num_literals Expected total number of literals
+ */
+void CNFModel::reserve(size_t num_clauses, size_t num_literals) {
+    if (has_wide_offsets) {
+        wide_offsets.reserve(num_clauses + 1);
+    } else {
+        short_offsets.reserve(num_clauses + 1);
+    }
+    if (has_wide_literals) {
+        wide_literals.reserve(num_literals);
+    } else {
+        short_literals.reserve(num_literals);
+    }
+}
+
+/**
+ * @brief Sets the memory limit of the clause arena
+ *
+ * @param bytes Maximum heap size of each buffer in bytes (0 = never spill)
+ */
+void CNFModel::set_spill_threshold(size_t bytes) {
+    short_literals.set_threshold(bytes);
+    wide_literals.set_threshold(bytes);
+    short_offsets.set_threshold(bytes);
+    wide_offsets.set_threshold(bytes);
+}
+
+/**
+ * @brief Replaces the clause arena with the given buffers
+ *
+ * Each buffer is stored narrow if all of its values fit, otherwise the
+ * vector is swapped in as is.
+ *
+ * @param new_literals Literals of the new clauses (left empty)
+ * @param new_offsets Offsets of the new clauses (left empty)
+ * @throws std::invalid_argument if the buffers do not form a valid arena
+ */
+void CNFModel::replace_clauses(std::vector<int>&& new_literals, std::vector<size_t>&& new_offsets) {
+    if (new_offsets.empty() || new_offsets.front() != 0 ||
+        new_offsets.back() != new_literals.size()) {
+        throw std::invalid_argument("Invalid clause arena");
+    }
+
+    short_literals.clear();
+    wide_literals.clear();
+    has_wide_literals = !std::all_of(new_literals.begin(), new_literals.end(), is_short_literal);
+    if (has_wide_literals) {
+        wide_literals.swap(new_literals);
+    } else {
+        short_literals.reserve(new_literals.size());
+        for (int literal : new_literals) {
+            short_literals.push_back(static_cast<int16_t>(literal));
+        }
+    }
+    std::vector<int>().swap(new_literals);
+
+    short_offsets.clear();
+    wide_offsets.clear();
+    has_wide_offsets = new_offsets.back() > std::numeric_limits<uint32_t>::max();
+    if (has_wide_offsets) {
+        wide_offsets.swap(new_offsets);
+    } else {
+        short_offsets.reserve(new_offsets.size());
+        for (size_t offset : new_offsets) {
+            short_offsets.push_back(static_cast<uint32_t>(offset));
+        }
+    }
+    std::vector<size_t>().swap(new_offsets);
+}
+
+/**
+ * @brief Renumbers, merges or drops variables
+ *
+ * The map is validated and applied to the clauses before the variable table
+ * is touched, so a malformed map leaves the model unchanged.
+ *
+ * @param literal_map Map of size get_num_variables() + 1 (entry 0 unused)
+ * @throws std::invalid_argument if the map is malformed or drops a variable used in a clause
  */
-void CNFModel::add_clause(const std::vector<int>& clause) {
-    clauses.push_back(clause);
+void CNFModel::remap_variables(const std::vector<int>& literal_map) {
+    int old_count = get_num_variables();
+    if (literal_map.size() != static_cast<size_t>(old_count) + 1) {
+        throw std::invalid_argument("Variable map size does not match the number of variables");
+    }
+
+    int new_count = 0;
+    for (int var = 1; var <= old_count; ++var) {
+        int target = std::abs(literal_map[var]);
+        if (target > old_count) {
+            throw std::invalid_argument("Variable map target out of range");
+        }
+        new_count = std::max(new_count, target);
+    }
+
+    // The first old variable mapped positively onto a new variable owns it
+    std::vector<int> owner(new_count + 1, 0);
+    for (int var = 1; var <= old_count; ++var) {
+        int target = literal_map[var];
+        if (target > 0 && owner[target] == 0) {
+            owner[target] = var;
+        }
+    }
+    for (int target = 1; target <= new_count; ++target) {
+        if (owner[target] == 0) {
+            throw std::invalid_argument("Variable map leaves variable " + std::to_string(target) + " without an owner");
+        }
+    }
+
+    // Validate before rewriting in place, so that a spilled arena is not copied
+    if (!has_wide_literals && new_count > std::numeric_limits<int16_t>::max()) {
+        widen_literals();
+    }
+    auto rewrite = [&literal_map](auto& buffer) {
+        using Literal = typename std::decay<decltype(*buffer.data())>::type;
+        for (int lit : buffer) {
+            if (literal_map[std::abs(lit)] == 0) {
+                throw std::invalid_argument("Variable map drops variable " + std::to_string(std::abs(lit)) +
+                                            " which is used in a clause");
+            }
+        }
+        auto* data = buffer.data();
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            int target = literal_map[std::abs(static_cast<int>(data[i]))];
+            data[i] = static_cast<Literal>(data[i] > 0 ? target : -target);
+        }
+    };
+    if (has_wide_literals) {
+        rewrite(wide_literals);
+    } else {
+        rewrite(short_literals);
+    }
+
+    // Rebuild the variable table
+    std::vector<VariableEntry> new_entries(new_count + 1, VariableEntry{false, AuxKind::GENERIC, 0});
+    std::vector<VariableAlias> new_aliases;
+    for (const auto& alias : aliases) {
+        int target = literal_map[std::abs(alias.literal)];
+        if (target != 0) {
+            new_aliases.push_back(VariableAlias{alias.entry, alias.literal > 0 ? target : -target});
+        }
+    }
+    for (int var = 1; var <= old_count; ++var) {
+        int target = literal_map[var];
+        if (target == 0) {
+            continue;
+        }
+        if (target > 0 && owner[target] == var) {
+            new_entries[target] = entries[var];
+        } else {
+            new_aliases.push_back(VariableAlias{entries[var], target});
+        }
+    }
+
+    variables.clear();
+    num_auxiliary = 0;
+    for (int var = 1; var <= new_count; ++var) {
+        const VariableEntry& entry = new_entries[var];
+        if (entry.is_auxiliary) {
+            num_auxiliary++;
+        } else {
+            variables.emplace(feature_names[entry.index], var);
+        }
+    }
+
+    entries.swap(new_entries);
+    aliases.swap(new_aliases);
+    next_var_id = new_count + 1;
 }
 
 /**
@@ -129,26 +400,25 @@ std::string CNFModel::to_string() const {
     std::ostringstream oss;
 
     oss << "CNFModel:\n";
-    oss << "  Features: " << features.size() << "\n";
-    oss << "  Auxiliary variables: " << auxiliary_variables.size() << "\n";
+    oss << "  Features: " << get_num_features() << "\n";
+    oss << "  Auxiliary variables: " << get_num_auxiliary_variables() << "\n";
     oss << "  Total variables: " << get_num_variables() << "\n";
     oss << "  Clauses: " << get_num_clauses() << "\n";
 
     // Sample first few clauses
-    if (!clauses.empty()) {
+    int num_clauses = get_num_clauses();
+    if (num_clauses > 0) {
         oss << "\nSample clauses:\n";
-        int count = 0;
-        for (const auto& clause : clauses) {
-            if (count >= 5) {
-                oss << "  ... (" << (clauses.size() - 5) << " more)\n";
+        for (int i = 0; i < num_clauses; ++i) {
+            if (i >= 5) {
+                oss << "  ... (" << (num_clauses - 5) << " more)\n";
                 break;
             }
             oss << "  ";
-            for (int lit : clause) {
+            for (int lit : get_clause(i)) {
                 oss << lit << " ";
             }
             oss << "0\n";
-            count++;
         }
     }
 
@@ -0,0 +1,317 @@
+/**
+ * @file ClauseNormalizer.cc
+ * @brief Implementation of clause normalization, deduplication and subsumption
+ *
+ * The pass works on a copy of the arena in normalized form and finally swaps
+ * the compacted result back into the model:
+ *
+ * 1. Sort and deduplicate the literals of each clause, drop tautologies
+ * 2. Hash the normalized clauses to flag exact duplicates
+ * 3. Visit the remaining clauses from shortest to longest and flag those that
+ *    contain an already kept clause (forward subsumption)
+ * 4. Compact the unflagged clauses in their original order
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "ClauseNormalizer.hh"
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+    /**
+     * @brief Literal order used inside normalized clauses
+     *
+     * Orders by variable, with the negative literal first, so that x and -x
+     * end up adjacent and tautologies are found with a single scan.
+     */
+    inline bool literal_less(int a, int b) {
+        int va = std::abs(a);
+        int vb = std::abs(b);
+        return va < vb || (va == vb && a < b);
+    }
+
+    /**
+     * @brief Maps a literal to a dense index (2 * (var - 1) + sign)
+     */
+    inline size_t literal_index(int literal) {
+        return 2 * static_cast<size_t>(std::abs(literal) - 1) + (literal < 0 ? 1 : 0);
+    }
+
+    /**
+     * @brief Checks whether sorted clause [a, a_end) is a subset of sorted clause [b, b_end)
+     */
+    bool is_subset(const int* a, const int* a_end, const int* b, const int* b_end) {
+        while (a != a_end) {
+            while (b != b_end && literal_less(*b, *a)) {
+                ++b;
+            }
+            if (b == b_end || *b != *a) {
+                return false;
+            }
+            ++a;
+            ++b;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Hash and equality of clauses identified by their index in an arena
+     */
+    struct ClauseKey {
+        const std::vector<int>* literals;
+        const std::vector<size_t>* offsets;
+
+        size_t operator()(uint32_t c) const {
+            uint64_t h = 1469598103934665603ULL;
+            for (size_t i = (*offsets)[c]; i < (*offsets)[c + 1]; ++i) {
+                h ^= static_cast<uint32_t>((*literals)[i]);
+                h *= 1099511628211ULL;
+            }
+            return static_cast<size_t>(h);
+        }
+
+        bool operator()(uint32_t a, uint32_t b) const {
+            size_t len_a = (*offsets)[a + 1] - (*offsets)[a];
+            size_t len_b = (*offsets)[b + 1] - (*offsets)[b];
+            return len_a == len_b &&
+                   std::equal(literals->begin() + (*offsets)[a],
+                              literals->begin() + (*offsets)[a + 1],
+                              literals->begin() + (*offsets)[b]);
+        }
+    };
+}
+
+/**
+ * @brief Constructs a normalizer with subsumption enabled and the default budget
+ */
+ClauseNormalizer::ClauseNormalizer()
+    : use_subsumption(true), subsumption_budget(DEFAULT_SUBSUMPTION_BUDGET),
+      removed_literals(0), tautologies(0), duplicate_clauses(0),
+      subsumed_clauses(0), budget_exhausted(false) {
+}
+
+/**
+ * @brief Normalizes the clauses of a CNF model
+ *
+ * @param model CNF model whose clause set is rewritten in place
+ */
+void ClauseNormalizer::normalize(CNFModel& model) {
+    removed_literals = 0;
+    tautologies = 0;
+    duplicate_clauses = 0;
+    subsumed_clauses = 0;
+    budget_exhausted = false;
+
+    std::vector<int> literals;
+    std::vector<size_t> offsets;
+    normalize_literals(model, literals, offsets);
+
+    size_t num_clauses = offsets.size() - 1;
+    std::vector<char> removed(num_clauses, 0);
+    mark_duplicates(literals, offsets, removed);
+    if (use_subsumption && subsumption_budget > 0) {
+        mark_subsumed(literals, offsets, model.get_num_variables(), removed);
+    }
+
+    // Compact surviving clauses in place, keeping their order
+    size_t write = 0;
+    size_t kept = 0;
+    for (size_t c = 0; c < num_clauses; ++c) {
+        if (removed[c]) {
+            continue;
+        }
+        for (size_t i = offsets[c]; i < offsets[c + 1]; ++i) {
+            literals[write++] = literals[i];
+        }
+        offsets[++kept] = write;
+    }
+    literals.resize(write);
+    offsets.resize(kept + 1);
+
+    model.replace_clauses(std::move(literals), std::move(offsets));
+}
+
+/**
+ * @brief Sorts, deduplicates and tautology-checks every clause
+ *
+ * @param model Source model
+ * @param out_literals Literal buffer receiving the surviving clauses
+ * @param out_offsets Offset buffer receiving the surviving clauses
+ */
+void ClauseNormalizer::normalize_literals(const CNFModel& model,
+                                          std::vector<int>& out_literals,
+                                          std::vector<size_t>& out_offsets) {
+    out_literals.reserve(model.get_num_literals());
+    out_offsets.reserve(model.get_num_clauses() + 1);
+    out_offsets.push_back(0);
+
+    for (int c = 0; c < model.get_num_clauses(); ++c) {
+        ClauseView clause = model.get_clause(c);
+        size_t start = out_literals.size();
+        out_literals.insert(out_literals.end(), clause.begin(), clause.end());
+
+        auto first = out_literals.begin() + start;
+        std::sort(first, out_literals.end(), literal_less);
+        auto last = std::unique(first, out_literals.end());
+        removed_literals += static_cast<size_t>(out_literals.end() - last);
+        out_literals.erase(last, out_literals.end());
+
+        bool tautology = false;
+        for (size_t i = start + 1; i < out_literals.size(); ++i) {
+            if (out_literals[i] == -out_literals[i - 1]) {
+                tautology = true;
+                break;
+            }
+        }
+
+        if (tautology) {
+            out_literals.resize(start);
+            tautologies++;
+        } else {
+            out_offsets.push_back(out_literals.size());
+        }
+    }
+}
+
+/**
+ * @brief Marks exact duplicate clauses
+ *
+ * The first occurrence of each clause is kept.
+ *
+ * @param literals Normalized literal arena
+ * @param offsets Normalized offset arena
+ * @param removed Per-clause removal flags (updated)
+ */
+void ClauseNormalizer::mark_duplicates(const std::vector<int>& literals,
+                                       const std::vector<size_t>& offsets,
+                                       std::vector<char>& removed) {
+    ClauseKey key{&literals, &offsets};
+    std::unordered_set<uint32_t, ClauseKey, ClauseKey> seen(removed.size() * 2, key, key);
+
+    for (uint32_t c = 0; c < removed.size(); ++c) {
+        if (!seen.insert(c).second) {
+            removed[c] = 1;
+            duplicate_clauses++;
+        }
+    }
+}
+
+/**
+ * @brief Marks clauses subsumed by other kept clauses
+ *
+ * Clauses are visited from shortest to longest (stable, so ties keep their
+ * original order). A kept clause D is stored in the watch list of its literal
+ * with the fewest occurrences; since D can only be a subset of C if that
+ * literal is in C, checking the watch lists of C's literals is complete.
+ *
+ * @param literals Normalized literal arena
+ * @param offsets Normalized offset arena
+ * @param num_variables Number of variables of the model
+ * @param removed Per-clause removal flags (updated)
+ */
+void ClauseNormalizer::mark_subsumed(const std::vector<int>& literals,
+                                     const std::vector<size_t>& offsets,
+                                     int num_variables,
+                                     std::vector<char>& removed) {
+    size_t num_clauses = removed.size();
+    std::vector<uint32_t> occurrences(2 * static_cast<size_t>(num_variables), 0);
+    std::vector<uint32_t> order;
+    order.reserve(num_clauses);
+
+    for (uint32_t c = 0; c < num_clauses; ++c) {
+        if (removed[c]) {
+            continue;
+        }
+        order.push_back(c);
+        for (size_t i = offsets[c]; i < offsets[c + 1]; ++i) {
+            occurrences[literal_index(literals[i])]++;
+        }
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&offsets](uint32_t a, uint32_t b) {
+        return offsets[a + 1] - offsets[a] < offsets[b + 1] - offsets[b];
+    });
+
+    std::vector<std::vector<uint32_t>> watches(occurrences.size());
+    uint64_t budget = subsumption_budget;
+
+    for (uint32_t c : order) {
+        const int* c_begin = literals.data() + offsets[c];
+        const int* c_end = literals.data() + offsets[c + 1];
+
+        bool subsumed = false;
+        for (const int* lit = c_begin; lit != c_end && !subsumed; ++lit) {
+            for (uint32_t d : watches[literal_index(*lit)]) {
+                if (budget == 0) {
+                    budget_exhausted = true;
+                    return;
+                }
+                budget--;
+                if (is_subset(literals.data() + offsets[d], literals.data() + offsets[d + 1],
+                              c_begin, c_end)) {
+                    subsumed = true;
+                    break;
+                }
+            }
+        }
+
+        if (subsumed) {
+            removed[c] = 1;
+            subsumed_clauses++;
+        } else if (c_begin != c_end) {
+            const int* watch = std::min_element(c_begin, c_end, [&occurrences](int a, int b) {
+                return occurrences[literal_index(a)] < occurrences[literal_index(b)];
+            });
+            watches[literal_index(*watch)].push_back(c);
+        }
+    }
+}
+
+/**
+ * @brief Rewrites the clauses of a CNF model in a canonical order
+ *
+ * @param model CNF model whose clause set is reordered in place
+ */
+void ClauseNormalizer::sort_canonically(CNFModel& model) {
+    size_t num_clauses = static_cast<size_t>(model.get_num_clauses());
+    std::vector<int> sorted_literals;
+    std::vector<size_t> sorted_offsets;
+    sorted_literals.reserve(model.get_num_literals());
+    sorted_offsets.reserve(num_clauses + 1);
+    sorted_offsets.push_back(0);
+
+    for (size_t c = 0; c < num_clauses; ++c) {
+        ClauseView clause = model.get_clause(static_cast<int>(c));
+        sorted_literals.insert(sorted_literals.end(), clause.begin(), clause.end());
+        std::sort(sorted_literals.begin() + sorted_offsets.back(), sorted_literals.end(), literal_less);
+        sorted_offsets.push_back(sorted_literals.size());
+    }
+
+    std::vector<uint32_t> order(num_clauses);
+    for (size_t c = 0; c < num_clauses; ++c) {
+        order[c] = static_cast<uint32_t>(c);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return std::lexicographical_compare(
+            sorted_literals.begin() + sorted_offsets[a], sorted_literals.begin() + sorted_offsets[a + 1],
+            sorted_literals.begin() + sorted_offsets[b], sorted_literals.begin() + sorted_offsets[b + 1],
+            literal_less);
+    });
+
+    std::vector<int> out_literals;
+    std::vector<size_t> out_offsets;
+    out_literals.reserve(sorted_literals.size());
+    out_offsets.reserve(num_clauses + 1);
+    out_offsets.push_back(0);
+    for (uint32_t c : order) {
+        out_literals.insert(out_literals.end(),
+                            sorted_literals.begin() + sorted_offsets[c],
+                            sorted_literals.begin() + sorted_offsets[c + 1]);
+        out_offsets.push_back(out_literals.size());
+    }
+    model.replace_clauses(std::move(out_literals), std::move(out_offsets));
+}
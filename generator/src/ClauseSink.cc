@@ -0,0 +1,96 @@
+/**
+ * @file ClauseSink.cc
+ * @brief Implementation of the clause sink interface, the counting sink and the buffer
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "ClauseSink.hh"
+#include <stdexcept>
+
+/**
+ * @brief Adds a complete clause literal by literal
+ *
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ */
+void ClauseSink::add_clause(const int* first, const int* last) {
+    begin_clause();
+    for (const int* it = first; it != last; ++it) {
+        add_literal(*it);
+    }
+    end_clause();
+}
+
+/**
+ * @brief Rejects cardinality constraints on sinks that only take clauses
+ *
+ * @param bound Smallest number of true literals
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ * @throws std::logic_error always
+ */
+void ClauseSink::add_at_least(int bound, const int* first, const int* last) {
+    (void)bound;
+    (void)first;
+    (void)last;
+    throw std::logic_error("Clause sink has no native cardinality constraints");
+}
+
+/**
+ * @brief Rejects guarded cardinality constraints on sinks without weights
+ *
+ * @param guard Literal that enables the constraint
+ * @param bound Smallest number of true literals
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ * @throws std::logic_error always
+ */
+void ClauseSink::add_guarded_at_least(int guard, int bound, const int* first, const int* last) {
+    (void)guard;
+    (void)bound;
+    (void)first;
+    (void)last;
+    throw std::logic_error("Clause sink has no weighted cardinality constraints");
+}
+
+/**
+ * @brief Constructs a counter with all counts at zero
+ */
+ClauseCounter::ClauseCounter()
+    : num_clauses(0), num_literals(0), max_clause_size(0), current_size(0) {
+}
+
+/**
+ * @brief Records the clause written since begin_clause()
+ */
+void ClauseCounter::end_clause() {
+    num_clauses++;
+    num_literals += current_size;
+    if (current_size > max_clause_size) {
+        max_clause_size = current_size;
+    }
+}
+
+/**
+ * @brief Records a complete clause without looking at its literals
+ *
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ */
+void ClauseCounter::add_clause(const int* first, const int* last) {
+    current_size = static_cast<size_t>(last - first);
+    end_clause();
+}
+
+/**
+ * @brief Appends a complete clause and its terminator
+ *
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ */
+void ClauseBuffer::add_clause(const int* first, const int* last) {
+    literals.insert(literals.end(), first, last);
+    literals.push_back(0);
+}
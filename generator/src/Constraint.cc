@@ -75,6 +75,31 @@ std::vector<std::vector<int>> Constraint::get_clauses(
     return ast->get_clauses(get_variable, create_aux_var, mode);
 }
 
+/**
+ * @brief Converts constraint to CNF clauses emitted to a sink
+ *
+ * Delegates to the AST's streaming get_clauses method. A constraint without
+ * an expression emits nothing.
+ *
+ * @param sink Destination of the generated clauses
+ * @param get_variable Function to map feature names to variable IDs
+ * @param create_aux_var Function to create auxiliary variables (Tseitin mode)
+ * @param mode Conversion mode (TSEITIN or STRAIGHTFORWARD)
+ * @param gates Gates shared with the rest of the conversion (Tseitin mode, optional)
+ */
+void Constraint::get_clauses(
+    ClauseSink& sink,
+    std::function<int(const std::string&)> get_variable,
+    std::function<int()> create_aux_var,
+    CNFMode mode,
+    GateCache* gates
+) const {
+    if (!ast) {
+        return;
+    }
+    ast->get_clauses(sink, get_variable, create_aux_var, mode, gates);
+}
+
 /**
  * @brief Checks if constraint uses only boolean operations
  *
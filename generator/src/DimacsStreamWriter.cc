@@ -0,0 +1,155 @@
+/**
+ * @file DimacsStreamWriter.cc
+ * @brief Implementation of the streaming DIMACS clause sink
+ *
+ * Clauses are written to the file as they arrive. The header is written with
+ * space-padded placeholders and patched in place once the final variable and
+ * clause counts are known:
+ *
+ * @code
+ * c Generated by UVL2Dimacs
+ * c Original features: 2
+ * c Auxiliary variables: 0
+ * c Total variables: 2
+ * p cnf 2          3
+ * c 1 FeatureA
+ * c 2 FeatureB
+ * 1 0
+ * -2 1 0
+ * -1 2 0
+ * @endcode
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "DimacsStreamWriter.hh"
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr int VARIABLE_FIELD_WIDTH = 10;  ///< Digits reserved for variable counts (int)
+    constexpr int CLAUSE_FIELD_WIDTH = 20;    ///< Digits reserved for the clause count (uint64)
+
+    /**
+     * @brief Writes a placeholder of the given width
+     */
+    void write_placeholder(std::ofstream& out, int width) {
+        out << std::string(width, ' ');
+    }
+
+    /**
+     * @brief Overwrites a placeholder with a left-aligned number
+     */
+    void patch_field(std::ofstream& out, std::ofstream::pos_type pos, uint64_t value) {
+        out.seekp(pos);
+        out << value;
+    }
+}
+
+/**
+ * @brief Opens the output file
+ *
+ * @param path Path to the output file
+ * @throws std::runtime_error if the file cannot be opened for writing
+ */
+DimacsStreamWriter::DimacsStreamWriter(const std::string& path)
+    : DimacsStreamWriter(path, "cnf") {
+}
+
+/**
+ * @brief Opens the output file of a DIMACS dialect
+ *
+ * @param path Path to the output file
+ * @param type Format name written in the problem line
+ * @throws std::runtime_error if the file cannot be opened for writing
+ */
+DimacsStreamWriter::DimacsStreamWriter(const std::string& path, const char* type)
+    : filepath(path), problem_type(type), header_written(false),
+      out(path, std::ios::out | std::ios::trunc), num_clauses(0) {
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + filepath);
+    }
+}
+
+/**
+ * @brief Terminates the clause being written
+ */
+void DimacsStreamWriter::end_clause() {
+    out << "0\n";
+    num_clauses++;
+}
+
+/**
+ * @brief Writes a complete clause line
+ *
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ */
+void DimacsStreamWriter::add_clause(const int* first, const int* last) {
+    for (const int* it = first; it != last; ++it) {
+        out << *it << ' ';
+    }
+    out << "0\n";
+    num_clauses++;
+}
+
+/**
+ * @brief Writes the header with placeholders and the feature comment lines
+ *
+ * @param variables Variable table containing all feature variables
+ */
+void DimacsStreamWriter::begin_formula(const CNFModel& variables) {
+    out << "c Generated by UVL2Dimacs\n";
+    out << "c Original features: " << variables.get_num_features() << "\n";
+    out << "c Auxiliary variables: ";
+    aux_count_pos = out.tellp();
+    write_placeholder(out, VARIABLE_FIELD_WIDTH);
+    out << "\nc Total variables: ";
+    total_pos = out.tellp();
+    write_placeholder(out, VARIABLE_FIELD_WIDTH);
+    out << "\np " << problem_type << " ";
+    problem_pos = out.tellp();
+    write_placeholder(out, VARIABLE_FIELD_WIDTH + 1 + CLAUSE_FIELD_WIDTH);
+    out << "\n";
+
+    for (int var = 1; var <= variables.get_num_variables(); ++var) {
+        if (!variables.is_auxiliary(var)) {
+            out << "c " << var << " " << variables.get_feature_name(var) << "\n";
+        }
+    }
+
+    header_written = true;
+}
+
+/**
+ * @brief Writes the auxiliary comment lines and patches the header
+ *
+ * @param variables Final variable table
+ * @throws std::runtime_error if the header was never written or the file is in error
+ */
+void DimacsStreamWriter::end_formula(const CNFModel& variables) {
+    if (!header_written) {
+        throw std::runtime_error("DIMACS stream finished before its header was written: " + filepath);
+    }
+
+    int num_variables = variables.get_num_variables();
+    for (int var = 1; var <= num_variables; ++var) {
+        if (variables.is_auxiliary(var)) {
+            out << "c " << var << " ";
+            variables.write_variable_name(out, var);
+            out << " (auxiliary)\n";
+        }
+    }
+
+    patch_field(out, aux_count_pos, variables.get_num_auxiliary_variables());
+    patch_field(out, total_pos, num_variables);
+    patch_field(out, problem_pos, num_variables);
+    out << ' ' << num_clauses;
+    out.seekp(0, std::ios::end);
+    out.flush();
+
+    if (!out) {
+        throw std::runtime_error("Failed to write DIMACS file: " + filepath);
+    }
+}
@@ -66,43 +66,58 @@ void DimacsWriter::write_to_file(const std::string& filepath) {
  * 1. Problem line: "p cnf <variables> <clauses>"
  * 2. Comment lines for feature variables: "c <var_id> <feature_name>"
  * 3. Comment lines for auxiliary variables: "c <var_id> <aux_name>"
- * 4. Clauses: "<lit1> <lit2> ... 0" (one per line)
+ * 4. Comment lines for features merged by remap_variables():
+ *    "c <literal> <feature_name> (equivalent)", the feature equals that literal
+ * 5. Clauses: "<lit1> <lit2> ... 0" (one per line)
  *
  * @param out Output stream to write to
  */
 void DimacsWriter::write_to_stream(std::ostream& out) {
-    // Count original features (exclude auxiliary variables)
-    const auto& features = cnf_model.get_features();
-    const auto& aux_vars = cnf_model.get_auxiliary_variables();
-    int num_features = features.size();
+    int num_variables = cnf_model.get_num_variables();
 
     // Write header comments
     out << "c Generated by UVL2Dimacs\n";
-    out << "c Original features: " << num_features << "\n";
-    out << "c Auxiliary variables: " << aux_vars.size() << "\n";
-    out << "c Total variables: " << cnf_model.get_num_variables() << "\n";
+    out << "c Original features: " << cnf_model.get_num_features() << "\n";
+    out << "c Auxiliary variables: " << cnf_model.get_num_auxiliary_variables() << "\n";
+    out << "c Total variables: " << num_variables << "\n";
 
     // Write problem line
-    out << "p cnf " << cnf_model.get_num_variables() << " " << cnf_model.get_num_clauses() << "\n";
+    out << "p cnf " << num_variables << " " << cnf_model.get_num_clauses() << "\n";
 
     // Write comment lines for feature variables
-    for (const auto& [var_id, feature_name] : features) {
-        out << "c " << var_id << " " << feature_name << "\n";
+    for (int var = 1; var <= num_variables; ++var) {
+        if (!cnf_model.is_auxiliary(var)) {
+            out << "c " << var << " " << cnf_model.get_feature_name(var) << "\n";
+        }
     }
 
-    // Write comment lines for auxiliary variables
-    for (const auto& [var_id, aux_name] : aux_vars) {
-        out << "c " << var_id << " " << aux_name << " (auxiliary)\n";
+    // Write comment lines for auxiliary variables (names are built on the fly)
+    for (int var = 1; var <= num_variables; ++var) {
+        if (cnf_model.is_auxiliary(var)) {
+            out << "c " << var << " ";
+            cnf_model.write_variable_name(out, var);
+            out << " (auxiliary)\n";
+        }
     }
 
-    // Write clauses
-    const auto& clauses = cnf_model.get_clauses();
-    for (const auto& clause : clauses) {
-        for (int literal : clause) {
-            out << literal << " ";
+    // Write comment lines for features merged into another variable
+    for (size_t i = 0; i < cnf_model.get_num_aliases(); ++i) {
+        if (!cnf_model.is_auxiliary_alias(i)) {
+            out << "c " << cnf_model.get_alias_literal(i) << " ";
+            cnf_model.write_alias_name(out, i);
+            out << " (equivalent)\n";
         }
-        out << "0\n";
     }
+
+    // Write clauses: one linear scan over the literal arena, compiled for its widths
+    cnf_model.visit_arena([&out](const auto& arena) {
+        for (size_t c = 0; c < arena.num_clauses; ++c) {
+            for (size_t i = arena.offsets[c]; i < arena.offsets[c + 1]; ++i) {
+                out << static_cast<int>(arena.literals[i]) << " ";
+            }
+            out << "0\n";
+        }
+    });
 }
 
 /**
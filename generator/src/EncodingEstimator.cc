@@ -0,0 +1,446 @@
+/**
+ * @file EncodingEstimator.cc
+ * @brief Implementation of the dry-run encoding size prediction
+ *
+ * The formulas follow RelationEncoder.cc and ASTNode.cc; a change to an
+ * encoding there must be reflected here.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "EncodingEstimator.hh"
+#include "Feature.hh"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+    /**
+     * @brief Adds two counts, saturating at UINT64_MAX
+     */
+    inline uint64_t saturating_add(uint64_t a, uint64_t b) {
+        return a > UINT64_MAX - b ? UINT64_MAX : a + b;
+    }
+
+    /**
+     * @brief Multiplies two counts, saturating at UINT64_MAX
+     */
+    inline uint64_t saturating_mul(uint64_t a, uint64_t b) {
+        if (a == 0 || b == 0) {
+            return 0;
+        }
+        return a > UINT64_MAX / b ? UINT64_MAX : a * b;
+    }
+
+    /**
+     * @brief Builds a cost from its three counts
+     */
+    inline EncodingCost make_cost(uint64_t variables, uint64_t clauses, uint64_t literals) {
+        EncodingCost cost;
+        cost.variables = variables;
+        cost.clauses = clauses;
+        cost.literals = literals;
+        return cost;
+    }
+
+    /**
+     * @brief Scales every count of a cost (saturating)
+     */
+    inline EncodingCost scale(const EncodingCost& cost, uint64_t factor) {
+        return make_cost(saturating_mul(cost.variables, factor), saturating_mul(cost.clauses, factor),
+                         saturating_mul(cost.literals, factor));
+    }
+
+    /**
+     * @brief Cost of RelationEncoder::encode_or_tree() over n inputs
+     *
+     * Every binary OR gate adds one auxiliary variable and 3 clauses with
+     * 7 literals; n inputs need n - 1 gates.
+     */
+    inline EncodingCost or_tree_cost(uint64_t n) {
+        uint64_t gates = n < 2 ? 0 : n - 1;
+        return make_cost(gates, saturating_mul(3, gates), saturating_mul(7, gates));
+    }
+
+    /**
+     * @brief Cost of the "parent implies at least one of n children" clause
+     */
+    inline EncodingCost at_least_one_cost(uint64_t n, CNFMode mode) {
+        if (is_three_cnf(mode) && n > 2) {
+            EncodingCost cost = or_tree_cost(n);
+            cost += make_cost(0, 1, 2);
+            return cost;
+        }
+        return make_cost(0, 1, n + 1);
+    }
+
+    /**
+     * @brief Cost of the conjunction of two NNF formulas (clauses concatenated)
+     */
+    inline EncodingCost conjunction(const EncodingCost& a, const EncodingCost& b) {
+        return make_cost(0, saturating_add(a.clauses, b.clauses), saturating_add(a.literals, b.literals));
+    }
+
+    /**
+     * @brief Cost of the disjunction of two NNF formulas (clauses distributed pairwise)
+     */
+    inline EncodingCost disjunction(const EncodingCost& a, const EncodingCost& b) {
+        return make_cost(0, saturating_mul(a.clauses, b.clauses),
+                         saturating_add(saturating_mul(a.literals, b.clauses),
+                                        saturating_mul(b.literals, a.clauses)));
+    }
+
+    /**
+     * @brief Checks the number of operands of a binary or unary operation
+     */
+    void require_children(const ASTNode& node, size_t count, const char* operation) {
+        if (node.get_children().size() != count) {
+            throw std::runtime_error(std::string(operation) + " must have exactly " +
+                                     std::to_string(count) + (count == 1 ? " child" : " children"));
+        }
+    }
+}
+
+/**
+ * @brief Adds another cost to this one (saturating)
+ *
+ * @param other Cost to add
+ * @return Reference to this cost
+ */
+EncodingCost& EncodingCost::operator+=(const EncodingCost& other) {
+    variables = saturating_add(variables, other.variables);
+    clauses = saturating_add(clauses, other.clauses);
+    literals = saturating_add(literals, other.literals);
+    return *this;
+}
+
+/**
+ * @brief Constructs an estimator for the given feature model
+ *
+ * @param model Shared pointer to the feature model
+ */
+EncodingEstimator::EncodingEstimator(std::shared_ptr<FeatureModel> model)
+    : source_model(model) {
+}
+
+/**
+ * @brief Predicts the encoding size for a conversion mode
+ *
+ * @param mode CNF conversion mode
+ * @throws std::runtime_error if the feature model has no root
+ */
+void EncodingEstimator::estimate(CNFMode mode) {
+    if (!source_model->get_root()) {
+        throw std::runtime_error("Feature model has no root");
+    }
+    total = EncodingCost();
+    items.clear();
+
+    // Feature variables (repeated names share one variable) and the root clause
+    std::unordered_set<std::string> names;
+    for (const auto& feature : source_model->get_features()) {
+        names.insert(feature->get_name());
+    }
+    total += make_cost(names.size(), 1, 1);
+
+    for (const auto& relation : source_model->get_relations()) {
+        items.push_back(estimate_relation(*relation, mode, amo_policy, card_policy));
+    }
+
+    for (const auto& constraint : source_model->get_constraints()) {
+        if (!constraint->is_pure_boolean()) {
+            continue;  // Skipped by FMToCNF::add_constraints()
+        }
+        items.push_back(estimate_constraint(*constraint, mode));
+    }
+
+    for (const auto& item : items) {
+        total += item.cost;
+    }
+}
+
+/**
+ * @brief Gets the indices of the most expensive items
+ *
+ * @param count Maximum number of indices returned
+ * @return Indices into get_items(), by decreasing number of literals
+ */
+std::vector<size_t> EncodingEstimator::get_largest_items(size_t count) const {
+    std::vector<size_t> order(items.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    count = std::min(count, order.size());
+    std::partial_sort(order.begin(), order.begin() + count, order.end(), [this](size_t a, size_t b) {
+        if (items[a].cost.literals != items[b].cost.literals) {
+            return items[a].cost.literals > items[b].cost.literals;
+        }
+        return a < b;
+    });
+    order.resize(count);
+    return order;
+}
+
+/**
+ * @brief Predicts the memory of the clause arena of a CNFModel
+ *
+ * @param cost Encoding cost
+ * @return Bytes of literals and clause offsets (saturating)
+ */
+uint64_t EncodingEstimator::get_arena_bytes(const EncodingCost& cost) {
+    uint64_t literal_width = cost.variables <= static_cast<uint64_t>(std::numeric_limits<int16_t>::max())
+                                 ? sizeof(int16_t) : sizeof(int);
+    uint64_t offset_width = cost.literals <= std::numeric_limits<uint32_t>::max() ? sizeof(uint32_t) : sizeof(size_t);
+    return saturating_add(saturating_mul(cost.literals, literal_width),
+                          saturating_mul(saturating_add(cost.clauses, 1), offset_width));
+}
+
+/**
+ * @brief Predicts the cost of one relation
+ *
+ * Mirrors RelationEncoder: every relation with children also emits one
+ * "child implies parent" clause per child (except MANDATORY, which emits
+ * its two implications itself).
+ *
+ * @param relation Relation of the feature tree
+ * @param mode CNF conversion mode
+ * @param policy At-most-one encoding of alternative groups
+ * @param cardinality Count-bound encoding of cardinality groups
+ * @return Item with the relation's cost
+ */
+EncodingCostItem EncodingEstimator::estimate_relation(const Relation& relation, CNFMode mode,
+                                                      const AtMostOnePolicy& policy,
+                                                      const CardinalityPolicy& cardinality) {
+    uint64_t n = relation.get_children().size();
+    auto parent = relation.get_parent();
+    std::string parent_name = parent ? parent->get_name() : "NULL";
+    EncodingCostItem item{EncodingCostItem::Kind::RELATION, "", EncodingCost()};
+    EncodingCost child_implies_parent = make_cost(0, n, saturating_mul(2, n));
+
+    switch (relation.get_type()) {
+        case Relation::Type::MANDATORY:
+            item.name = "mandatory " + parent_name;
+            item.cost = make_cost(0, 2, 4);
+            break;
+        case Relation::Type::OPTIONAL:
+            item.name = "optional " + parent_name;
+            item.cost = make_cost(0, 1, 2);
+            break;
+        case Relation::Type::OR:
+            item.name = "or " + parent_name;
+            item.cost = at_least_one_cost(n, mode);
+            item.cost += child_implies_parent;
+            break;
+        case Relation::Type::ALTERNATIVE: {
+            item.name = "alternative " + parent_name;
+            item.cost = at_least_one_cost(n, mode);
+            item.cost += estimate_at_most_one(n, mode, policy);
+            item.cost += child_implies_parent;
+            break;
+        }
+        case Relation::Type::CARDINALITY: {
+            item.name = "cardinality " + parent_name;
+            if (!cardinality.is_enumeration(n)) {
+                item.cost = estimate_cardinality(relation, mode, cardinality);
+                item.cost += child_implies_parent;
+                break;
+            }
+            // One clause per subset of the children, valid counts included
+            uint64_t combinations = n >= 64 ? UNBOUNDED : (uint64_t{1} << n);
+            EncodingCost per_combination;
+            if (is_three_cnf(mode) && n > 2) {
+                per_combination = or_tree_cost(n);
+                per_combination += make_cost(0, 1, 2);
+            } else {
+                per_combination = make_cost(0, 1, n + 1);
+            }
+            item.cost = scale(per_combination, combinations);
+            item.cost += child_implies_parent;
+            break;
+        }
+    }
+
+    if (n == 1 && (relation.is_mandatory() || relation.is_optional())) {
+        auto child = relation.get_children()[0];
+        item.name += " -> " + (child ? child->get_name() : std::string("NULL"));
+    }
+    return item;
+}
+
+/**
+ * @brief Predicts the cost of one boolean constraint
+ *
+ * @param constraint Cross-tree constraint (must be pure boolean)
+ * @param mode CNF conversion mode
+ * @return Item with the constraint's cost
+ */
+EncodingCostItem EncodingEstimator::estimate_constraint(const Constraint& constraint, CNFMode mode) {
+    if (mode == CNFMode::HYBRID) {
+        mode = choose_constraint_mode(constraint);
+    }
+    EncodingCostItem item{EncodingCostItem::Kind::CONSTRAINT, constraint.get_name(), EncodingCost()};
+    auto ast = constraint.get_ast();
+    if (ast && is_three_cnf(mode)) {
+        item.cost = estimate_tseitin(*ast, mode);
+    } else if (ast) {
+        EncodingCost negative;
+        estimate_direct(*ast, item.cost, negative);
+    }
+    return item;
+}
+
+/**
+ * @brief Chooses how HYBRID mode converts a constraint
+ *
+ * The direct conversion needs no auxiliary variables, so it is kept unless
+ * distributing OR over AND (or expanding equivalences) makes it larger than
+ * the Tseitin encoding, measured in literals.
+ *
+ * @param constraint Cross-tree constraint (must be pure boolean)
+ * @return TSEITIN or STRAIGHTFORWARD
+ */
+CNFMode EncodingEstimator::choose_constraint_mode(const Constraint& constraint) {
+    EncodingCost direct = estimate_constraint(constraint, CNFMode::STRAIGHTFORWARD).cost;
+    EncodingCost tseitin = estimate_constraint(constraint, CNFMode::TSEITIN).cost;
+    return direct.literals > tseitin.literals ? CNFMode::TSEITIN : CNFMode::STRAIGHTFORWARD;
+}
+
+/**
+ * @brief Predicts the Tseitin cost of a constraint expression
+ *
+ * The flattening and gate splitting of ASTNode::tseitin_transform() depend
+ * on the shape of the whole expression, so the transformation is run into
+ * a ClauseCounter, with features numbered locally.
+ *
+ * @param node AST node
+ * @param mode TSEITIN or PLAISTED_GREENBAUM
+ * @return Auxiliary variables and clauses of the expression
+ */
+EncodingCost EncodingEstimator::estimate_tseitin(const ASTNode& node, CNFMode mode) {
+    std::unordered_map<std::string, int> features;
+    int num_auxiliary = 0;
+    auto get_variable = [&features](const std::string& name) -> int {
+        auto inserted = features.emplace(name, static_cast<int>(features.size()) + 1);
+        return inserted.first->second;
+    };
+    // Auxiliary variables are numbered downwards so they never collide with features
+    auto create_aux_var = [&num_auxiliary]() -> int {
+        return std::numeric_limits<int>::max() - num_auxiliary++;
+    };
+
+    ClauseCounter counter;
+    node.get_clauses(counter, get_variable, create_aux_var, mode);
+    return make_cost(num_auxiliary, counter.get_num_clauses(), counter.get_num_literals());
+}
+
+/**
+ * @brief Predicts the cost of an at-most-one constraint over n literals
+ *
+ * Pairwise encodings are counted in closed form. The linear encodings are
+ * run on placeholder literals into a ClauseCounter, so their (recursive)
+ * structure does not have to be duplicated here.
+ *
+ * @param n Number of literals
+ * @param mode CNF conversion mode
+ * @param policy At-most-one encoding
+ * @return Auxiliary variables and clauses of the encoding
+ */
+EncodingCost EncodingEstimator::estimate_at_most_one(uint64_t n, CNFMode mode, const AtMostOnePolicy& policy) {
+    if (policy.is_pairwise(n)) {
+        uint64_t pairs = saturating_mul(n, n == 0 ? 0 : n - 1) / 2;
+        return make_cost(0, pairs, saturating_mul(2, pairs));
+    }
+
+    CNFModel scratch;
+    ClauseCounter counter;
+    RelationEncoder encoder(scratch, counter, mode);
+    encoder.set_at_most_one_policy(policy);
+    std::vector<int> literals(n);
+    for (uint64_t i = 0; i < n; ++i) {
+        literals[i] = static_cast<int>(i + 1);
+    }
+    encoder.encode_at_most_one(literals);
+    return make_cost(scratch.get_num_auxiliary_variables(), counter.get_num_clauses(), counter.get_num_literals());
+}
+
+/**
+ * @brief Predicts the cost of the count bounds of a cardinality group
+ *
+ * Runs RelationEncoder::encode_cardinality_bounds() on placeholder literals
+ * into a ClauseCounter.
+ *
+ * @param relation Cardinality relation
+ * @param mode CNF conversion mode
+ * @param policy Count-bound encoding
+ * @return Auxiliary variables and clauses of the bounds (without "child implies parent")
+ */
+EncodingCost EncodingEstimator::estimate_cardinality(const Relation& relation, CNFMode mode,
+                                                     const CardinalityPolicy& policy) {
+    CNFModel scratch;
+    ClauseCounter counter;
+    RelationEncoder encoder(scratch, counter, mode);
+    encoder.set_cardinality_policy(policy);
+    std::vector<int> literals(relation.get_children().size());
+    for (size_t i = 0; i < literals.size(); ++i) {
+        literals[i] = static_cast<int>(i + 2);
+    }
+    encoder.encode_cardinality_bounds(1, literals, relation.get_card_min(), relation.get_card_max());
+    return make_cost(scratch.get_num_auxiliary_variables(), counter.get_num_clauses(), counter.get_num_literals());
+}
+
+/**
+ * @brief Predicts the straightforward cost of a constraint expression
+ *
+ * Computes the clauses and literals of both polarities at once, following
+ * ASTNode::to_nnf(): a negation swaps them, De Morgan turns a negated AND
+ * into an OR, and an equivalence becomes an OR of two ANDs. This visits
+ * each node once, even though the NNF duplicates the operands of every
+ * equivalence.
+ *
+ * @param node AST node
+ * @param positive Output: clauses and literals of the NNF of the node
+ * @param negative Output: clauses and literals of the NNF of its negation
+ */
+void EncodingEstimator::estimate_direct(const ASTNode& node, EncodingCost& positive, EncodingCost& negative) {
+    if (node.get_type() != ASTNode::Type::OPERATION || !node.is_boolean_operation()) {
+        // Feature literal (or atom): one unit clause either way
+        positive = make_cost(0, 1, 1);
+        negative = make_cost(0, 1, 1);
+        return;
+    }
+
+    if (node.get_operation() == ASTOperation::NOT) {
+        require_children(node, 1, "NOT");
+        estimate_direct(*node.get_children()[0], negative, positive);
+        return;
+    }
+
+    require_children(node, 2, "Binary operation");
+    EncodingCost left_pos, left_neg, right_pos, right_neg;
+    estimate_direct(*node.get_children()[0], left_pos, left_neg);
+    estimate_direct(*node.get_children()[1], right_pos, right_neg);
+
+    switch (node.get_operation()) {
+        case ASTOperation::AND:
+            positive = conjunction(left_pos, right_pos);
+            negative = disjunction(left_neg, right_neg);
+            break;
+        case ASTOperation::OR:
+            positive = disjunction(left_pos, right_pos);
+            negative = conjunction(left_neg, right_neg);
+            break;
+        case ASTOperation::IMPLIES:
+            positive = disjunction(left_neg, right_pos);
+            negative = conjunction(left_pos, right_neg);
+            break;
+        case ASTOperation::EQUIVALENCE:
+            positive = disjunction(conjunction(left_pos, right_pos), conjunction(left_neg, right_neg));
+            negative = disjunction(conjunction(left_pos, right_neg), conjunction(left_neg, right_pos));
+            break;
+        default:
+            throw std::runtime_error("Unsupported operation in NNF conversion: " + node.to_string());
+    }
+}
@@ -0,0 +1,206 @@
+/**
+ * @file EquivalenceReducer.cc
+ * @brief Implementation of equivalent-literal substitution
+ *
+ * Literals are mapped to graph nodes as 2 * (var - 1) for var and
+ * 2 * (var - 1) + 1 for -var, so the negation of node n is n ^ 1.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "EquivalenceReducer.hh"
+#include "ClauseNormalizer.hh"
+#include <cstdlib>
+#include <cstdint>
+#include <limits>
+
+namespace {
+    /**
+     * @brief Maps a literal to its graph node
+     */
+    inline uint32_t literal_node(int literal) {
+        return 2 * static_cast<uint32_t>(std::abs(literal) - 1) + (literal < 0 ? 1 : 0);
+    }
+
+    /**
+     * @brief Maps a graph node back to its literal
+     */
+    inline int node_literal(uint32_t node) {
+        int var = static_cast<int>(node / 2) + 1;
+        return (node & 1) ? -var : var;
+    }
+}
+
+/**
+ * @brief Constructs a reducer with all statistics at zero
+ */
+EquivalenceReducer::EquivalenceReducer()
+    : merged_variables(0), removed_clauses(0), rounds(0), unsatisfiable(false) {
+}
+
+/**
+ * @brief Merges equivalent variables of a CNF model in place
+ *
+ * Each round computes the representatives, renumbers the surviving variables
+ * in their original order and lets ClauseNormalizer (without subsumption)
+ * remove the clauses that became tautologies or duplicates.
+ *
+ * @param model CNF model to reduce
+ */
+void EquivalenceReducer::reduce(CNFModel& model) {
+    merged_variables = 0;
+    removed_clauses = 0;
+    rounds = 0;
+    unsatisfiable = false;
+
+    std::vector<int> representative;
+    while (true) {
+        size_t merged = find_representatives(model, representative);
+        if (merged == 0) {
+            break;
+        }
+
+        // Surviving variables are the representatives; number them in order
+        int num_variables = model.get_num_variables();
+        std::vector<int> new_id(num_variables + 1, 0);
+        int next_id = 1;
+        for (int var = 1; var <= num_variables; ++var) {
+            if (representative[var] == var) {
+                new_id[var] = next_id++;
+            }
+        }
+
+        std::vector<int> literal_map(num_variables + 1, 0);
+        for (int var = 1; var <= num_variables; ++var) {
+            int rep = representative[var];
+            literal_map[var] = rep > 0 ? new_id[rep] : -new_id[-rep];
+        }
+
+        int clauses_before = model.get_num_clauses();
+        model.remap_variables(literal_map);
+
+        ClauseNormalizer normalizer;
+        normalizer.set_subsumption(false);
+        normalizer.normalize(model);
+
+        merged_variables += merged;
+        removed_clauses += static_cast<size_t>(clauses_before - model.get_num_clauses());
+        rounds++;
+    }
+}
+
+/**
+ * @brief Computes the representative literal of every variable
+ *
+ * Runs an iterative Tarjan SCC search over the binary implication graph
+ * stored in compressed (CSR) form.
+ *
+ * @param model CNF model whose binary clauses are analyzed
+ * @param representative Output: representative[v] is the literal equal to v
+ * @return Number of merged variables, or 0 if a contradiction was found
+ */
+size_t EquivalenceReducer::find_representatives(const CNFModel& model, std::vector<int>& representative) {
+    const uint32_t num_variables = static_cast<uint32_t>(model.get_num_variables());
+    const uint32_t num_nodes = 2 * num_variables;
+    const uint32_t UNVISITED = std::numeric_limits<uint32_t>::max();
+
+    // Build the implication graph: (a | b) gives -a -> b and -b -> a
+    std::vector<uint32_t> edge_start(num_nodes + 1, 0);
+    for (int c = 0; c < model.get_num_clauses(); ++c) {
+        ClauseView clause = model.get_clause(c);
+        if (clause.size() == 2) {
+            edge_start[literal_node(-clause[0]) + 1]++;
+            edge_start[literal_node(-clause[1]) + 1]++;
+        }
+    }
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+        edge_start[n + 1] += edge_start[n];
+    }
+    std::vector<uint32_t> edges(edge_start[num_nodes]);
+    std::vector<uint32_t> fill(edge_start.begin(), edge_start.end() - 1);
+    for (int c = 0; c < model.get_num_clauses(); ++c) {
+        ClauseView clause = model.get_clause(c);
+        if (clause.size() == 2) {
+            edges[fill[literal_node(-clause[0])]++] = literal_node(clause[1]);
+            edges[fill[literal_node(-clause[1])]++] = literal_node(clause[0]);
+        }
+    }
+
+    // Iterative Tarjan
+    std::vector<uint32_t> index(num_nodes, UNVISITED);
+    std::vector<uint32_t> lowlink(num_nodes, 0);
+    std::vector<uint32_t> component(num_nodes, UNVISITED);
+    std::vector<char> on_stack(num_nodes, 0);
+    std::vector<uint32_t> scc_stack;
+    std::vector<std::pair<uint32_t, uint32_t>> call_stack;  // node, next edge
+    std::vector<uint32_t> component_rep;                     // smallest-variable node per component
+    uint32_t next_index = 0;
+
+    for (uint32_t root = 0; root < num_nodes; ++root) {
+        if (index[root] != UNVISITED) {
+            continue;
+        }
+        call_stack.emplace_back(root, edge_start[root]);
+        index[root] = lowlink[root] = next_index++;
+        scc_stack.push_back(root);
+        on_stack[root] = 1;
+
+        while (!call_stack.empty()) {
+            uint32_t node = call_stack.back().first;
+            uint32_t& edge = call_stack.back().second;
+
+            if (edge < edge_start[node + 1]) {
+                uint32_t next = edges[edge++];
+                if (index[next] == UNVISITED) {
+                    index[next] = lowlink[next] = next_index++;
+                    scc_stack.push_back(next);
+                    on_stack[next] = 1;
+                    call_stack.emplace_back(next, edge_start[next]);
+                } else if (on_stack[next] && index[next] < lowlink[node]) {
+                    lowlink[node] = index[next];
+                }
+                continue;
+            }
+
+            call_stack.pop_back();
+            if (!call_stack.empty()) {
+                uint32_t parent = call_stack.back().first;
+                if (lowlink[node] < lowlink[parent]) {
+                    lowlink[parent] = lowlink[node];
+                }
+            }
+
+            if (lowlink[node] == index[node]) {
+                uint32_t id = static_cast<uint32_t>(component_rep.size());
+                uint32_t best = node;
+                uint32_t member;
+                do {
+                    member = scc_stack.back();
+                    scc_stack.pop_back();
+                    on_stack[member] = 0;
+                    component[member] = id;
+                    if (member < best) {
+                        best = member;
+                    }
+                } while (member != node);
+                component_rep.push_back(best);
+            }
+        }
+    }
+
+    representative.assign(num_variables + 1, 0);
+    size_t merged = 0;
+    for (uint32_t var = 1; var <= num_variables; ++var) {
+        uint32_t positive = literal_node(static_cast<int>(var));
+        if (component[positive] == component[positive ^ 1]) {
+            unsatisfiable = true;
+            return 0;
+        }
+        representative[var] = node_literal(component_rep[component[positive]]);
+        if (representative[var] != static_cast<int>(var)) {
+            merged++;
+        }
+    }
+    return merged;
+}
@@ -10,9 +10,11 @@
  * 3. **Relation constraints**: Parent-child relationships encoded to CNF
  * 4. **Cross-tree constraints**: Boolean expressions converted to CNF
  *
- * The transformation supports two CNF conversion modes:
+ * The transformation supports these CNF conversion modes:
  * - STRAIGHTFORWARD: Direct conversion (may produce long clauses)
  * - TSEITIN: Uses auxiliary variables (shorter clauses, more variables)
+ * - PLAISTED_GREENBAUM: One-sided Tseitin (not count-preserving)
+ * - HYBRID: Direct relations, and direct or Tseitin per constraint
  *
  * @author UVL2Dimacs Team
  * @date 2024
@@ -20,7 +22,72 @@
 
 #include "FMToCNF.hh"
 #include "RelationEncoder.hh"
+#include "FixedValueSink.hh"
+#include "EncodingEstimator.hh"
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace {
+    /// Longest expression quoted in resource limit messages
+    const size_t MAX_DESCRIBED_LENGTH = 80;
+
+    /// Relations and constraints a worker encodes in one go
+    const size_t CHUNK_SIZE = 64;
+
+    /// Chunks per worker that may be encoded ahead of the merge
+    const size_t CHUNKS_AHEAD = 4;
+
+    /**
+     * @brief Clauses of consecutive relations and constraints encoded by a worker
+     */
+    struct EncodedChunk {
+        ClauseBuffer clauses;                      ///< Clauses, auxiliaries numbered by the worker
+        int first_aux = 0;                         ///< Worker's ID of the first auxiliary of the chunk
+        std::vector<CNFModel::AuxKind> aux_kinds;  ///< Kinds of the chunk's auxiliaries, in creation order
+        std::exception_ptr error;                  ///< Exception thrown while encoding
+        bool done = false;                         ///< Ready to be merged
+    };
+
+    /**
+     * @brief Copies the variables of a model without its clauses
+     *
+     * @param model Model whose variable table is copied
+     * @return Model with the same variable IDs, names and kinds
+     */
+    CNFModel copy_variables(const CNFModel& model) {
+        CNFModel copy;
+        for (int var = 1; var <= model.get_num_variables(); ++var) {
+            if (model.is_auxiliary(var)) {
+                copy.create_auxiliary_variable(model.get_aux_kind(var));
+            } else {
+                copy.add_feature(model.get_feature_name(var));
+            }
+        }
+        return copy;
+    }
+
+    /**
+     * @brief Describes a constraint expression for resource limit messages
+     *
+     * @param constraint Cross-tree constraint
+     * @return "(<expression>)", shortened to MAX_DESCRIBED_LENGTH characters
+     */
+    std::string describe(const Constraint& constraint) {
+        if (!constraint.get_ast()) {
+            return "";
+        }
+        std::string expression = constraint.get_ast()->to_string();
+        if (expression.size() > MAX_DESCRIBED_LENGTH) {
+            expression = expression.substr(0, MAX_DESCRIBED_LENGTH - 3) + "...";
+        }
+        return "(" + expression + ")";
+    }
+}
 
 /**
  * @brief Constructs a transformer for the given feature model
@@ -28,7 +95,18 @@
  * @param model The feature model to transform
  */
 FMToCNF::FMToCNF(std::shared_ptr<FeatureModel> model)
-    : source_model(model), mode(CNFMode::STRAIGHTFORWARD) {
+    : source_model(model), mode(CNFMode::STRAIGHTFORWARD), sink(&cnf_model),
+      use_structural(false), num_core_features(0), num_dead_features(0),
+      num_simplified_clauses(0), void_model(false), num_tseitin_constraints(0), budget(nullptr), num_threads(1) {
+}
+
+/**
+ * @brief Sets the number of threads encoding relations and constraints
+ *
+ * @param threads Number of worker threads (0 = one per hardware thread)
+ */
+void FMToCNF::set_num_threads(unsigned threads) {
+    num_threads = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
 }
 
 /**
@@ -40,6 +118,10 @@ FMToCNF::FMToCNF(std::shared_ptr<FeatureModel> model)
  * 3. Encode all parent-child relations
  * 4. Convert cross-tree constraints to CNF
  *
+ * The resulting model is moved out of the transformer rather than copied, so
+ * the clause arena is handed to the caller without duplication. A transformer
+ * is therefore meant to be used for a single transform() call.
+ *
  * @param conversion_mode CNF conversion mode (STRAIGHTFORWARD or TSEITIN)
  * @return CNF model ready for DIMACS output
  */
@@ -49,17 +131,35 @@ CNFModel FMToCNF::transform(CNFMode conversion_mode) {
 
     // Step 1: Add all features as variables
     add_features();
+    analyze_structure();
 
-    // Step 2: Add root constraint (root must be true)
-    add_root();
+    // Steps 2-4: Add root constraint, relation constraints and cross-tree constraints
+    add_clauses();
+
+    return std::move(cnf_model);
+}
+
+/**
+ * @brief Transforms the feature model to CNF, emitting clauses to a sink
+ *
+ * Runs the same four steps as transform(CNFMode), in the same order, so the
+ * sink receives exactly the clauses the in-memory model would contain.
+ *
+ * @param out Destination of the generated clauses
+ * @param conversion_mode CNF conversion mode (STRAIGHTFORWARD or TSEITIN)
+ */
+void FMToCNF::transform(ClauseSink& out, CNFMode conversion_mode) {
+    mode = conversion_mode;
+    sink = &out;
 
-    // Step 3: Add relation constraints
-    add_relations();
+    add_features();
+    analyze_structure();
+    out.begin_formula(cnf_model);
 
-    // Step 4: Add cross-tree constraints
-    add_constraints();
+    add_clauses();
 
-    return cnf_model;
+    out.end_formula(cnf_model);
+    sink = &cnf_model;
 }
 
 /**
@@ -76,6 +176,74 @@ void FMToCNF::add_features() {
     }
 }
 
+/**
+ * @brief Emits the root, relation and constraint clauses
+ *
+ * The original sink is restored even if the budget is exceeded. Gates are
+ * only shared within one transformation.
+ */
+void FMToCNF::add_clauses() {
+    gate_cache.clear();
+    if (budget == nullptr) {
+        add_root();
+        if (num_threads > 1 && supports_threads(mode, sink->has_native_cardinality())) {
+            add_in_parallel();
+        } else {
+            add_relations();
+            add_constraints();
+        }
+        return;
+    }
+
+    ClauseSink* target = sink;
+    BudgetSink limited(*target, *budget);
+    sink = &limited;
+    try {
+        add_root();
+        add_relations();
+        add_constraints();
+    } catch (...) {
+        sink = target;
+        throw;
+    }
+    sink = target;
+}
+
+/**
+ * @brief Derives core and dead features and records their variable values
+ *
+ * The values are indexed by CNF variable ID. When the analysis finds the
+ * model void, only that fact is recorded and the clauses are emitted
+ * unchanged.
+ */
+void FMToCNF::analyze_structure() {
+    fixed_values.clear();
+    num_core_features = 0;
+    num_dead_features = 0;
+    num_simplified_clauses = 0;
+    void_model = false;
+    if (!use_structural) {
+        return;
+    }
+
+    StructuralAnalyzer analyzer(source_model);
+    analyzer.analyze();
+    if (analyzer.is_void()) {
+        void_model = true;
+        return;
+    }
+
+    fixed_values.assign(cnf_model.get_num_variables() + 1, 0);
+    for (const auto& name : analyzer.get_core_features()) {
+        fixed_values[cnf_model.get_variable(name)] = 1;
+        num_core_features++;
+    }
+    for (const auto& name : analyzer.get_dead_features()) {
+        fixed_values[cnf_model.get_variable(name)] = -1;
+        num_dead_features++;
+    }
+}
+
 /**
  * @brief Adds the root constraint
  *
@@ -91,7 +259,15 @@ void FMToCNF::add_root() {
     }
 
     int root_var = cnf_model.get_variable(root->get_name());
-    cnf_model.add_clause({root_var});
+    sink->add_clause({root_var});
+
+    // Assert the other structurally fixed features
+    for (size_t var = 1; var < fixed_values.size(); ++var) {
+        if (fixed_values[var] != 0 && static_cast<int>(var) != root_var) {
+            int lit = static_cast<int>(var);
+            sink->add_clause({fixed_values[var] > 0 ? lit : -lit});
+        }
+    }
 }
 
 /**
@@ -101,12 +277,23 @@ void FMToCNF::add_root() {
  * (MANDATORY, OPTIONAL, OR, ALTERNATIVE, CARDINALITY) into CNF clauses.
  */
 void FMToCNF::add_relations() {
-    RelationEncoder encoder(cnf_model, mode);
+    FixedValueSink simplifier(*sink, fixed_values);
+    ClauseSink& out = fixed_values.empty() ? *sink : simplifier;
+    RelationEncoder encoder(cnf_model, out, mode);
+    encoder.set_at_most_one_policy(amo_policy);
+    encoder.set_cardinality_policy(card_policy);
+    encoder.set_gate_cache(is_three_cnf(mode) ? &gate_cache : nullptr);
 
     auto relations = source_model->get_relations();
     for (const auto& relation : relations) {
+        if (budget != nullptr) {
+            EncodingCostItem predicted = EncodingEstimator::estimate_relation(*relation, mode, amo_policy, card_policy);
+            budget->set_context("relation '" + predicted.name + "'");
+            budget->reserve(predicted.cost, false);
+        }
         encoder.encode_relation(relation);
     }
+    num_simplified_clauses += simplifier.get_removed_clauses();
 }
 
 /**
@@ -117,13 +304,19 @@ void FMToCNF::add_relations() {
  * silently skipped as they cannot be represented in pure CNF.
  *
  * The conversion mode (STRAIGHTFORWARD or TSEITIN) is passed to each constraint
- * to determine how boolean operations are encoded.
+ * to determine how boolean operations are encoded. In HYBRID mode it is
+ * chosen per constraint by EncodingEstimator::choose_constraint_mode().
  */
 void FMToCNF::add_constraints() {
     const auto& constraints = source_model->get_constraints();
 
     int total_constraints = constraints.size();
     int skipped_constraints = 0;
+    num_tseitin_constraints = 0;
+
+    FixedValueSink simplifier(*sink, fixed_values);
+    ClauseSink& out = fixed_values.empty() ? *sink : simplifier;
+    GateCache* gates = mode == CNFMode::STRAIGHTFORWARD ? nullptr : &gate_cache;
 
     for (const auto& constraint : constraints) {
         // Skip non-boolean constraints (comparison, arithmetic)
@@ -133,6 +326,20 @@ void FMToCNF::add_constraints() {
             continue;
         }
 
+        CNFMode constraint_mode = mode;
+        if (mode == CNFMode::HYBRID) {
+            constraint_mode = EncodingEstimator::choose_constraint_mode(*constraint);
+        }
+        if (is_three_cnf(constraint_mode)) {
+            num_tseitin_constraints++;
+        }
+
+        if (budget != nullptr) {
+            EncodingCostItem predicted = EncodingEstimator::estimate_constraint(*constraint, constraint_mode);
+            budget->set_context("constraint '" + predicted.name + "' " + describe(*constraint));
+            budget->reserve(predicted.cost, constraint_mode == CNFMode::STRAIGHTFORWARD);
+        }
+
         // Create lambda functions for variable lookup and auxiliary variable creation
         auto get_variable = [this](const std::string& name) -> int {
             if (!cnf_model.has_variable(name)) {
@@ -145,12 +352,10 @@ void FMToCNF::add_constraints() {
             return cnf_model.create_auxiliary_variable();
         };
 
-        // Get clauses from constraint and add to CNF model
-        auto clauses = constraint->get_clauses(get_variable, create_aux_var, mode);
-        for (const auto& clause : clauses) {
-            cnf_model.add_clause(clause);
-        }
+        // Emit the constraint's clauses to the sink
+        constraint->get_clauses(out, get_variable, create_aux_var, constraint_mode, gates);
     }
+    num_simplified_clauses += simplifier.get_removed_clauses();
 
     // Report skipped constraints if any
     if (skipped_constraints > 0) {
@@ -158,3 +363,175 @@ void FMToCNF::add_constraints() {
         // For now, we silently skip (error reporting happens at a higher level)
     }
 }
+
+/**
+ * @brief Encodes relations and constraints on worker threads
+ *
+ * The relations followed by the constraints are cut into chunks of
+ * CHUNK_SIZE items. Workers take the next chunk as soon as they are idle and
+ * encode it into a ClauseBuffer against a private copy of the variable table,
+ * so their auxiliary variables get private IDs above the shared ones. This
+ * thread merges the chunks in order: it creates each chunk's auxiliaries in
+ * the real table, shifts the private IDs onto them and forwards the clauses.
+ * Chunks without auxiliaries, or whose private IDs already are the final
+ * ones, are forwarded straight from the buffer without copying a literal.
+ * As no relation or constraint depends on another in straightforward mode,
+ * the result is identical to the sequential encoding. Workers stay at most
+ * CHUNKS_AHEAD chunks each ahead of the merge to bound the buffered clauses.
+ *
+ * An exception from a chunk is rethrown when the merge reaches it, after the
+ * clauses of all previous chunks, as in the sequential encoding.
+ */
+void FMToCNF::add_in_parallel() {
+    auto relations = source_model->get_relations();
+    const auto& constraints = source_model->get_constraints();
+    size_t num_items = relations.size() + constraints.size();
+    std::vector<EncodedChunk> chunks((num_items + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+    // Variables above num_shared are auxiliaries numbered by a worker
+    const CNFModel shared_variables = copy_variables(cnf_model);
+    const int num_shared = shared_variables.get_num_variables();
+    num_tseitin_constraints = 0;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t next_chunk = 0;
+    size_t num_merged = 0;
+    bool stopped = false;
+    const size_t max_ahead = CHUNKS_AHEAD * num_threads;
+
+    auto encode_chunks = [&]() {
+        CNFModel variables(shared_variables);
+        ClauseBuffer buffer;
+        RelationEncoder encoder(variables, buffer, mode);
+        encoder.set_at_most_one_policy(amo_policy);
+        encoder.set_cardinality_policy(card_policy);
+
+        auto get_variable = [&variables](const std::string& name) -> int {
+            if (!variables.has_variable(name)) {
+                throw std::runtime_error("Constraint references undefined feature: " + name);
+            }
+            return variables.get_variable(name);
+        };
+        auto create_aux_var = [&variables]() -> int {
+            return variables.create_auxiliary_variable();
+        };
+
+        while (true) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] {
+                    return stopped || next_chunk == chunks.size() || next_chunk < num_merged + max_ahead;
+                });
+                if (stopped || next_chunk == chunks.size()) {
+                    return;
+                }
+                index = next_chunk++;
+            }
+
+            EncodedChunk& chunk = chunks[index];
+            chunk.first_aux = variables.get_num_variables() + 1;
+            try {
+                size_t last = std::min(num_items, (index + 1) * CHUNK_SIZE);
+                for (size_t item = index * CHUNK_SIZE; item < last; ++item) {
+                    if (item < relations.size()) {
+                        encoder.encode_relation(relations[item]);
+                        continue;
+                    }
+                    // Non-boolean constraints are skipped, as in add_constraints()
+                    const auto& constraint = constraints[item - relations.size()];
+                    if (constraint->is_pure_boolean()) {
+                        constraint->get_clauses(buffer, get_variable, create_aux_var, mode);
+                    }
+                }
+            } catch (...) {
+                chunk.error = std::current_exception();
+            }
+            for (int var = chunk.first_aux; var <= variables.get_num_variables(); ++var) {
+                chunk.aux_kinds.push_back(variables.get_aux_kind(var));
+            }
+            chunk.clauses = std::move(buffer);
+            buffer.clear();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                chunk.done = true;
+            }
+            changed.notify_all();
+        }
+    };
+
+    FixedValueSink simplifier(*sink, fixed_values);
+    ClauseSink& out = fixed_values.empty() ? *sink : simplifier;
+    std::vector<std::thread> workers;
+    std::vector<int> clause;
+    try {
+        for (unsigned i = 0; i < num_threads; ++i) {
+            workers.emplace_back(encode_chunks);
+        }
+
+        for (EncodedChunk& chunk : chunks) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&chunk] { return chunk.done; });
+            }
+            if (chunk.error) {
+                std::rethrow_exception(chunk.error);
+            }
+
+            // The chunk's auxiliaries take the next IDs, in creation order
+            int shift = cnf_model.get_num_variables() + 1 - chunk.first_aux;
+            for (CNFModel::AuxKind kind : chunk.aux_kinds) {
+                cnf_model.create_auxiliary_variable(kind);
+            }
+            const std::vector<int>& literals = chunk.clauses.get_literals();
+            if (shift == 0 || chunk.aux_kinds.empty()) {
+                // No literal needs a new ID: forward the buffered clauses in place
+                const int* start = literals.data();
+                const int* end = start + literals.size();
+                for (const int* it = start; it != end; ++it) {
+                    if (*it == 0) {
+                        out.add_clause(start, it);
+                        start = it + 1;
+                    }
+                }
+            } else {
+                for (int literal : literals) {
+                    if (literal == 0) {
+                        out.add_clause(clause.data(), clause.data() + clause.size());
+                        clause.clear();
+                    } else if (literal > num_shared) {
+                        clause.push_back(literal + shift);
+                    } else if (literal < -num_shared) {
+                        clause.push_back(literal - shift);
+                    } else {
+                        clause.push_back(literal);
+                    }
+                }
+            }
+            chunk.clauses.clear();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                num_merged++;
+            }
+            changed.notify_all();
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        changed.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        throw;
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    num_simplified_clauses += simplifier.get_removed_clauses();
+}
@@ -0,0 +1,322 @@
+/**
+ * @file FeatureSlicer.cc
+ * @brief Implementation of feature projection by variable elimination
+ *
+ * The clause database is a vector of clauses with lazily cleaned occurrence
+ * lists: deleted clauses are only flagged and are skipped (and dropped from
+ * the lists) the next time a list is visited.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "FeatureSlicer.hh"
+#include "ClauseNormalizer.hh"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+    /**
+     * @brief Maps a literal to a dense index (2 * (var - 1) + sign)
+     */
+    inline size_t literal_index(int literal) {
+        return 2 * static_cast<size_t>(std::abs(literal) - 1) + (literal < 0 ? 1 : 0);
+    }
+
+    /**
+     * @brief Literal order used inside clauses (by variable, negative first)
+     */
+    inline bool literal_less(int a, int b) {
+        int va = std::abs(a);
+        int vb = std::abs(b);
+        return va < vb || (va == vb && a < b);
+    }
+}
+
+/**
+ * @brief Constructs a slicer keeping the given features
+ *
+ * @param features Names of the features to keep
+ */
+FeatureSlicer::FeatureSlicer(const std::vector<std::string>& features)
+    : keep_features(features), max_growth(DEFAULT_MAX_GROWTH), max_clauses(DEFAULT_MAX_CLAUSES),
+      kept_variables(0), eliminated_variables(0), num_live_clauses(0), current_stamp(0) {
+}
+
+/**
+ * @brief Projects a CNF model onto the kept features
+ *
+ * @param model CNF model rewritten in place
+ * @throws std::invalid_argument if a kept feature is not in the model
+ * @throws std::runtime_error if eliminating a variable exceeds the clause limit
+ */
+void FeatureSlicer::slice(CNFModel& model) {
+    int num_variables = model.get_num_variables();
+    std::vector<char> kept = find_kept_variables(model);
+    kept_variables = static_cast<size_t>(std::count(kept.begin(), kept.end(), 1));
+    eliminated_variables = 0;
+
+    // Load the clauses in normalized form
+    clauses.clear();
+    deleted.clear();
+    num_live_clauses = 0;
+    occurrences.assign(2 * static_cast<size_t>(num_variables), {});
+    stamp.assign(2 * static_cast<size_t>(num_variables), 0);
+    current_stamp = 0;
+    for (int c = 0; c < model.get_num_clauses(); ++c) {
+        ClauseView view = model.get_clause(c);
+        std::vector<int> clause(view.begin(), view.end());
+        std::sort(clause.begin(), clause.end(), literal_less);
+        clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+        bool tautology = false;
+        for (size_t i = 1; i < clause.size() && !tautology; ++i) {
+            tautology = clause[i] == -clause[i - 1];
+        }
+        if (!tautology) {
+            add_clause(std::move(clause));
+        }
+    }
+
+    // Phase 1: auxiliary variables, then features children before parents
+    std::vector<char> eliminated(num_variables + 1, 0);
+    std::vector<int> candidates;
+    for (int var = 1; var <= num_variables; ++var) {
+        if (!kept[var] && model.is_auxiliary(var)) {
+            candidates.push_back(var);
+        }
+    }
+    for (int var = num_variables; var >= 1; --var) {
+        if (!kept[var] && !model.is_auxiliary(var)) {
+            candidates.push_back(var);
+        }
+    }
+    for (int var : candidates) {
+        if (try_eliminate(var, 0)) {
+            eliminated[var] = 1;
+        }
+    }
+
+    // Phase 2: bounded elimination, cheapest variables first
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        std::vector<std::pair<uint64_t, int>> costs;
+        for (int var = 1; var <= num_variables; ++var) {
+            if (!kept[var] && !eliminated[var]) {
+                uint64_t pos = live_occurrences(var).size();
+                uint64_t neg = live_occurrences(-var).size();
+                costs.emplace_back(pos * neg, var);
+            }
+        }
+        std::sort(costs.begin(), costs.end());
+        for (const auto& cost : costs) {
+            if (try_eliminate(cost.second, max_growth)) {
+                eliminated[cost.second] = 1;
+                progress = true;
+            }
+        }
+    }
+
+    // Phase 3: the rest, whatever the growth, within the clause limit
+    std::vector<int> leftover;
+    for (int var = 1; var <= num_variables; ++var) {
+        if (!kept[var] && !eliminated[var]) {
+            leftover.push_back(var);
+        }
+    }
+    while (!leftover.empty()) {
+        size_t best = 0;
+        uint64_t best_cost = UINT64_MAX;
+        for (size_t i = 0; i < leftover.size(); ++i) {
+            uint64_t pos = live_occurrences(leftover[i]).size();
+            uint64_t neg = live_occurrences(-leftover[i]).size();
+            if (pos * neg < best_cost) {
+                best_cost = pos * neg;
+                best = i;
+            }
+        }
+        int var = leftover[best];
+        size_t growth = num_live_clauses < max_clauses ? max_clauses - num_live_clauses : 0;
+        if (!try_eliminate(var, growth)) {
+            std::ostringstream message;
+            message << "Feature slicing exceeds " << max_clauses << " clauses when eliminating ";
+            model.write_variable_name(message, var);
+            message << "; keep more features";
+            throw std::runtime_error(message.str());
+        }
+        eliminated[var] = 1;
+        leftover.erase(leftover.begin() + static_cast<std::ptrdiff_t>(best));
+    }
+
+    // Rebuild the arena from the surviving clauses
+    std::vector<int> out_literals;
+    std::vector<size_t> out_offsets{0};
+    for (size_t c = 0; c < clauses.size(); ++c) {
+        if (!deleted[c]) {
+            out_literals.insert(out_literals.end(), clauses[c].begin(), clauses[c].end());
+            out_offsets.push_back(out_literals.size());
+        }
+    }
+    clauses.clear();
+    deleted.clear();
+    occurrences.clear();
+    stamp.clear();
+    model.replace_clauses(std::move(out_literals), std::move(out_offsets));
+
+    // Drop the eliminated variables from the table
+    std::vector<int> literal_map(num_variables + 1, 0);
+    int next = 0;
+    for (int var = 1; var <= num_variables; ++var) {
+        if (eliminated[var]) {
+            eliminated_variables++;
+        } else {
+            literal_map[var] = ++next;
+        }
+    }
+    model.remap_variables(literal_map);
+
+    ClauseNormalizer normalizer;
+    normalizer.normalize(model);
+}
+
+/**
+ * @brief Marks the variables of the kept features
+ *
+ * Features merged into another variable (by EquivalenceReducer) keep the
+ * variable they are equal to.
+ *
+ * @param model CNF model
+ * @return Per variable ID: 1 if kept
+ * @throws std::invalid_argument if a feature is not in the model
+ */
+std::vector<char> FeatureSlicer::find_kept_variables(const CNFModel& model) const {
+    std::vector<char> kept(model.get_num_variables() + 1, 0);
+    std::unordered_set<std::string> pending(keep_features.begin(), keep_features.end());
+
+    for (const auto& name : keep_features) {
+        auto it = model.get_variables().find(name);
+        if (it != model.get_variables().end()) {
+            kept[it->second] = 1;
+            pending.erase(name);
+        }
+    }
+    for (size_t i = 0; i < model.get_num_aliases() && !pending.empty(); ++i) {
+        if (model.is_auxiliary_alias(i)) {
+            continue;
+        }
+        std::ostringstream name;
+        model.write_alias_name(name, i);
+        if (pending.erase(name.str()) > 0) {
+            kept[std::abs(model.get_alias_literal(i))] = 1;
+        }
+    }
+
+    if (!pending.empty()) {
+        throw std::invalid_argument("Unknown feature to keep: " + *pending.begin());
+    }
+    return kept;
+}
+
+/**
+ * @brief Adds a clause to the database and its occurrence lists
+ *
+ * @param clause Sorted clause without repeated literals
+ */
+void FeatureSlicer::add_clause(std::vector<int>&& clause) {
+    uint32_t id = static_cast<uint32_t>(clauses.size());
+    for (int lit : clause) {
+        occurrences[literal_index(lit)].push_back(id);
+    }
+    clauses.push_back(std::move(clause));
+    deleted.push_back(0);
+    num_live_clauses++;
+}
+
+/**
+ * @brief Gets the live clauses containing a literal, dropping deleted ones
+ *
+ * @param literal Literal
+ * @return Occurrence list of the literal
+ */
+const std::vector<uint32_t>& FeatureSlicer::live_occurrences(int literal) {
+    auto& list = occurrences[literal_index(literal)];
+    list.erase(std::remove_if(list.begin(), list.end(),
+                              [this](uint32_t c) { return deleted[c] != 0; }),
+               list.end());
+    return list;
+}
+
+/**
+ * @brief Eliminates a variable if the clause growth stays within a limit
+ *
+ * @param var Variable to eliminate
+ * @param growth Number of clauses the elimination may add
+ * @return true if the variable was eliminated
+ */
+bool FeatureSlicer::try_eliminate(int var, size_t growth) {
+    std::vector<uint32_t> pos = live_occurrences(var);
+    std::vector<uint32_t> neg = live_occurrences(-var);
+    size_t limit = pos.size() + neg.size() + growth;
+
+    std::vector<std::vector<int>> resolvents;
+    for (uint32_t p : pos) {
+        // Mark the literals of p other than var
+        current_stamp++;
+        for (int lit : clauses[p]) {
+            if (lit != var) {
+                stamp[literal_index(lit)] = current_stamp;
+            }
+        }
+        for (uint32_t n : neg) {
+            bool tautology = false;
+            for (int lit : clauses[n]) {
+                if (lit != -var && stamp[literal_index(-lit)] == current_stamp) {
+                    tautology = true;
+                    break;
+                }
+            }
+            if (tautology) {
+                continue;
+            }
+            if (resolvents.size() == limit) {
+                return false;
+            }
+            std::vector<int> resolvent;
+            resolvent.reserve(clauses[p].size() + clauses[n].size() - 2);
+            for (int lit : clauses[p]) {
+                if (lit != var) {
+                    resolvent.push_back(lit);
+                }
+            }
+            for (int lit : clauses[n]) {
+                if (lit != -var && stamp[literal_index(lit)] != current_stamp) {
+                    resolvent.push_back(lit);
+                }
+            }
+            std::sort(resolvent.begin(), resolvent.end(), literal_less);
+            resolvents.push_back(std::move(resolvent));
+        }
+    }
+
+    std::sort(resolvents.begin(), resolvents.end());
+    resolvents.erase(std::unique(resolvents.begin(), resolvents.end()), resolvents.end());
+
+    for (uint32_t c : pos) {
+        deleted[c] = 1;
+    }
+    for (uint32_t c : neg) {
+        deleted[c] = 1;
+    }
+    num_live_clauses -= pos.size() + neg.size();
+    occurrences[literal_index(var)].clear();
+    occurrences[literal_index(-var)].clear();
+    for (auto& resolvent : resolvents) {
+        add_clause(std::move(resolvent));
+    }
+    return true;
+}
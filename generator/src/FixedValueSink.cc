@@ -0,0 +1,128 @@
+/**
+ * @file FixedValueSink.cc
+ * @brief Implementation of the fixed-value simplifying clause sink
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "FixedValueSink.hh"
+#include <cstdlib>
+
+/**
+ * @brief Constructs a sink forwarding to target
+ *
+ * @param target_sink Sink receiving the simplified clauses
+ * @param fixed_values Value per variable ID (1 true, -1 false, 0 unknown)
+ */
+FixedValueSink::FixedValueSink(ClauseSink& target_sink, const std::vector<int8_t>& fixed_values)
+    : target(target_sink), values(fixed_values), satisfied(false),
+      removed_clauses(0), removed_literals(0) {
+}
+
+/**
+ * @brief Starts a new clause
+ */
+void FixedValueSink::begin_clause() {
+    buffer.clear();
+    satisfied = false;
+}
+
+/**
+ * @brief Keeps unknown literals and records true ones
+ *
+ * @param literal Non-zero literal
+ */
+void FixedValueSink::add_literal(int literal) {
+    size_t var = static_cast<size_t>(std::abs(literal));
+    int8_t value = var < values.size() ? values[var] : 0;
+    if (value == 0) {
+        buffer.push_back(literal);
+    } else if ((value > 0) == (literal > 0)) {
+        satisfied = true;
+    } else {
+        removed_literals++;
+    }
+}
+
+/**
+ * @brief Forwards the simplified clause unless it is satisfied
+ */
+void FixedValueSink::end_clause() {
+    if (satisfied) {
+        removed_clauses++;
+        return;
+    }
+    target.add_clause(buffer.data(), buffer.data() + buffer.size());
+}
+
+/**
+ * @brief Keeps the unknown literals of an at-least constraint in the buffer
+ *
+ * @param bound Smallest number of true literals
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ * @return Bound left after subtracting the true literals
+ */
+int FixedValueSink::simplify_at_least(int bound, const int* first, const int* last) {
+    begin_clause();
+    for (const int* it = first; it != last; ++it) {
+        size_t var = static_cast<size_t>(std::abs(*it));
+        int8_t value = var < values.size() ? values[var] : 0;
+        if (value == 0) {
+            buffer.push_back(*it);
+        } else if ((value > 0) == (*it > 0)) {
+            bound--;
+        } else {
+            removed_literals++;
+        }
+    }
+    return bound;
+}
+
+/**
+ * @brief Forwards a simplified at-least constraint unless it is satisfied
+ *
+ * @param bound Smallest number of true literals
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ */
+void FixedValueSink::add_at_least(int bound, const int* first, const int* last) {
+    bound = simplify_at_least(bound, first, last);
+    if (bound <= 0) {
+        removed_clauses++;
+        return;
+    }
+    target.add_at_least(bound, buffer.data(), buffer.data() + buffer.size());
+}
+
+/**
+ * @brief Forwards a simplified guarded at-least constraint
+ *
+ * A false guard satisfies the constraint, a true guard leaves a plain
+ * at-least constraint.
+ *
+ * @param guard Literal that enables the constraint
+ * @param bound Smallest number of true literals if guard is true
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ */
+void FixedValueSink::add_guarded_at_least(int guard, int bound, const int* first, const int* last) {
+    size_t guard_var = static_cast<size_t>(std::abs(guard));
+    int8_t guard_value = guard_var < values.size() ? values[guard_var] : 0;
+    if (guard_value != 0) {
+        if ((guard_value > 0) == (guard > 0)) {
+            add_at_least(bound, first, last);
+        } else {
+            removed_clauses++;
+        }
+        return;
+    }
+
+    bound = simplify_at_least(bound, first, last);
+    if (bound <= 0) {
+        removed_clauses++;
+        return;
+    }
+    target.add_guarded_at_least(guard, bound, buffer.data(), buffer.data() + buffer.size());
+}
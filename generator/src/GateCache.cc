@@ -0,0 +1,126 @@
+/**
+ * @file GateCache.cc
+ * @brief Implementation of structural hashing of Tseitin gates
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "GateCache.hh"
+#include <algorithm>
+#include <utility>
+
+/**
+ * @brief Hashes the type and inputs of a canonical gate
+ *
+ * @param key Canonical gate
+ * @return Hash value
+ */
+size_t GateCache::KeyHash::operator()(const Key& key) const {
+    // FNV-1a over the input literals
+    uint64_t hash = key.equivalence ? 0x84222325cbf29ce4ULL : 0xcbf29ce484222325ULL;
+    for (int literal : key.inputs) {
+        hash ^= static_cast<uint32_t>(literal);
+        hash *= 0x100000001b3ULL;
+    }
+    return static_cast<size_t>(hash);
+}
+
+/**
+ * @brief Constructs an empty cache
+ */
+GateCache::GateCache()
+    : num_hits(0) {
+}
+
+/**
+ * @brief Looks up a gate
+ *
+ * @param type Gate type
+ * @param first Pointer to the first input literal
+ * @param last Pointer past the last input literal
+ * @param positive Whether "result → gate" is needed
+ * @param negative Whether "gate → result" is needed
+ * @return Literal defined for the gate with at least these directions, or 0
+ */
+int GateCache::find(GateType type, const int* first, const int* last, bool positive, bool negative) {
+    int sign = canonicalize(type, first, last);
+    if (sign < 0) {
+        // The negated gate needs the opposite directions of its canonical form
+        std::swap(positive, negative);
+    }
+
+    auto it = gates.find(scratch);
+    if (it == gates.end() || (positive && !it->second.positive) || (negative && !it->second.negative)) {
+        return 0;
+    }
+    num_hits++;
+    return sign * it->second.literal;
+}
+
+/**
+ * @brief Records the literal defined for a gate
+ *
+ * @param type Gate type
+ * @param first Pointer to the first input literal
+ * @param last Pointer past the last input literal
+ * @param positive Whether "result → gate" clauses were emitted
+ * @param negative Whether "gate → result" clauses were emitted
+ * @param result Literal defined for the gate
+ */
+void GateCache::insert(GateType type, const int* first, const int* last, bool positive, bool negative,
+                       int result) {
+    int sign = canonicalize(type, first, last);
+    if (sign < 0) {
+        std::swap(positive, negative);
+    }
+
+    Entry entry{sign * result, positive, negative};
+    auto inserted = gates.emplace(scratch, entry);
+    Entry& existing = inserted.first->second;
+    if (!inserted.second && ((positive && !existing.positive) || (negative && !existing.negative))) {
+        existing = entry;
+    }
+}
+
+/**
+ * @brief Forgets all gates and resets the statistics
+ */
+void GateCache::clear() {
+    gates.clear();
+    num_hits = 0;
+}
+
+/**
+ * @brief Builds the canonical key of a gate into scratch
+ *
+ * @param type Gate type
+ * @param first Pointer to the first input literal
+ * @param last Pointer past the last input literal
+ * @return Sign relating the gate to its canonical form (-1: negated)
+ */
+int GateCache::canonicalize(GateType type, const int* first, const int* last) {
+    scratch.equivalence = type == GateType::EQUIVALENCE;
+    scratch.inputs.assign(first, last);
+    int sign = 1;
+
+    if (type == GateType::OR) {
+        // a ∨ b = ¬(¬a ∧ ¬b)
+        for (int& literal : scratch.inputs) {
+            literal = -literal;
+        }
+        sign = -1;
+    } else if (type == GateType::EQUIVALENCE) {
+        // (¬a ⟺ b) = ¬(a ⟺ b)
+        for (int& literal : scratch.inputs) {
+            if (literal < 0) {
+                literal = -literal;
+                sign = -sign;
+            }
+        }
+    }
+
+    std::sort(scratch.inputs.begin(), scratch.inputs.end());
+    scratch.inputs.erase(std::unique(scratch.inputs.begin(), scratch.inputs.end()), scratch.inputs.end());
+    return sign;
+}
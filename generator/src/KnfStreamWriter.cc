@@ -0,0 +1,49 @@
+/**
+ * @file KnfStreamWriter.cc
+ * @brief Implementation of the streaming KNF clause sink
+ *
+ * A root feature 1 with an alternative group of features 2, 3 and 4 becomes:
+ *
+ * @code
+ * p knf 4          6
+ * ...
+ * 1 0
+ * -1 2 3 4 0
+ * k 2 -2 -3 -4 0
+ * -2 1 0
+ * -3 1 0
+ * -4 1 0
+ * @endcode
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "KnfStreamWriter.hh"
+
+/**
+ * @brief Opens the output file
+ *
+ * @param path Path to the output file
+ * @throws std::runtime_error if the file cannot be opened for writing
+ */
+KnfStreamWriter::KnfStreamWriter(const std::string& path)
+    : DimacsStreamWriter(path, "knf"), num_cardinality(0) {
+}
+
+/**
+ * @brief Writes a "k" line
+ *
+ * @param bound Smallest number of true literals
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ */
+void KnfStreamWriter::add_at_least(int bound, const int* first, const int* last) {
+    out << "k " << bound << ' ';
+    for (const int* it = first; it != last; ++it) {
+        out << *it << ' ';
+    }
+    out << "0\n";
+    num_clauses++;
+    num_cardinality++;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file OpbStreamWriter.cc
+ * @brief Implementation of the streaming OPB clause sink
+ *
+ * A root feature 1 with an alternative group of features 2, 3 and 4 becomes:
+ *
+ * @code
+ * * #variable= 4          #constraint= 6
+ * * Generated by UVL2Dimacs
+ * * x1 Root
+ * ...
+ * +1 x1 >= 1 ;
+ * -1 x1 +1 x2 +1 x3 +1 x4 >= 0 ;
+ * -1 x2 -1 x3 -1 x4 >= -1 ;
+ * -1 x2 +1 x1 >= 0 ;
+ * ...
+ * @endcode
+ *
+ * A group [2..3] of features 5, 6, 7 and 8 below feature 4 starts with the
+ * guarded lower bound `-2 x4 +1 x5 +1 x6 +1 x7 +1 x8 >= 0 ;`.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "OpbStreamWriter.hh"
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr int VARIABLE_FIELD_WIDTH = 10;    ///< Digits reserved for the variable count (int)
+    constexpr int CONSTRAINT_FIELD_WIDTH = 20;  ///< Digits reserved for the constraint count (uint64)
+
+    /**
+     * @brief Writes the term of a literal, a negative literal counting as (1 - x)
+     */
+    void write_term(std::ofstream& out, int literal, int coefficient = 1) {
+        if (literal > 0) {
+            out << '+' << coefficient << " x" << literal << ' ';
+        } else {
+            out << '-' << coefficient << " x" << -literal << ' ';
+        }
+    }
+
+    /**
+     * @brief Overwrites a placeholder with a left-aligned number
+     */
+    void patch_field(std::ofstream& out, std::ofstream::pos_type pos, uint64_t value) {
+        out.seekp(pos);
+        out << value;
+    }
+}
+
+/**
+ * @brief Opens the output file
+ *
+ * @param path Path to the output file
+ * @throws std::runtime_error if the file cannot be opened for writing
+ */
+OpbStreamWriter::OpbStreamWriter(const std::string& path)
+    : filepath(path), out(path, std::ios::out | std::ios::trunc),
+      num_constraints(0), num_cardinality(0), num_negative(0), header_written(false) {
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + filepath);
+    }
+}
+
+/**
+ * @brief Writes the term of a clause literal
+ *
+ * @param literal Non-zero literal
+ */
+void OpbStreamWriter::add_literal(int literal) {
+    write_term(out, literal);
+    if (literal < 0) {
+        num_negative++;
+    }
+}
+
+/**
+ * @brief Writes the degree of the clause: at least one literal is true
+ */
+void OpbStreamWriter::end_clause() {
+    out << ">= " << 1 - num_negative << " ;\n";
+    num_constraints++;
+}
+
+/**
+ * @brief Writes a complete clause as an inequality
+ *
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ */
+void OpbStreamWriter::add_clause(const int* first, const int* last) {
+    begin_clause();
+    for (const int* it = first; it != last; ++it) {
+        add_literal(*it);
+    }
+    end_clause();
+}
+
+/**
+ * @brief Writes "at least bound of the literals" as an inequality
+ *
+ * @param bound Smallest number of true literals
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ */
+void OpbStreamWriter::add_at_least(int bound, const int* first, const int* last) {
+    int negative = 0;
+    for (const int* it = first; it != last; ++it) {
+        write_term(out, *it);
+        if (*it < 0) {
+            negative++;
+        }
+    }
+    out << ">= " << bound - negative << " ;\n";
+    num_constraints++;
+    num_cardinality++;
+}
+
+/**
+ * @brief Writes "guard → at least bound of the literals" as an inequality
+ *
+ * The negated guard gets the coefficient bound, so it satisfies
+ * `bound ¬guard + Σ literals >= bound` on its own, while a true guard
+ * leaves the plain at-least constraint.
+ *
+ * @param guard Literal that enables the constraint
+ * @param bound Smallest number of true literals if guard is true
+ * @param first Pointer to the first literal
+ * @param last Pointer one past the last literal
+ */
+void OpbStreamWriter::add_guarded_at_least(int guard, int bound, const int* first, const int* last) {
+    write_term(out, -guard, bound);
+    int degree = guard > 0 ? 0 : bound;
+    for (const int* it = first; it != last; ++it) {
+        write_term(out, *it);
+        if (*it < 0) {
+            degree--;
+        }
+    }
+    out << ">= " << degree << " ;\n";
+    num_constraints++;
+    num_cardinality++;
+}
+
+/**
+ * @brief Writes the header with placeholders and the feature comment lines
+ *
+ * @param variables Variable table containing all feature variables
+ */
+void OpbStreamWriter::begin_formula(const CNFModel& variables) {
+    out << "* #variable= ";
+    variables_pos = out.tellp();
+    out << std::string(VARIABLE_FIELD_WIDTH, ' ') << " #constraint= ";
+    constraints_pos = out.tellp();
+    out << std::string(CONSTRAINT_FIELD_WIDTH, ' ') << "\n";
+    out << "* Generated by UVL2Dimacs\n";
+    out << "* Original features: " << variables.get_num_features() << "\n";
+
+    for (int var = 1; var <= variables.get_num_variables(); ++var) {
+        if (!variables.is_auxiliary(var)) {
+            out << "* x" << var << " " << variables.get_feature_name(var) << "\n";
+        }
+    }
+
+    header_written = true;
+}
+
+/**
+ * @brief Writes the auxiliary comment lines and patches the header
+ *
+ * @param variables Final variable table
+ * @throws std::runtime_error if the header was never written or the file is in error
+ */
+void OpbStreamWriter::end_formula(const CNFModel& variables) {
+    if (!header_written) {
+        throw std::runtime_error("OPB stream finished before its header was written: " + filepath);
+    }
+
+    int num_variables = variables.get_num_variables();
+    for (int var = 1; var <= num_variables; ++var) {
+        if (variables.is_auxiliary(var)) {
+            out << "* x" << var << " ";
+            variables.write_variable_name(out, var);
+            out << " (auxiliary)\n";
+        }
+    }
+
+    patch_field(out, variables_pos, num_variables);
+    patch_field(out, constraints_pos, num_constraints);
+    out.seekp(0, std::ios::end);
+    out.flush();
+
+    if (!out) {
+        throw std::runtime_error("Failed to write OPB file: " + filepath);
+    }
+}
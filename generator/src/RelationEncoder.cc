@@ -8,8 +8,10 @@
  * - **MANDATORY**: Child ⟺ Parent (2 clauses)
  * - **OPTIONAL**: Child → Parent (1 clause)
  * - **OR**: Parent → (at least one child) (n+1 clauses)
- * - **ALTERNATIVE**: Parent → (exactly one child) (O(n²) clauses pairwise)
- * - **CARDINALITY**: Parent → (min..max children) (enumeration-based)
+ * - **ALTERNATIVE**: Parent → (exactly one child) (O(n²) clauses pairwise, or
+ *   O(n) with a linear at-most-one encoding)
+ * - **CARDINALITY**: Parent → (min..max children) (enumeration-based, or a
+ *   polynomial counter encoding for large groups)
  *
  * Each encoding follows standard feature model semantics and SAT encoding
  * techniques from the literature.
@@ -22,7 +24,87 @@
 #include "Feature.hh"
 #include <stdexcept>
 #include <algorithm>
-#include <functional>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+    /// Largest group whose subsets are enumerated from the precomputed table
+    constexpr int MAX_TEMPLATE_CHILDREN = 8;
+
+    /**
+     * @brief Subsets of small groups in the order the enumeration visits them
+     *
+     * masks[n][s] is the s-th subset of {0, ..., n-1} (bit i set: child i
+     * selected) and sizes[n][s] its size. Subsets come by increasing size and,
+     * within a size, in lexicographic order of their indices, exactly as
+     * RelationEncoder::next_combination() steps through them.
+     */
+    struct SubsetOrder {
+        uint8_t masks[MAX_TEMPLATE_CHILDREN + 1][1 << MAX_TEMPLATE_CHILDREN];
+        uint8_t sizes[MAX_TEMPLATE_CHILDREN + 1][1 << MAX_TEMPLATE_CHILDREN];
+    };
+
+    /**
+     * @brief Builds the subset order of every group size at compile time
+     * @return Table for 0..MAX_TEMPLATE_CHILDREN children
+     */
+    constexpr SubsetOrder make_subset_order() {
+        SubsetOrder order{};
+        for (int n = 0; n <= MAX_TEMPLATE_CHILDREN; ++n) {
+            int s = 0;
+            for (int k = 0; k <= n; ++k) {
+                int combo[MAX_TEMPLATE_CHILDREN] = {};
+                for (int i = 0; i < k; ++i) {
+                    combo[i] = i;
+                }
+                while (true) {
+                    int mask = 0;
+                    for (int i = 0; i < k; ++i) {
+                        mask |= 1 << combo[i];
+                    }
+                    order.masks[n][s] = static_cast<uint8_t>(mask);
+                    order.sizes[n][s] = static_cast<uint8_t>(k);
+                    s++;
+
+                    int i = k - 1;
+                    while (i >= 0 && combo[i] == n - k + i) {
+                        i--;
+                    }
+                    if (i < 0) {
+                        break;
+                    }
+                    combo[i]++;
+                    for (int j = i + 1; j < k; ++j) {
+                        combo[j] = combo[j - 1] + 1;
+                    }
+                }
+            }
+        }
+        return order;
+    }
+
+    constexpr SubsetOrder SUBSET_ORDER = make_subset_order();
+
+    // n = 3: {}, {0}, {1}, {2}, {0,1}, {0,2}, {1,2}, {0,1,2}
+    static_assert(SUBSET_ORDER.masks[3][4] == 0x3 && SUBSET_ORDER.masks[3][6] == 0x6 &&
+                  SUBSET_ORDER.masks[3][7] == 0x7, "subsets must follow the combination order");
+    static_assert(SUBSET_ORDER.masks[8][255] == 0xff && SUBSET_ORDER.sizes[8][255] == 8,
+                  "the full group comes last");
+
+    /**
+     * @brief First literal of the enumeration clause excluding a subset size
+     *
+     * @param parent_var Parent literal
+     * @param count Number of selected children
+     * @param lower Smallest valid count
+     * @param upper Largest valid count
+     * @return ¬parent for invalid counts and the empty subset, parent otherwise
+     */
+    inline int enumeration_parent_literal(int parent_var, int count, int lower, int upper) {
+        bool is_valid = count > 0 && count >= lower && count <= upper;
+        return is_valid ? parent_var : -parent_var;
+    }
+}
 
 /**
  * @brief Constructs an encoder for the given CNF model
@@ -31,7 +113,18 @@
  * @param conversion_mode CNF mode (STRAIGHTFORWARD or TSEITIN for 3-CNF)
  */
 RelationEncoder::RelationEncoder(CNFModel& model, CNFMode conversion_mode)
-    : cnf_model(model), mode(conversion_mode) {
+    : cnf_model(model), sink(model), mode(conversion_mode), gate_cache(nullptr) {
+}
+
+/**
+ * @brief Constructs an encoder that emits clauses to a separate sink
+ *
+ * @param model CNF model used as variable table (lookups and auxiliaries)
+ * @param clause_sink Destination of the generated clauses
+ * @param conversion_mode CNF mode (STRAIGHTFORWARD or TSEITIN for 3-CNF)
+ */
+RelationEncoder::RelationEncoder(CNFModel& model, ClauseSink& clause_sink, CNFMode conversion_mode)
+    : cnf_model(model), sink(clause_sink), mode(conversion_mode), gate_cache(nullptr) {
 }
 
 /**
@@ -96,10 +189,10 @@ void RelationEncoder::encode_mandatory(std::shared_ptr<Relation> relation) {
     int child_var = cnf_model.get_variable(children[0]->get_name());
 
     // -parent OR child
-    cnf_model.add_clause({-parent_var, child_var});
+    sink.add_clause({-parent_var, child_var});
 
     // -child OR parent
-    cnf_model.add_clause({-child_var, parent_var});
+    sink.add_clause({-child_var, parent_var});
 }
 
 /**
@@ -130,7 +223,7 @@ void RelationEncoder::encode_optional(std::shared_ptr<Relation> relation) {
     int child_var = cnf_model.get_variable(children[0]->get_name());
 
     // -child OR parent
-    cnf_model.add_clause({-child_var, parent_var});
+    sink.add_clause({-child_var, parent_var});
 }
 
 /**
@@ -166,22 +259,23 @@ void RelationEncoder::encode_or(std::shared_ptr<Relation> relation) {
     }
 
     // Encode "at least one child" constraint
-    if (mode == CNFMode::TSEITIN && children.size() > 2) {
+    if (is_three_cnf(mode) && children.size() > 2) {
         // TSEITIN: Use tree decomposition for 3-CNF
         int or_result = encode_or_tree(child_vars);
-        cnf_model.add_clause({-parent_var, or_result});
+        sink.add_clause({-parent_var, or_result});
     } else {
         // STRAIGHTFORWARD: Direct encoding (may have >3 literals)
-        std::vector<int> or_clause = {-parent_var};
+        sink.begin_clause();
+        sink.add_literal(-parent_var);
         for (int cv : child_vars) {
-            or_clause.push_back(cv);
+            sink.add_literal(cv);
         }
-        cnf_model.add_clause(or_clause);
+        sink.end_clause();
     }
 
     // Each child implies parent (always 2 literals)
     for (int child_var : child_vars) {
-        cnf_model.add_clause({-child_var, parent_var});
+        sink.add_clause({-child_var, parent_var});
     }
 }
 
@@ -200,6 +294,10 @@ void RelationEncoder::encode_or(std::shared_ptr<Relation> relation) {
  * Uses tree decomposition for "at least one" to ensure ≤3 literals.
  * Pairwise "at most one" already has 2 literals per clause.
  *
+ * The "at most one" part follows the at-most-one policy (pairwise by default).
+ * A sink with native cardinality constraints gets it as one at-least
+ * constraint over the negated children instead.
+ *
  * @param relation The alternative relation (must have at least 2 children)
  * @throws std::runtime_error if relation has fewer than 2 children
  */
@@ -220,29 +318,30 @@ void RelationEncoder::encode_alternative(std::shared_ptr<Relation> relation) {
     }
 
     // Encode "at least one child" constraint
-    if (mode == CNFMode::TSEITIN && children.size() > 2) {
+    if (is_three_cnf(mode) && children.size() > 2) {
         // TSEITIN: Use tree decomposition for 3-CNF
         int or_result = encode_or_tree(child_vars);
-        cnf_model.add_clause({-parent_var, or_result});
+        sink.add_clause({-parent_var, or_result});
     } else {
         // STRAIGHTFORWARD: Direct encoding
-        std::vector<int> or_clause = {-parent_var};
+        sink.begin_clause();
+        sink.add_literal(-parent_var);
         for (int cv : child_vars) {
-            or_clause.push_back(cv);
+            sink.add_literal(cv);
         }
-        cnf_model.add_clause(or_clause);
+        sink.end_clause();
     }
 
-    // Encode "at most one child" constraint (pairwise - already 2 literals)
-    for (size_t i = 0; i < child_vars.size(); ++i) {
-        for (size_t j = i + 1; j < child_vars.size(); ++j) {
-            cnf_model.add_clause({-child_vars[i], -child_vars[j]});
-        }
+    // Encode "at most one child" constraint
+    if (sink.has_native_cardinality() && child_vars.size() > 2) {
+        add_native_at_most(child_vars, 1);
+    } else {
+        encode_at_most_one(child_vars);
     }
 
     // Each child implies parent (always 2 literals)
     for (int child_var : child_vars) {
-        cnf_model.add_clause({-child_var, parent_var});
+        sink.add_clause({-child_var, parent_var});
     }
 }
 
@@ -251,28 +350,18 @@ void RelationEncoder::encode_alternative(std::shared_ptr<Relation> relation) {
  *
  * Semantics: parent → (select between min and max children)
  * If parent is selected, between min and max children (inclusive) must be selected.
+ * An unbounded maximum ("*") allows all children.
  *
- * STRAIGHTFORWARD mode (enumeration-based approach):
- * - For each possible count k of selected children (0 to n):
- *   - If k is invalid (k < min or k > max):
- *     For each combination C of k children:
- *       Add clause: (¬parent ∨ ¬(exactly C are selected))
- * - For each child: (¬child ∨ parent)
- *
- * TSEITIN mode (3-CNF with auxiliary variables):
- * When clauses would exceed 3 literals, uses OR tree decomposition.
- *
- * Complexity: Can generate many clauses for complex cardinalities.
- * Number of clauses ≈ Σ C(n,k) for invalid counts.
+ * The count bounds are encoded by encode_cardinality_bounds(), by enumeration
+ * or, for large groups, with a counter encoding (see CardinalityPolicy), or
+ * by encode_native_cardinality() if the sink takes cardinality constraints.
+ * Each child also gets (¬child ∨ parent).
  *
  * @param relation The cardinality relation
  */
 void RelationEncoder::encode_cardinality(std::shared_ptr<Relation> relation) {
     auto parent = relation->get_parent();
     const auto& children = relation->get_children();
-    int card_min = relation->get_card_min();
-    int card_max = relation->get_card_max();
-    int num_children = children.size();
 
     int parent_var = cnf_model.get_variable(parent->get_name());
 
@@ -282,105 +371,256 @@ void RelationEncoder::encode_cardinality(std::shared_ptr<Relation> relation) {
         child_vars.push_back(cnf_model.get_variable(child->get_name()));
     }
 
-    // For each possible count of selected children
-    for (int count = 0; count <= num_children; ++count) {
-        bool is_invalid = (count < card_min || count > card_max);
-
-        // Generate all combinations of 'count' children
-        auto combinations = generate_combinations(num_children, count);
-
-        for (const auto& combo : combinations) {
-            // Determine the first literal (parent-related)
-            int first_lit;
-            if (is_invalid) {
-                first_lit = -parent_var;
-            } else if (count > 0) {
-                first_lit = parent_var;
-            } else {
-                first_lit = -parent_var;
-            }
+    if (sink.has_native_cardinality()) {
+        encode_native_cardinality(parent_var, child_vars, relation->get_card_min(), relation->get_card_max());
+    } else {
+        encode_cardinality_bounds(parent_var, child_vars, relation->get_card_min(), relation->get_card_max());
+    }
 
-            // Build literals for "NOT(exactly this combination)"
-            std::vector<int> combo_lits;
-            for (int i = 0; i < num_children; ++i) {
-                bool in_combo = std::find(combo.begin(), combo.end(), i) != combo.end();
-                if (in_combo) {
-                    combo_lits.push_back(-child_vars[i]);
-                } else {
-                    combo_lits.push_back(child_vars[i]);
-                }
-            }
+    // Add clauses: each child => parent (always 2 literals)
+    for (int child_var : child_vars) {
+        sink.add_clause({-child_var, parent_var});
+    }
+}
 
-            // Add clause based on mode
-            if (mode == CNFMode::TSEITIN && combo_lits.size() > 2) {
-                // TSEITIN: Use OR tree to keep clauses at ≤3 literals
-                int or_result = encode_or_tree(combo_lits);
-                cnf_model.add_clause({first_lit, or_result});
-            } else {
-                // STRAIGHTFORWARD or small clause: Direct encoding
-                std::vector<int> clause = {first_lit};
-                for (int lit : combo_lits) {
-                    clause.push_back(lit);
-                }
-                cnf_model.add_clause(clause);
-            }
+/**
+ * @brief Emits the clauses bounding the selected children of a selected parent
+ *
+ * @param parent_var Parent literal
+ * @param child_vars Child literals
+ * @param card_min Lower bound of the group
+ * @param card_max Upper bound of the group (negative for "*")
+ */
+void RelationEncoder::encode_cardinality_bounds(int parent_var, const std::vector<int>& child_vars,
+                                                int card_min, int card_max) {
+    int num_children = static_cast<int>(child_vars.size());
+    int upper = card_max < 0 ? num_children : card_max;
+
+    if (card_policy.is_enumeration(child_vars.size())) {
+        encode_enumeration(parent_var, child_vars, card_min, upper);
+        return;
+    }
+
+    // The enumeration never allows a selected parent without children
+    int lower = std::max(card_min, 1);
+    upper = std::min(upper, num_children);
+    if (lower > upper) {
+        sink.add_clause({-parent_var});
+        return;
+    }
+
+    // Outputs up to o_lower, and o_{upper+1} if the upper bound restricts anything
+    size_t bound = static_cast<size_t>(upper < num_children ? upper + 1 : lower);
+    CardinalityEncoding encoding = card_policy.encoding;
+    if (encoding == CardinalityEncoding::AUTO) {
+        encoding = choose_counter(child_vars.size(), bound);
+    }
+    std::vector<int> outputs = build_counter(encoding, child_vars, bound);
+
+    // parent → at least lower children
+    sink.add_clause({-parent_var, outputs[lower - 1]});
+    // parent → at most upper children
+    if (upper < num_children) {
+        sink.add_clause({-parent_var, -outputs[upper]});
+    }
+}
+
+/**
+ * @brief Emits the count bounds of a group as native cardinality constraints
+ *
+ * The lower bound only applies to a selected parent. A lower bound of 1 is
+ * the usual (¬parent ∨ x1 ∨ ... ∨ xn) clause. Above 1, sinks with weighted
+ * constraints (OPB) get it guarded by the parent. Otherwise it becomes,
+ * with lower - 1 auxiliary copies e_j of the parent (e_j ⟺ parent),
+ * "at least lower of children, ¬parent, ¬e_1, ..., ¬e_{lower-1}": a
+ * deselected parent satisfies it on its own, a selected one needs lower
+ * children. The copies are fully defined, so the number of solutions is
+ * preserved.
+ *
+ * The upper bound is emitted unconditionally, which relies on the
+ * (¬child ∨ parent) clauses of encode_cardinality(): without the parent,
+ * no child is selected.
+ *
+ * @param parent_var Parent literal
+ * @param child_vars Child literals
+ * @param card_min Lower bound of the group
+ * @param card_max Upper bound of the group (negative for "*")
+ */
+void RelationEncoder::encode_native_cardinality(int parent_var, const std::vector<int>& child_vars,
+                                                int card_min, int card_max) {
+    int num_children = static_cast<int>(child_vars.size());
+    int lower = std::max(card_min, 1);
+    int upper = std::min(card_max < 0 ? num_children : card_max, num_children);
+    if (lower > upper) {
+        sink.add_clause({-parent_var});
+        return;
+    }
+
+    // parent → at least lower children
+    if (lower == 1) {
+        add_exclusion_clause(-parent_var, child_vars);
+    } else if (sink.has_weighted_cardinality()) {
+        sink.add_guarded_at_least(parent_var, lower, child_vars);
+    } else {
+        std::vector<int> literals(child_vars);
+        literals.push_back(-parent_var);
+        for (int j = 1; j < lower; ++j) {
+            int copy = cnf_model.create_auxiliary_variable();
+            sink.add_clause({-copy, parent_var});
+            sink.add_clause({copy, -parent_var});
+            literals.push_back(-copy);
         }
+        sink.add_at_least(lower, literals);
     }
 
-    // Add clauses: each child => parent (always 2 literals)
-    for (int child_var : child_vars) {
-        cnf_model.add_clause({-child_var, parent_var});
+    // At most upper children
+    if (upper < num_children) {
+        add_native_at_most(child_vars, upper);
     }
 }
 
 /**
- * @brief Generates all combinations of k elements from n elements
+ * @brief Emits "at most bound of the literals" as a native constraint
  *
- * Uses backtracking algorithm to generate all C(n,k) combinations,
- * where each combination is represented as a vector of indices [0, n-1].
+ * At most k of n literals are true exactly when at least n - k of their
+ * negations are.
  *
- * Mathematical formula: C(n,k) = n! / (k! × (n-k)!)
+ * @param literals Literals to bound
+ * @param bound Largest number of true literals
+ */
+void RelationEncoder::add_native_at_most(const std::vector<int>& literals, int bound) {
+    std::vector<int> negated;
+    negated.reserve(literals.size());
+    for (int lit : literals) {
+        negated.push_back(-lit);
+    }
+    sink.add_at_least(static_cast<int>(literals.size()) - bound, negated);
+}
+
+/**
+ * @brief Encodes the count bounds by enumerating every subset of the children
  *
- * Examples:
- * - generate_combinations(3, 2) → {{0,1}, {0,2}, {1,2}}
- * - generate_combinations(4, 0) → {{}}  (empty combination)
- * - generate_combinations(2, 3) → {}    (impossible, k > n)
+ * STRAIGHTFORWARD mode (enumeration-based approach):
+ * - For each possible count k of selected children (0 to n):
+ *   - If k is invalid (k < min or k > max):
+ *     For each combination C of k children:
+ *       Add clause: (¬parent ∨ ¬(exactly C are selected))
  *
- * Algorithm complexity: O(C(n,k) × k) = O(n! / (k! × (n-k)!))
+ * TSEITIN mode (3-CNF with auxiliary variables):
+ * When clauses would exceed 3 literals, uses OR tree decomposition.
  *
- * @param n Total number of elements (children)
- * @param k Number of elements to choose
- * @return Vector of all combinations, where each combination is a vector of indices
+ * Complexity: Can generate many clauses for complex cardinalities.
+ * Number of clauses ≈ Σ C(n,k) for invalid counts.
+ *
+ * Groups of up to MAX_TEMPLATE_CHILDREN children read their subsets from a
+ * table built at compile time, in the same order as the combination walk.
+ *
+ * @param parent_var Parent literal
+ * @param child_vars Child literals
+ * @param lower Smallest valid count
+ * @param upper Largest valid count
  */
-std::vector<std::vector<int>> RelationEncoder::generate_combinations(int n, int k) {
-    std::vector<std::vector<int>> result;
+void RelationEncoder::encode_enumeration(int parent_var, const std::vector<int>& child_vars, int lower, int upper) {
+    int num_children = child_vars.size();
 
-    if (k > n || k < 0) {
-        return result;
-    }
+    // Literals of "NOT(exactly this combination)", reused across clauses
+    std::vector<int> combo_lits(num_children);
 
-    if (k == 0) {
-        result.push_back({});
-        return result;
+    if (num_children <= MAX_TEMPLATE_CHILDREN) {
+        // Small group: walk the precomputed subsets instead of stepping combinations
+        const uint8_t* masks = SUBSET_ORDER.masks[num_children];
+        const uint8_t* sizes = SUBSET_ORDER.sizes[num_children];
+        for (int s = 0; s < (1 << num_children); ++s) {
+            for (int i = 0; i < num_children; ++i) {
+                combo_lits[i] = (masks[s] >> i) & 1 ? -child_vars[i] : child_vars[i];
+            }
+            add_exclusion_clause(enumeration_parent_literal(parent_var, sizes[s], lower, upper), combo_lits);
+        }
+        return;
     }
 
-    // Generate combinations using backtracking
-    std::vector<int> current;
-    std::function<void(int, int)> backtrack = [&](int start, int depth) {
-        if (depth == k) {
-            result.push_back(current);
-            return;
+    // Scratch buffer for one combination, reused across clauses
+    std::vector<int> combo;
+    combo.reserve(num_children);
+
+    // For each possible count of selected children
+    for (int count = 0; count <= num_children; ++count) {
+        int first_lit = enumeration_parent_literal(parent_var, count, lower, upper);
+
+        // Visit all combinations of 'count' children, starting from {0, ..., count-1}
+        combo.resize(count);
+        for (int i = 0; i < count; ++i) {
+            combo[i] = i;
         }
 
-        for (int i = start; i < n; ++i) {
-            current.push_back(i);
-            backtrack(i + 1, depth + 1);
-            current.pop_back();
+        do {
+            size_t next = 0;
+            for (int i = 0; i < num_children; ++i) {
+                if (next < combo.size() && combo[next] == i) {
+                    combo_lits[i] = -child_vars[i];
+                    next++;
+                } else {
+                    combo_lits[i] = child_vars[i];
+                }
+            }
+            add_exclusion_clause(first_lit, combo_lits);
+        } while (next_combination(combo, num_children));
+    }
+}
+
+/**
+ * @brief Emits (first_lit ∨ l_1 ∨ ... ∨ l_n) for one enumerated subset
+ *
+ * In the 3-CNF modes, a clause of more than 3 literals is shortened to
+ * (first_lit ∨ aux) with an OR tree over the other literals.
+ *
+ * @param first_lit Parent literal of the clause
+ * @param literals Child literals of the subset
+ */
+void RelationEncoder::add_exclusion_clause(int first_lit, const std::vector<int>& literals) {
+    if (is_three_cnf(mode) && literals.size() > 2) {
+        // TSEITIN: Use OR tree to keep clauses at ≤3 literals
+        int or_result = encode_or_tree(literals);
+        sink.add_clause({first_lit, or_result});
+    } else {
+        // STRAIGHTFORWARD or small clause: Direct encoding
+        sink.begin_clause();
+        sink.add_literal(first_lit);
+        for (int lit : literals) {
+            sink.add_literal(lit);
         }
-    };
+        sink.end_clause();
+    }
+}
 
-    backtrack(0, 0);
-    return result;
+/**
+ * @brief Steps a combination to the next one in lexicographic order
+ *
+ * Finds the rightmost index that can still be incremented (combo[i] < n - k + i),
+ * increments it and resets the following indices to consecutive values. This
+ * visits the combinations in the same order as a recursive backtracker, in
+ * O(k) time per step and without allocation.
+ *
+ * Examples (n = 4, k = 2):
+ * - {0,1} → {0,2} → {0,3} → {1,2} → {1,3} → {2,3} → false
+ * - The empty combination (k = 0) has no successor
+ *
+ * @param combo Increasing indices in [0, n), updated in place
+ * @param n Total number of elements (children)
+ * @return false if combo was the last combination
+ */
+bool RelationEncoder::next_combination(std::vector<int>& combo, int n) {
+    int k = combo.size();
+    for (int i = k - 1; i >= 0; --i) {
+        if (combo[i] < n - k + i) {
+            combo[i]++;
+            for (int j = i + 1; j < k; ++j) {
+                combo[j] = combo[j - 1] + 1;
+            }
+            return true;
+        }
+    }
+    return false;
 }
 
 /**
@@ -393,45 +633,484 @@ std::vector<std::vector<int>> RelationEncoder::generate_combinations(int n, int
  * - (aux ∨ ¬v2): v2 implies aux
  *
  * For n variables, creates O(n) auxiliary variables and O(3n) clauses,
- * all with at most 3 literals (3-CNF compliant).
+ * all with at most 3 literals (3-CNF compliant). With a gate cache, a
+ * (sub)tree over inputs that were ORed before is reused, so the result may
+ * be a negative literal.
  *
  * @param vars Vector of variable IDs (can be positive or negative literals)
- * @return Variable ID representing the OR of all inputs
+ * @return Literal representing the OR of all inputs
  */
 int RelationEncoder::encode_or_tree(const std::vector<int>& vars) {
     if (vars.empty()) {
         // Should not happen, but handle gracefully
         return 0;
     }
+    return encode_or_tree(vars.data(), vars.data() + vars.size());
+}
 
-    if (vars.size() == 1) {
+/**
+ * @brief Builds an OR tree over the literals [first, last)
+ *
+ * The halves are passed down as subranges, so the recursion does not copy
+ * the inputs.
+ *
+ * @param first Pointer to the first literal (the range is non-empty)
+ * @param last Pointer past the last literal
+ * @return Literal representing the OR of the range
+ */
+int RelationEncoder::encode_or_tree(const int* first, const int* last) {
+    size_t size = last - first;
+    if (size == 1) {
         // Single variable: return as-is
-        return vars[0];
+        return first[0];
     }
 
-    if (vars.size() == 2) {
+    if (gate_cache) {
+        int found = gate_cache->find(GateType::OR, first, last, true, true);
+        if (found != 0) {
+            return found;
+        }
+    }
+
+    int result;
+    if (size == 2) {
         // Base case: create aux = (v1 ∨ v2)
-        int aux = cnf_model.create_auxiliary_variable("or_tree");
+        result = cnf_model.create_auxiliary_variable(CNFModel::AuxKind::OR_TREE);
 
         // aux ↔ (v1 ∨ v2) requires 3 clauses:
         // (¬aux ∨ v1 ∨ v2): aux implies at least one of v1, v2
-        cnf_model.add_clause({-aux, vars[0], vars[1]});
+        sink.add_clause({-result, first[0], first[1]});
         // (aux ∨ ¬v1): v1 implies aux
-        cnf_model.add_clause({aux, -vars[0]});
+        sink.add_clause({result, -first[0]});
         // (aux ∨ ¬v2): v2 implies aux
-        cnf_model.add_clause({aux, -vars[1]});
+        sink.add_clause({result, -first[1]});
+    } else {
+        // Recursive case: split in half and combine
+        const int* mid = first + size / 2;
+        int halves[2] = {encode_or_tree(first, mid), encode_or_tree(mid, last)};
+        result = encode_or_tree(halves, halves + 2);
+    }
 
-        return aux;
+    if (gate_cache) {
+        gate_cache->insert(GateType::OR, first, last, true, true, result);
     }
+    return result;
+}
 
-    // Recursive case: split in half and combine
-    size_t mid = vars.size() / 2;
-    std::vector<int> left_half(vars.begin(), vars.begin() + mid);
-    std::vector<int> right_half(vars.begin() + mid, vars.end());
+/**
+ * @brief Gets a literal equivalent to the OR of the given literals
+ *
+ * @param literals Non-empty list of literals
+ * @return The single input, or a fully defined auxiliary variable
+ */
+int RelationEncoder::define_or(const std::vector<int>& literals) {
+    if (literals.size() == 1) {
+        return literals[0];
+    }
+    if (is_three_cnf(mode)) {
+        return encode_or_tree(literals);
+    }
+
+    int aux = cnf_model.create_auxiliary_variable();
+    sink.begin_clause();
+    sink.add_literal(-aux);
+    for (int lit : literals) {
+        sink.add_literal(lit);
+    }
+    sink.end_clause();
+    for (int lit : literals) {
+        sink.add_clause({aux, -lit});
+    }
+    return aux;
+}
+
+/**
+ * @brief Emits the clauses allowing at most one of the literals to be true
+ *
+ * @param literals Literals of which at most one may be true
+ */
+void RelationEncoder::encode_at_most_one(const std::vector<int>& literals) {
+    if (amo_policy.is_pairwise(literals.size())) {
+        encode_amo_pairwise(literals);
+        return;
+    }
+    switch (amo_policy.encoding) {
+        case AtMostOneEncoding::SEQUENTIAL:
+            encode_amo_sequential(literals);
+            break;
+        case AtMostOneEncoding::LADDER:
+            encode_amo_ladder(literals);
+            break;
+        case AtMostOneEncoding::COMMANDER:
+            encode_amo_commander(literals);
+            break;
+        case AtMostOneEncoding::BIMANDER:
+            encode_amo_bimander(literals);
+            break;
+        case AtMostOneEncoding::PRODUCT:
+            encode_amo_product(literals);
+            break;
+        case AtMostOneEncoding::PAIRWISE:
+            encode_amo_pairwise(literals);
+            break;
+    }
+}
+
+/**
+ * @brief Pairwise at-most-one (2 literals per clause)
+ *
+ * @param literals Literals of which at most one may be true
+ */
+void RelationEncoder::encode_amo_pairwise(const std::vector<int>& literals) {
+    for (size_t i = 0; i < literals.size(); ++i) {
+        for (size_t j = i + 1; j < literals.size(); ++j) {
+            sink.add_clause({-literals[i], -literals[j]});
+        }
+    }
+}
+
+/**
+ * @brief Sequential-counter at-most-one
+ *
+ * The prefix ORs are built with define_or(), which emits exactly the three
+ * clauses of p_i ↔ (p_{i-1} ∨ x_i) in both modes.
+ *
+ * @param literals Literals of which at most one may be true
+ */
+void RelationEncoder::encode_amo_sequential(const std::vector<int>& literals) {
+    int prefix = literals[0];
+    for (size_t i = 1; i < literals.size(); ++i) {
+        // x_i excludes every earlier literal
+        sink.add_clause({-literals[i], -prefix});
+        if (i + 1 < literals.size()) {
+            prefix = define_or({prefix, literals[i]});
+        }
+    }
+}
 
-    int left_result = encode_or_tree(left_half);
-    int right_result = encode_or_tree(right_half);
+/**
+ * @brief Ladder at-most-one
+ *
+ * y_i is true iff one of x_i..x_n is true (y_n = x_n), so the ladder
+ * variables are fully determined by the literals.
+ *
+ * @param literals Literals of which at most one may be true
+ */
+void RelationEncoder::encode_amo_ladder(const std::vector<int>& literals) {
+    size_t n = literals.size();
+    std::vector<int> ladder;
+    for (size_t i = 0; i + 1 < n; ++i) {
+        ladder.push_back(cnf_model.create_auxiliary_variable());
+    }
+    ladder.push_back(literals[n - 1]);
+
+    for (size_t i = 0; i + 1 < n; ++i) {
+        int y = ladder[i];
+        int y_next = ladder[i + 1];
+        int x = literals[i];
+        sink.add_clause({-y_next, y});      // y_{i+1} → y_i
+        sink.add_clause({-x, y});           // x_i → y_i
+        sink.add_clause({-x, -y_next});     // x_i excludes every later literal
+        sink.add_clause({-y, y_next, x});   // y_i ∧ ¬y_{i+1} → x_i
+    }
+}
+
+/**
+ * @brief Commander at-most-one
+ *
+ * @param literals Literals of which at most one may be true
+ */
+void RelationEncoder::encode_amo_commander(const std::vector<int>& literals) {
+    const size_t group_size = 3;
+    std::vector<int> commanders;
+    for (size_t start = 0; start < literals.size(); start += group_size) {
+        size_t end = std::min(start + group_size, literals.size());
+        std::vector<int> group(literals.begin() + start, literals.begin() + end);
+        encode_amo_pairwise(group);
+        commanders.push_back(define_or(group));
+    }
+    encode_at_most_one(commanders);
+}
+
+/**
+ * @brief Bimander at-most-one
+ *
+ * @param literals Literals of which at most one may be true
+ */
+void RelationEncoder::encode_amo_bimander(const std::vector<int>& literals) {
+    const size_t group_size = 2;
+    size_t num_groups = (literals.size() + group_size - 1) / group_size;
+    size_t num_bits = 0;
+    while ((size_t{1} << num_bits) < num_groups) {
+        num_bits++;
+    }
+
+    for (size_t start = 0; start < literals.size(); start += group_size) {
+        size_t end = std::min(start + group_size, literals.size());
+        encode_amo_pairwise(std::vector<int>(literals.begin() + start, literals.begin() + end));
+    }
+
+    for (size_t bit = 0; bit < num_bits; ++bit) {
+        std::vector<int> members;
+        for (size_t i = 0; i < literals.size(); ++i) {
+            if (((i / group_size) >> bit) & 1) {
+                members.push_back(literals[i]);
+            }
+        }
+        int bit_var = define_or(members);
+        for (size_t i = 0; i < literals.size(); ++i) {
+            if (!(((i / group_size) >> bit) & 1)) {
+                sink.add_clause({-literals[i], -bit_var});
+            }
+        }
+    }
+}
+
+/**
+ * @brief 2-product at-most-one
+ *
+ * Literal i sits in row i / q and column i % q.
+ *
+ * @param literals Literals of which at most one may be true
+ */
+void RelationEncoder::encode_amo_product(const std::vector<int>& literals) {
+    size_t n = literals.size();
+    size_t rows = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+    size_t columns = (n + rows - 1) / rows;
+
+    std::vector<std::vector<int>> row_members((n + columns - 1) / columns);
+    std::vector<std::vector<int>> column_members(columns);
+    for (size_t i = 0; i < n; ++i) {
+        row_members[i / columns].push_back(literals[i]);
+        column_members[i % columns].push_back(literals[i]);
+    }
 
-    // Combine the two halves
-    return encode_or_tree({left_result, right_result});
+    std::vector<int> row_vars;
+    for (const auto& members : row_members) {
+        row_vars.push_back(define_or(members));
+    }
+    std::vector<int> column_vars;
+    for (const auto& members : column_members) {
+        column_vars.push_back(define_or(members));
+    }
+    encode_at_most_one(row_vars);
+    encode_at_most_one(column_vars);
+}
+
+/**
+ * @brief Resolves AUTO to the counter encoding with the fewest literals
+ *
+ * @param n Number of children
+ * @param bound Number of counter outputs needed
+ * @return SEQUENTIAL_COUNTER, TOTALIZER or SORTING_NETWORK
+ */
+CardinalityEncoding RelationEncoder::choose_counter(size_t n, size_t bound) {
+    std::vector<int> literals(n);
+    for (size_t i = 0; i < n; ++i) {
+        literals[i] = static_cast<int>(i + 1);
+    }
+
+    CardinalityEncoding best = CardinalityEncoding::SEQUENTIAL_COUNTER;
+    uint64_t best_literals = UINT64_MAX;
+    for (CardinalityEncoding candidate : {CardinalityEncoding::SEQUENTIAL_COUNTER, CardinalityEncoding::TOTALIZER,
+                                          CardinalityEncoding::SORTING_NETWORK}) {
+        CNFModel scratch;
+        ClauseCounter counter;
+        RelationEncoder dry_run(scratch, counter, mode);
+        dry_run.build_counter(candidate, literals, bound);
+        if (counter.get_num_literals() < best_literals) {
+            best = candidate;
+            best_literals = counter.get_num_literals();
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Builds the unary count of the literals with the given encoding
+ *
+ * @param encoding SEQUENTIAL_COUNTER, TOTALIZER or SORTING_NETWORK
+ * @param literals Literals to count
+ * @param bound Number of outputs needed
+ * @return Outputs o_1..o_m (m = min(n, bound))
+ */
+std::vector<int> RelationEncoder::build_counter(CardinalityEncoding encoding, const std::vector<int>& literals,
+                                                size_t bound) {
+    switch (encoding) {
+        case CardinalityEncoding::TOTALIZER:
+            return build_totalizer(literals, 0, literals.size(), bound);
+        case CardinalityEncoding::SORTING_NETWORK:
+            return build_sorting_network(literals, bound);
+        default:
+            return build_sequential_counter(literals, bound);
+    }
+}
+
+/**
+ * @brief Sequential counter over the literals
+ *
+ * s_{i,k} = s_{i-1,k} ∨ (s_{i-1,k-1} ∧ x_i) is defined by
+ * (¬s_{i-1,k} ∨ s_{i,k}), (¬s_{i-1,k-1} ∨ ¬x_i ∨ s_{i,k}),
+ * (¬s_{i,k} ∨ s_{i-1,k} ∨ s_{i-1,k-1}) and (¬s_{i,k} ∨ s_{i-1,k} ∨ x_i),
+ * where s_{i-1,0} is true and s_{i-1,i} is false.
+ *
+ * @param literals Literals to count
+ * @param bound Number of outputs needed
+ * @return Outputs o_1..o_m
+ */
+std::vector<int> RelationEncoder::build_sequential_counter(const std::vector<int>& literals, size_t bound) {
+    std::vector<int> counts;  // counts[k - 1]: at least k of the literals seen so far
+    std::vector<int> next;
+    for (size_t i = 0; i < literals.size(); ++i) {
+        int x = literals[i];
+        next.clear();
+        size_t levels = std::min(i + 1, bound);
+        for (size_t k = 1; k <= levels; ++k) {
+            bool has_same = k <= counts.size();  // s_{i-1,k} (false otherwise)
+            bool has_lower = k >= 2;             // s_{i-1,k-1} (true otherwise)
+            if (!has_same && !has_lower) {
+                next.push_back(x);  // s_{1,1} = x_1
+            } else if (!has_same) {
+                next.push_back(define_and(counts[k - 2], x));
+            } else if (!has_lower) {
+                next.push_back(define_or({counts[k - 1], x}));
+            } else {
+                int same = counts[k - 1];
+                int lower = counts[k - 2];
+                int s = cnf_model.create_auxiliary_variable();
+                sink.add_clause({-same, s});
+                sink.add_clause({-lower, -x, s});
+                sink.add_clause({-s, same, lower});
+                sink.add_clause({-s, same, x});
+                next.push_back(s);
+            }
+        }
+        counts.swap(next);
+    }
+    return counts;
+}
+
+/**
+ * @brief Totalizer over literals [first, last)
+ *
+ * Outputs beyond the bound are not built: o_m then means "at least m", and
+ * only the clauses with i + j <= m are needed.
+ *
+ * @param literals Literals to count
+ * @param first Index of the first literal of the range
+ * @param last Index past the last literal of the range
+ * @param bound Number of outputs needed
+ * @return Outputs o_1..o_m of the range
+ */
+std::vector<int> RelationEncoder::build_totalizer(const std::vector<int>& literals, size_t first, size_t last,
+                                                  size_t bound) {
+    if (last - first == 1) {
+        return {literals[first]};
+    }
+
+    size_t mid = first + (last - first) / 2;
+    std::vector<int> left = build_totalizer(literals, first, mid, bound);
+    std::vector<int> right = build_totalizer(literals, mid, last, bound);
+
+    size_t m = std::min(left.size() + right.size(), bound);
+    std::vector<int> outputs(m);
+    for (size_t k = 0; k < m; ++k) {
+        outputs[k] = cnf_model.create_auxiliary_variable();
+    }
+
+    std::vector<int> clause;
+    for (size_t i = 0; i <= left.size(); ++i) {
+        for (size_t j = 0; j <= right.size(); ++j) {
+            // a_i ∧ b_j → o_{i+j}
+            if (i + j >= 1 && i + j <= m) {
+                clause.clear();
+                if (i > 0) clause.push_back(-left[i - 1]);
+                if (j > 0) clause.push_back(-right[j - 1]);
+                clause.push_back(outputs[i + j - 1]);
+                sink.add_clause(clause);
+            }
+            // ¬a_{i+1} ∧ ¬b_{j+1} → ¬o_{i+j+1}
+            if (i + j + 1 <= m) {
+                clause.clear();
+                if (i < left.size()) clause.push_back(left[i]);
+                if (j < right.size()) clause.push_back(right[j]);
+                clause.push_back(-outputs[i + j]);
+                sink.add_clause(clause);
+            }
+        }
+    }
+    return outputs;
+}
+
+/**
+ * @brief Odd-even merge sorting network over the literals
+ *
+ * Wires hold literals (0 for constant false) sorted in decreasing order
+ * once the network is complete, so wire k - 1 is true iff at least k
+ * literals are.
+ *
+ * @param literals Literals to count
+ * @param bound Number of outputs needed
+ * @return Outputs o_1..o_m
+ */
+std::vector<int> RelationEncoder::build_sorting_network(const std::vector<int>& literals, size_t bound) {
+    size_t size = 1;
+    while (size < literals.size()) {
+        size <<= 1;
+    }
+    std::vector<int> wires(literals);
+    wires.resize(size, 0);
+
+    auto compare = [&](size_t high, size_t low) {
+        int a = wires[high];
+        int b = wires[low];
+        if (a == 0 || b == 0) {
+            wires[high] = a == 0 ? b : a;
+            wires[low] = 0;
+            return;
+        }
+        wires[high] = define_or({a, b});
+        wires[low] = define_and(a, b);
+    };
+
+    for (size_t p = 1; p < size; p <<= 1) {
+        for (size_t k = p; k >= 1; k >>= 1) {
+            for (size_t j = k % p; j + k < size; j += 2 * k) {
+                for (size_t i = 0; i < std::min(k, size - j - k); ++i) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        compare(i + j, i + j + k);
+                    }
+                }
+            }
+        }
+    }
+
+    wires.resize(std::min(literals.size(), bound));
+    return wires;
+}
+
+/**
+ * @brief Gets a literal equivalent to a ∧ b
+ *
+ * @param a First literal
+ * @param b Second literal
+ * @return The AND literal
+ */
+int RelationEncoder::define_and(int a, int b) {
+    int inputs[2] = {a, b};
+    if (gate_cache) {
+        int found = gate_cache->find(GateType::AND, inputs, inputs + 2, true, true);
+        if (found != 0) {
+            return found;
+        }
+    }
+
+    int aux = cnf_model.create_auxiliary_variable();
+    sink.add_clause({-aux, a});
+    sink.add_clause({-aux, b});
+    sink.add_clause({aux, -a, -b});
+    if (gate_cache) {
+        gate_cache->insert(GateType::AND, inputs, inputs + 2, true, true, aux);
+    }
+    return aux;
 }
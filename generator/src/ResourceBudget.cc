@@ -0,0 +1,165 @@
+/**
+ * @file ResourceBudget.cc
+ * @brief Implementation of conversion resource limits
+ *
+ * Resident memory is read from /proc/self/statm; where it is not available
+ * the memory limit is not enforced.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "ResourceBudget.hh"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+    /**
+     * @brief Formats a byte count in megabytes
+     */
+    std::string to_megabytes(uint64_t bytes) {
+        if (bytes == EncodingEstimator::UNBOUNDED) {
+            return "an unbounded amount";
+        }
+        return std::to_string((bytes >> 20) + ((bytes & ((1 << 20) - 1)) != 0)) + " MB";
+    }
+
+    /**
+     * @brief Formats a predicted count, which may have saturated
+     */
+    std::string to_count(uint64_t count) {
+        return count == EncodingEstimator::UNBOUNDED ? "an unbounded number of" : std::to_string(count);
+    }
+
+    /**
+     * @brief Bytes needed to hold an encoding before it is emitted
+     *
+     * Straightforward constraints are distributed into a vector of clauses
+     * first: one vector header plus allocator overhead per clause and one int
+     * per literal.
+     */
+    uint64_t expansion_bytes(const EncodingCost& cost) {
+        const uint64_t per_clause = sizeof(std::vector<int>) + 16;
+        if (cost.clauses > UINT64_MAX / per_clause || cost.literals > UINT64_MAX / sizeof(int)) {
+            return UINT64_MAX;
+        }
+        uint64_t clause_bytes = cost.clauses * per_clause;
+        uint64_t literal_bytes = cost.literals * sizeof(int);
+        return clause_bytes > UINT64_MAX - literal_bytes ? UINT64_MAX : clause_bytes + literal_bytes;
+    }
+}
+
+/**
+ * @brief Constructs an unlimited budget started now
+ */
+ResourceBudget::ResourceBudget()
+    : max_clauses(0), max_literals(0), max_seconds(0), max_rss(0),
+      used_clauses(0), used_literals(0), next_check(CHECK_INTERVAL),
+      start_time(std::chrono::steady_clock::now()) {
+}
+
+/**
+ * @brief Resets the counters and starts the wall-time clock
+ */
+void ResourceBudget::start() {
+    used_clauses = 0;
+    used_literals = 0;
+    next_check = CHECK_INTERVAL;
+    context.clear();
+    start_time = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief Checks that an encoding of the predicted size still fits
+ *
+ * @param predicted Size predicted by EncodingEstimator
+ * @param materialized Whether the clauses are built in memory before being emitted
+ * @throws BudgetExceeded if a limit would be exceeded
+ */
+void ResourceBudget::reserve(const EncodingCost& predicted, bool materialized) {
+    if (max_clauses != 0 && predicted.clauses > max_clauses - std::min(used_clauses, max_clauses)) {
+        fail("predicted " + to_count(predicted.clauses) + " clauses exceed the limit of " +
+             std::to_string(max_clauses) + " (" + std::to_string(used_clauses) + " already used)");
+    }
+    if (max_literals != 0 && predicted.literals > max_literals - std::min(used_literals, max_literals)) {
+        fail("predicted " + to_count(predicted.literals) + " literals exceed the limit of " +
+             std::to_string(max_literals) + " (" + std::to_string(used_literals) + " already used)");
+    }
+    if (max_rss != 0) {
+        uint64_t rss = get_current_rss();
+        uint64_t needed = materialized ? expansion_bytes(predicted) : 0;
+        if (rss != 0 && (rss > max_rss || needed > max_rss - rss)) {
+            fail("expanding it needs about " + to_megabytes(needed) + " with " + to_megabytes(rss) +
+                 " resident, exceeding the memory limit of " + to_megabytes(max_rss));
+        }
+    }
+}
+
+/**
+ * @brief Checks the wall time and resident memory now
+ *
+ * @param description Step named in the error message
+ * @throws BudgetExceeded if a limit is exceeded
+ */
+void ResourceBudget::check(const std::string& description) {
+    context = description;
+    check_usage();
+}
+
+/**
+ * @brief Gets the current resident memory of the process
+ *
+ * @return Bytes (0 if unavailable on this platform)
+ */
+uint64_t ResourceBudget::get_current_rss() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0;
+    uint64_t resident = 0;
+    if (!(statm >> size >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * @brief Enforces all limits against the charged usage
+ *
+ * @throws BudgetExceeded if a limit is exceeded
+ */
+void ResourceBudget::check_usage() {
+    next_check = used_clauses + CHECK_INTERVAL;
+
+    if (max_clauses != 0 && used_clauses > max_clauses) {
+        fail(std::to_string(used_clauses) + " clauses exceed the limit of " + std::to_string(max_clauses));
+    }
+    if (max_literals != 0 && used_literals > max_literals) {
+        fail(std::to_string(used_literals) + " literals exceed the limit of " + std::to_string(max_literals));
+    }
+    if (max_seconds > 0) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+        if (elapsed.count() > max_seconds) {
+            std::ostringstream reason;
+            reason << "wall time of " << elapsed.count() << " s exceeds the limit of " << max_seconds << " s";
+            fail(reason.str());
+        }
+    }
+    if (max_rss != 0) {
+        uint64_t rss = get_current_rss();
+        if (rss > max_rss) {
+            fail("resident memory of " + to_megabytes(rss) + " exceeds the limit of " + to_megabytes(max_rss));
+        }
+    }
+}
+
+/**
+ * @brief Throws a BudgetExceeded naming the current context
+ *
+ * @param reason Description of the exceeded limit
+ */
+void ResourceBudget::fail(const std::string& reason) const {
+    std::string where = context.empty() ? "" : " in " + context;
+    throw BudgetExceeded("Resource limit exceeded" + where + ": " + reason);
+}
@@ -0,0 +1,249 @@
+/**
+ * @file SatPreprocessor.cc
+ * @brief Implementation of MiniSat-based preprocessing and blocked-clause elimination
+ *
+ * MiniSat numbers variables from 0 and encodes literals as mkLit(var, sign);
+ * variable v of the model is MiniSat variable v - 1.
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "SatPreprocessor.hh"
+#include "minisat/simp/SimpSolver.h"
+#include <cstdlib>
+#include <utility>
+
+namespace {
+    /**
+     * @brief Converts a model literal to a MiniSat literal
+     */
+    inline Minisat::Lit to_minisat(int literal) {
+        return Minisat::mkLit(std::abs(literal) - 1, literal < 0);
+    }
+
+    /**
+     * @brief Converts a MiniSat literal to a model literal
+     */
+    inline int from_minisat(Minisat::Lit literal) {
+        int var = Minisat::var(literal) + 1;
+        return Minisat::sign(literal) ? -var : var;
+    }
+
+    /**
+     * @brief Maps a literal to a dense index (2 * (var - 1) + sign)
+     */
+    inline size_t literal_index(int literal) {
+        return 2 * static_cast<size_t>(std::abs(literal) - 1) + (literal < 0 ? 1 : 0);
+    }
+}
+
+/**
+ * @brief Constructs a preprocessor with blocked-clause elimination enabled
+ */
+SatPreprocessor::SatPreprocessor()
+    : use_blocked_clauses(true), blocked_clause_budget(DEFAULT_BLOCKED_CLAUSE_BUDGET),
+      eliminated_variables(0), removed_clauses(0), blocked_clauses(0), unsatisfiable(false) {
+}
+
+/**
+ * @brief Preprocesses a CNF model in place
+ *
+ * @param model CNF model whose clauses and auxiliary variables are rewritten
+ */
+void SatPreprocessor::preprocess(CNFModel& model) {
+    eliminated_variables = 0;
+    removed_clauses = 0;
+    blocked_clauses = 0;
+    unsatisfiable = false;
+
+    int num_variables = model.get_num_variables();
+    size_t clauses_before = static_cast<size_t>(model.get_num_clauses());
+    std::vector<char> frozen(num_variables + 1, 0);
+
+    Minisat::SimpSolver solver;
+    solver.verbosity = 0;
+    for (int var = 1; var <= num_variables; ++var) {
+        solver.newVar();
+        if (!model.is_auxiliary(var)) {
+            frozen[var] = 1;
+            solver.setFrozen(var - 1, true);
+        }
+    }
+
+    Minisat::vec<Minisat::Lit> buffer;
+    bool consistent = true;
+    for (int c = 0; c < model.get_num_clauses() && consistent; ++c) {
+        buffer.clear();
+        for (int lit : model.get_clause(c)) {
+            buffer.push(to_minisat(lit));
+        }
+        consistent = solver.addClause_(buffer);
+    }
+    if (!consistent || !solver.eliminate(true) || !solver.okay()) {
+        unsatisfiable = true;
+        return;
+    }
+
+    // Collect the simplified clauses (satisfied clauses and false literals dropped)
+    std::vector<std::vector<int>> clauses;
+    for (Minisat::ClauseIterator it = solver.clausesBegin(); it != solver.clausesEnd(); ++it) {
+        const Minisat::Clause& clause = *it;
+        std::vector<int> literals;
+        bool satisfied = false;
+        for (int i = 0; i < clause.size() && !satisfied; ++i) {
+            Minisat::lbool value = solver.value(clause[i]);
+            if (value == Minisat::l_True) {
+                satisfied = true;
+            } else if (value == Minisat::l_Undef) {
+                literals.push_back(from_minisat(clause[i]));
+            }
+        }
+        if (!satisfied) {
+            clauses.push_back(std::move(literals));
+        }
+    }
+
+    std::vector<char> removed(clauses.size(), 0);
+    if (use_blocked_clauses) {
+        eliminate_blocked_clauses(clauses, removed, frozen, num_variables);
+    }
+
+    // Units for fixed features, then the remaining clauses
+    std::vector<int> out_literals;
+    std::vector<size_t> out_offsets{0};
+    std::vector<char> used(num_variables + 1, 0);
+    for (Minisat::TrailIterator it = solver.trailBegin(); it != solver.trailEnd(); ++it) {
+        int lit = from_minisat(*it);
+        if (frozen[std::abs(lit)]) {
+            out_literals.push_back(lit);
+            out_offsets.push_back(out_literals.size());
+            used[std::abs(lit)] = 1;
+        }
+    }
+    for (size_t c = 0; c < clauses.size(); ++c) {
+        if (removed[c]) {
+            continue;
+        }
+        for (int lit : clauses[c]) {
+            out_literals.push_back(lit);
+            used[std::abs(lit)] = 1;
+        }
+        out_offsets.push_back(out_literals.size());
+    }
+
+    size_t clauses_after = out_offsets.size() - 1;
+    removed_clauses = clauses_before > clauses_after ? clauses_before - clauses_after : 0;
+    model.replace_clauses(std::move(out_literals), std::move(out_offsets));
+
+    // Keep all features and the auxiliary variables still in use
+    std::vector<int> literal_map(num_variables + 1, 0);
+    int next = 0;
+    for (int var = 1; var <= num_variables; ++var) {
+        if (frozen[var] || used[var]) {
+            literal_map[var] = ++next;
+        } else {
+            eliminated_variables++;
+        }
+    }
+    model.remap_variables(literal_map);
+}
+
+/**
+ * @brief Removes blocked clauses on auxiliary literals
+ *
+ * Every clause is checked once; when a clause is removed, the clauses that
+ * contain the complement of one of its auxiliary literals lose a resolution
+ * partner and are checked again.
+ *
+ * @param clauses Clause database (original variable IDs)
+ * @param removed Per-clause removal flags (updated)
+ * @param frozen Per variable ID: 1 for feature variables
+ * @param num_variables Number of variables of the model
+ */
+void SatPreprocessor::eliminate_blocked_clauses(const std::vector<std::vector<int>>& clauses,
+                                                std::vector<char>& removed,
+                                                const std::vector<char>& frozen,
+                                                int num_variables) {
+    std::vector<std::vector<uint32_t>> occurrences(2 * static_cast<size_t>(num_variables));
+    for (size_t c = 0; c < clauses.size(); ++c) {
+        for (int lit : clauses[c]) {
+            if (!frozen[std::abs(lit)]) {
+                occurrences[literal_index(lit)].push_back(static_cast<uint32_t>(c));
+            }
+        }
+    }
+
+    std::vector<uint32_t> stamp(2 * static_cast<size_t>(num_variables), 0);
+    uint32_t current = 0;
+    std::vector<char> queued(clauses.size(), 1);
+    std::vector<uint32_t> queue(clauses.size());
+    for (size_t c = 0; c < clauses.size(); ++c) {
+        queue[c] = static_cast<uint32_t>(clauses.size() - 1 - c);
+    }
+    uint64_t budget = blocked_clause_budget;
+
+    while (!queue.empty()) {
+        uint32_t c = queue.back();
+        queue.pop_back();
+        queued[c] = 0;
+        if (removed[c]) {
+            continue;
+        }
+
+        current++;
+        for (int lit : clauses[c]) {
+            stamp[literal_index(lit)] = current;
+        }
+
+        bool blocked = false;
+        for (int lit : clauses[c]) {
+            if (frozen[std::abs(lit)]) {
+                continue;
+            }
+            // Every resolvent on lit must contain a complementary pair
+            bool all_tautological = true;
+            for (uint32_t d : occurrences[literal_index(-lit)]) {
+                if (removed[d]) {
+                    continue;
+                }
+                bool tautology = false;
+                for (int other : clauses[d]) {
+                    if (budget == 0) {
+                        return;
+                    }
+                    budget--;
+                    if (other != -lit && stamp[literal_index(-other)] == current) {
+                        tautology = true;
+                        break;
+                    }
+                }
+                if (!tautology) {
+                    all_tautological = false;
+                    break;
+                }
+            }
+            if (all_tautological) {
+                blocked = true;
+                break;
+            }
+        }
+        if (!blocked) {
+            continue;
+        }
+
+        removed[c] = 1;
+        blocked_clauses++;
+        for (int lit : clauses[c]) {
+            if (frozen[std::abs(lit)]) {
+                continue;
+            }
+            for (uint32_t d : occurrences[literal_index(-lit)]) {
+                if (!removed[d] && !queued[d]) {
+                    queued[d] = 1;
+                    queue.push_back(d);
+                }
+            }
+        }
+    }
+}
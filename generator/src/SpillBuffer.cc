@@ -0,0 +1,76 @@
+/**
+ * @file SpillBuffer.cc
+ * @brief Implementation of the memory-mapped temporary file used by SpillBuffer
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "SpillBuffer.hh"
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+    /**
+     * @brief Builds an error message from errno
+     */
+    std::string system_error(const std::string& what) {
+        return what + ": " + std::strerror(errno);
+    }
+}
+
+/**
+ * @brief Constructs an unopened mapped file
+ */
+MappedFile::MappedFile() : fd(-1), address(nullptr), length(0) {
+}
+
+/**
+ * @brief Unmaps and closes the file (it was unlinked on creation)
+ */
+MappedFile::~MappedFile() {
+    if (address) {
+        munmap(address, length);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+/**
+ * @brief Grows or shrinks the file and maps it again
+ *
+ * @param bytes New size in bytes (must be > 0)
+ * @throws std::runtime_error if the file cannot be created, resized or mapped
+ */
+void MappedFile::resize(size_t bytes) {
+    if (fd < 0) {
+        const char* tmpdir = std::getenv("TMPDIR");
+        std::string path = std::string(tmpdir && *tmpdir ? tmpdir : "/tmp") + "/uvl2dimacs-XXXXXX";
+        fd = mkstemp(&path[0]);
+        if (fd < 0) {
+            throw std::runtime_error(system_error("Cannot create spill file in " + path));
+        }
+        unlink(path.c_str());
+    }
+
+    if (address) {
+        munmap(address, length);
+        address = nullptr;
+        length = 0;
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        throw std::runtime_error(system_error("Cannot resize spill file to " + std::to_string(bytes) + " bytes"));
+    }
+    void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error(system_error("Cannot map spill file"));
+    }
+    address = mapped;
+    length = bytes;
+}
@@ -0,0 +1,353 @@
+/**
+ * @file StructuralAnalyzer.cc
+ * @brief Implementation of structural core and dead feature detection
+ *
+ * Features are indexed by name, so features that share a name share a value,
+ * exactly as they share a CNF variable. Each feature is assigned at most once
+ * and each assignment visits only the relations and constraint clauses that
+ * mention the feature, so propagation is linear in the size of the model
+ * (group checks touch the children of a group only when forcing them).
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "StructuralAnalyzer.hh"
+#include "Constraint.hh"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+    /**
+     * @brief Counts the feature references of a constraint expression
+     */
+    int count_literals(const ASTNode& node) {
+        if (node.is_literal()) {
+            return 1;
+        }
+        int count = 0;
+        for (const auto& child : node.get_children()) {
+            if (child) {
+                count += count_literals(*child);
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Maps a literal (+/-(index + 1)) to a feature index
+     */
+    inline int literal_feature(int literal) {
+        return std::abs(literal) - 1;
+    }
+}
+
+/**
+ * @brief Constructs an analyzer for the given feature model
+ *
+ * @param model Shared pointer to the feature model to analyze
+ */
+StructuralAnalyzer::StructuralAnalyzer(std::shared_ptr<FeatureModel> model)
+    : source_model(model), conflict(false) {
+}
+
+/**
+ * @brief Runs the propagation
+ *
+ * Seeds the queue with the root (core) and the unit constraint clauses, then
+ * propagates until no new value is derived or a conflict is found.
+ */
+void StructuralAnalyzer::analyze() {
+    build();
+
+    auto root = source_model->get_root();
+    if (!root) {
+        return;
+    }
+    assign(feature_index.at(root->get_name()), State::CORE);
+
+    for (size_t c = 0; c < clauses.size(); ++c) {
+        check_clause(static_cast<int>(c));
+    }
+    // Groups whose bounds can never be met (e.g., fewer children than the lower bound)
+    for (size_t g = 0; g < groups.size(); ++g) {
+        check_group(static_cast<int>(g));
+    }
+
+    while (!queue.empty() && !conflict) {
+        int feature = queue.back();
+        queue.pop_back();
+        State value = states[feature];
+
+        if (value == State::CORE) {
+            for (int g : child_groups[feature]) {
+                groups[g].num_core++;
+                assign(groups[g].parent, State::CORE);
+                check_group(g);
+            }
+        } else {
+            for (int g : parent_groups[feature]) {
+                for (int child : groups[g].children) {
+                    assign(child, State::DEAD);
+                }
+            }
+            for (int g : child_groups[feature]) {
+                groups[g].num_dead++;
+                check_group(g);
+            }
+        }
+        for (int g : parent_groups[feature]) {
+            check_group(g);
+        }
+
+        for (int c : clause_occurrences[feature]) {
+            check_clause(c);
+        }
+    }
+}
+
+/**
+ * @brief Builds the index form of features, relations and constraints
+ */
+void StructuralAnalyzer::build() {
+    feature_index.clear();
+    feature_names.clear();
+    groups.clear();
+    clauses.clear();
+    queue.clear();
+    conflict = false;
+
+    for (const auto& feature : source_model->get_features()) {
+        if (feature_index.emplace(feature->get_name(), static_cast<int>(feature_names.size())).second) {
+            feature_names.push_back(feature->get_name());
+        }
+    }
+
+    size_t num_features = feature_names.size();
+    states.assign(num_features, State::UNKNOWN);
+    parent_groups.assign(num_features, {});
+    child_groups.assign(num_features, {});
+
+    for (const auto& relation : source_model->get_relations()) {
+        Group group;
+        group.parent = feature_index.at(relation->get_parent()->get_name());
+        for (const auto& child : relation->get_children()) {
+            group.children.push_back(feature_index.at(child->get_name()));
+        }
+        int n = static_cast<int>(group.children.size());
+        group.lower = 0;
+        group.upper = n;
+
+        // Bounds on the selected children of a selected parent, as encoded by RelationEncoder
+        switch (relation->get_type()) {
+            case Relation::Type::MANDATORY:   group.lower = 1; group.upper = 1; break;
+            case Relation::Type::OPTIONAL:    group.lower = 0; group.upper = 1; break;
+            case Relation::Type::OR:          group.lower = 1; group.upper = n; break;
+            case Relation::Type::ALTERNATIVE: group.lower = 1; group.upper = 1; break;
+            case Relation::Type::CARDINALITY:
+                // The encoding always requires at least one child of a selected parent
+                group.lower = std::max(relation->get_card_min(), 1);
+                group.upper = relation->get_card_max() < 0 ? n : std::min(relation->get_card_max(), n);
+                break;
+        }
+        group.num_core = 0;
+        group.num_dead = 0;
+
+        int id = static_cast<int>(groups.size());
+        parent_groups[group.parent].push_back(id);
+        for (int child : group.children) {
+            child_groups[child].push_back(id);
+        }
+        groups.push_back(std::move(group));
+    }
+
+    build_constraint_clauses();
+}
+
+/**
+ * @brief Converts small pure-boolean constraints into clauses
+ *
+ * Uses the straightforward conversion of the constraint AST. Constraints that
+ * reference unknown features or exceed MAX_CONSTRAINT_LITERALS are skipped,
+ * which only makes the analysis less complete.
+ */
+void StructuralAnalyzer::build_constraint_clauses() {
+    clause_occurrences.assign(feature_names.size(), {});
+
+    auto get_variable = [this](const std::string& name) -> int {
+        auto it = feature_index.find(name);
+        if (it == feature_index.end()) {
+            throw std::runtime_error("Unknown feature: " + name);
+        }
+        return it->second + 1;
+    };
+    auto create_aux_var = []() -> int {
+        throw std::logic_error("Straightforward conversion does not create auxiliary variables");
+    };
+
+    for (const auto& constraint : source_model->get_constraints()) {
+        auto ast = constraint->get_ast();
+        if (!ast || !constraint->is_pure_boolean() || count_literals(*ast) > MAX_CONSTRAINT_LITERALS) {
+            continue;
+        }
+
+        std::vector<std::vector<int>> constraint_clauses;
+        try {
+            constraint_clauses = constraint->get_clauses(get_variable, create_aux_var, CNFMode::STRAIGHTFORWARD);
+        } catch (const std::runtime_error&) {
+            continue;
+        }
+
+        for (auto& clause : constraint_clauses) {
+            std::sort(clause.begin(), clause.end());
+            clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+
+            int id = static_cast<int>(clauses.size());
+            for (int literal : clause) {
+                auto& occurrences = clause_occurrences[literal_feature(literal)];
+                if (occurrences.empty() || occurrences.back() != id) {
+                    occurrences.push_back(id);
+                }
+            }
+            clauses.push_back(std::move(clause));
+        }
+    }
+}
+
+/**
+ * @brief Records a derived value and schedules its propagation
+ *
+ * @param feature Feature index
+ * @param value CORE or DEAD
+ */
+void StructuralAnalyzer::assign(int feature, State value) {
+    if (states[feature] == value) {
+        return;
+    }
+    if (states[feature] != State::UNKNOWN) {
+        conflict = true;
+        return;
+    }
+    states[feature] = value;
+    queue.push_back(feature);
+}
+
+/**
+ * @brief Applies the group bounds of a relation
+ *
+ * @param group Group index
+ */
+void StructuralAnalyzer::check_group(int group) {
+    if (conflict) {
+        return;
+    }
+    const Group& g = groups[group];
+    int n = static_cast<int>(g.children.size());
+    int selectable = n - g.num_dead;
+
+    // Parent cannot be selected if the bounds can no longer be met
+    if (selectable < g.lower || g.num_core > g.upper || g.lower > g.upper) {
+        assign(g.parent, State::DEAD);
+        return;
+    }
+
+    if (states[g.parent] != State::CORE) {
+        return;
+    }
+    if (selectable == g.lower) {
+        for (int child : g.children) {
+            if (states[child] == State::UNKNOWN) {
+                assign(child, State::CORE);
+            }
+        }
+    } else if (g.num_core == g.upper) {
+        for (int child : g.children) {
+            if (states[child] == State::UNKNOWN) {
+                assign(child, State::DEAD);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Unit-propagates a constraint clause
+ *
+ * @param clause Clause index
+ */
+void StructuralAnalyzer::check_clause(int clause) {
+    if (conflict) {
+        return;
+    }
+    int unassigned = 0;
+    int last_unassigned = 0;
+    for (int literal : clauses[clause]) {
+        State value = literal_value(literal);
+        if (value == State::CORE) {
+            return;
+        }
+        if (value == State::UNKNOWN) {
+            unassigned++;
+            last_unassigned = literal;
+        }
+    }
+
+    if (unassigned == 0) {
+        conflict = true;
+    } else if (unassigned == 1) {
+        assign(literal_feature(last_unassigned), last_unassigned > 0 ? State::CORE : State::DEAD);
+    }
+}
+
+/**
+ * @brief Gets the value of a literal under the current states
+ *
+ * @param literal Literal (+/-(index + 1))
+ * @return CORE if true, DEAD if false, UNKNOWN otherwise
+ */
+StructuralAnalyzer::State StructuralAnalyzer::literal_value(int literal) const {
+    State value = states[literal_feature(literal)];
+    if (literal < 0 && value != State::UNKNOWN) {
+        return value == State::CORE ? State::DEAD : State::CORE;
+    }
+    return value;
+}
+
+/**
+ * @brief Gets the derived value of a feature
+ *
+ * @param name Feature name
+ * @return CORE, DEAD or UNKNOWN
+ */
+StructuralAnalyzer::State StructuralAnalyzer::get_state(const std::string& name) const {
+    auto it = feature_index.find(name);
+    return it == feature_index.end() ? State::UNKNOWN : states[it->second];
+}
+
+/**
+ * @brief Gets the names of all core features
+ * @return Core features in depth-first order
+ */
+std::vector<std::string> StructuralAnalyzer::get_core_features() const {
+    std::vector<std::string> result;
+    for (size_t i = 0; i < states.size(); ++i) {
+        if (states[i] == State::CORE) {
+            result.push_back(feature_names[i]);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Gets the names of all dead features
+ * @return Dead features in depth-first order
+ */
+std::vector<std::string> StructuralAnalyzer::get_dead_features() const {
+    std::vector<std::string> result;
+    for (size_t i = 0; i < states.size(); ++i) {
+        if (states[i] == State::DEAD) {
+            result.push_back(feature_names[i]);
+        }
+    }
+    return result;
+}
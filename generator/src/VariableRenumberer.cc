@@ -0,0 +1,340 @@
+/**
+ * @file VariableRenumberer.cc
+ * @brief Implementation of the variable renumbering strategies
+ *
+ * Every strategy produces the list of old variable IDs in their new order;
+ * renumber() turns it into a permutation and applies it with
+ * CNFModel::remap_variables().
+ *
+ * @author UVL2Dimacs Team
+ * @date 2024
+ */
+
+#include "VariableRenumberer.hh"
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+#include <stdexcept>
+
+/**
+ * @brief Constructs a renumberer for the given strategy
+ *
+ * @param renumber_strategy Ordering to apply
+ */
+VariableRenumberer::VariableRenumberer(RenumberStrategy renumber_strategy)
+    : strategy(renumber_strategy), bandwidth_before(0), bandwidth_after(0) {
+}
+
+/**
+ * @brief Renumbers the variables of a CNF model
+ *
+ * @param model CNF model to renumber in place
+ * @param feature_model Feature tree (only used by TREE_BFS)
+ * @throws std::invalid_argument if TREE_BFS is requested without a feature model
+ */
+void VariableRenumberer::renumber(CNFModel& model, std::shared_ptr<FeatureModel> feature_model) {
+    bandwidth_before = compute_bandwidth(model);
+    bandwidth_after = bandwidth_before;
+
+    std::vector<int> order;
+    switch (strategy) {
+        case RenumberStrategy::NONE:
+            return;
+        case RenumberStrategy::TREE_BFS:
+            if (!feature_model) {
+                throw std::invalid_argument("Tree BFS renumbering requires the feature model");
+            }
+            order = order_tree_bfs(model, *feature_model);
+            break;
+        case RenumberStrategy::CUTHILL_MCKEE:
+            order = order_cuthill_mckee(model);
+            break;
+        case RenumberStrategy::AUX_NEXT_TO_DEFINITION:
+            order = order_aux_next_to_definition(model);
+            break;
+    }
+
+    std::vector<int> literal_map(model.get_num_variables() + 1, 0);
+    for (size_t i = 0; i < order.size(); ++i) {
+        literal_map[order[i]] = static_cast<int>(i) + 1;
+    }
+    model.remap_variables(literal_map);
+    bandwidth_after = compute_bandwidth(model);
+}
+
+/**
+ * @brief Computes the bandwidth of a CNF model
+ *
+ * @param model CNF model
+ * @return Largest difference between variable IDs within one clause
+ */
+int VariableRenumberer::compute_bandwidth(const CNFModel& model) {
+    int bandwidth = 0;
+    for (int c = 0; c < model.get_num_clauses(); ++c) {
+        ClauseView clause = model.get_clause(c);
+        if (clause.empty()) {
+            continue;
+        }
+        int low = std::abs(clause[0]);
+        int high = low;
+        for (int lit : clause) {
+            low = std::min(low, std::abs(lit));
+            high = std::max(high, std::abs(lit));
+        }
+        bandwidth = std::max(bandwidth, high - low);
+    }
+    return bandwidth;
+}
+
+/**
+ * @brief Features in breadth-first tree order, then auxiliaries
+ *
+ * Features that no longer own a variable (merged by remap_variables()) are
+ * skipped; variables not reached from the root keep their relative order.
+ *
+ * @param model CNF model
+ * @param feature_model Feature tree
+ * @return Old variable IDs in their new order
+ */
+std::vector<int> VariableRenumberer::order_tree_bfs(const CNFModel& model,
+                                                    const FeatureModel& feature_model) const {
+    int num_variables = model.get_num_variables();
+    std::vector<char> placed(num_variables + 1, 0);
+    std::vector<int> order;
+    order.reserve(num_variables);
+
+    std::queue<std::shared_ptr<Feature>> pending;
+    if (feature_model.get_root()) {
+        pending.push(feature_model.get_root());
+    }
+    while (!pending.empty()) {
+        auto feature = pending.front();
+        pending.pop();
+
+        const auto& variables = model.get_variables();
+        auto it = variables.find(feature->get_name());
+        if (it != variables.end() && !placed[it->second]) {
+            placed[it->second] = 1;
+            order.push_back(it->second);
+        }
+        for (const auto& relation : feature->get_relations()) {
+            for (const auto& child : relation->get_children()) {
+                pending.push(child);
+            }
+        }
+    }
+
+    // Remaining features, then auxiliary variables, in their current order
+    for (int var = 1; var <= num_variables; ++var) {
+        if (!placed[var] && !model.is_auxiliary(var)) {
+            order.push_back(var);
+        }
+    }
+    for (int var = 1; var <= num_variables; ++var) {
+        if (!placed[var] && model.is_auxiliary(var)) {
+            order.push_back(var);
+        }
+    }
+    return order;
+}
+
+/**
+ * @brief Reverse Cuthill-McKee order of the variable interaction graph
+ *
+ * For each connected component, a pseudo-peripheral start vertex is found by
+ * repeating a breadth-first search from a minimum-degree vertex of the last
+ * level while the eccentricity grows. The Cuthill-McKee order visits
+ * neighbours by increasing degree; the final order is reversed.
+ *
+ * @param model CNF model
+ * @return Old variable IDs in their new order
+ */
+std::vector<int> VariableRenumberer::order_cuthill_mckee(const CNFModel& model) const {
+    int num_variables = model.get_num_variables();
+
+    // Interaction graph in CSR form (edges listed in both directions)
+    std::vector<std::pair<int, int>> edge_list;
+    for (int c = 0; c < model.get_num_clauses(); ++c) {
+        ClauseView clause = model.get_clause(c);
+        size_t n = clause.size();
+        if (n <= MAX_CLIQUE_CLAUSE) {
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = i + 1; j < n; ++j) {
+                    edge_list.emplace_back(std::abs(clause[i]), std::abs(clause[j]));
+                }
+            }
+        } else {
+            for (size_t i = 1; i < n; ++i) {
+                edge_list.emplace_back(std::abs(clause[i - 1]), std::abs(clause[i]));
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> neighbours(num_variables + 1);
+    for (const auto& edge : edge_list) {
+        if (edge.first != edge.second) {
+            neighbours[edge.first].push_back(edge.second);
+            neighbours[edge.second].push_back(edge.first);
+        }
+    }
+    edge_list.clear();
+    edge_list.shrink_to_fit();
+
+    std::vector<int> degree(num_variables + 1, 0);
+    for (int var = 1; var <= num_variables; ++var) {
+        auto& adj = neighbours[var];
+        std::sort(adj.begin(), adj.end());
+        adj.erase(std::unique(adj.begin(), adj.end()), adj.end());
+        degree[var] = static_cast<int>(adj.size());
+    }
+    auto by_degree = [&degree](int a, int b) {
+        return degree[a] < degree[b] || (degree[a] == degree[b] && a < b);
+    };
+    for (int var = 1; var <= num_variables; ++var) {
+        std::sort(neighbours[var].begin(), neighbours[var].end(), by_degree);
+    }
+
+    // Breadth-first search returning the last level; level_of is scratch space
+    std::vector<int> level_of(num_variables + 1, -1);
+    auto last_level = [&](int start, int& eccentricity) {
+        std::vector<int> visited{start};
+        level_of[start] = 0;
+        for (size_t i = 0; i < visited.size(); ++i) {
+            int v = visited[i];
+            for (int w : neighbours[v]) {
+                if (level_of[w] < 0) {
+                    level_of[w] = level_of[v] + 1;
+                    visited.push_back(w);
+                }
+            }
+        }
+        eccentricity = level_of[visited.back()];
+        std::vector<int> last;
+        for (int v : visited) {
+            if (level_of[v] == eccentricity) {
+                last.push_back(v);
+            }
+        }
+        for (int v : visited) {
+            level_of[v] = -1;
+        }
+        return last;
+    };
+
+    std::vector<int> candidates(num_variables);
+    for (int var = 1; var <= num_variables; ++var) {
+        candidates[var - 1] = var;
+    }
+    std::sort(candidates.begin(), candidates.end(), by_degree);
+
+    std::vector<char> placed(num_variables + 1, 0);
+    std::vector<int> order;
+    order.reserve(num_variables);
+
+    for (int candidate : candidates) {
+        if (placed[candidate]) {
+            continue;
+        }
+
+        // Pseudo-peripheral start vertex
+        int start = candidate;
+        int eccentricity = 0;
+        std::vector<int> level = last_level(start, eccentricity);
+        for (int round = 0; round < 4; ++round) {
+            int next = *std::min_element(level.begin(), level.end(), by_degree);
+            int next_eccentricity = 0;
+            std::vector<int> next_level = last_level(next, next_eccentricity);
+            if (next_eccentricity <= eccentricity) {
+                break;
+            }
+            start = next;
+            eccentricity = next_eccentricity;
+            level = std::move(next_level);
+        }
+
+        // Cuthill-McKee from the start vertex
+        size_t head = order.size();
+        order.push_back(start);
+        placed[start] = 1;
+        while (head < order.size()) {
+            int v = order[head++];
+            for (int w : neighbours[v]) {
+                if (!placed[w]) {
+                    placed[w] = 1;
+                    order.push_back(w);
+                }
+            }
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+/**
+ * @brief Features in current order, each auxiliary after its latest input
+ *
+ * The inputs of an auxiliary variable are the other variables of the first
+ * clause it appears in (its Tseitin or OR-tree definition). An auxiliary is
+ * anchored to the latest feature among its inputs, inheriting the anchor of
+ * auxiliary inputs; auxiliaries with the same anchor keep their creation
+ * order, and those without any anchor are placed last.
+ *
+ * @param model CNF model
+ * @return Old variable IDs in their new order
+ */
+std::vector<int> VariableRenumberer::order_aux_next_to_definition(const CNFModel& model) const {
+    int num_variables = model.get_num_variables();
+    const int UNSET = -2;
+    const int NO_ANCHOR = -1;
+
+    // Features keep their relative order; rank = position among features
+    std::vector<int> features;
+    std::vector<int> anchor(num_variables + 1, UNSET);
+    for (int var = 1; var <= num_variables; ++var) {
+        if (!model.is_auxiliary(var)) {
+            anchor[var] = static_cast<int>(features.size());
+            features.push_back(var);
+        }
+    }
+
+    std::vector<int> fresh;
+    for (int c = 0; c < model.get_num_clauses(); ++c) {
+        ClauseView clause = model.get_clause(c);
+        int latest = NO_ANCHOR;
+        fresh.clear();
+        for (int lit : clause) {
+            int var = std::abs(lit);
+            if (anchor[var] == UNSET) {
+                fresh.push_back(var);
+            } else {
+                latest = std::max(latest, anchor[var]);
+            }
+        }
+        for (int var : fresh) {
+            anchor[var] = latest;
+        }
+    }
+
+    std::vector<std::vector<int>> anchored(features.size());
+    std::vector<int> unanchored;
+    for (int var = 1; var <= num_variables; ++var) {
+        if (!model.is_auxiliary(var)) {
+            continue;
+        }
+        if (anchor[var] >= 0) {
+            anchored[anchor[var]].push_back(var);
+        } else {
+            unanchored.push_back(var);
+        }
+    }
+
+    std::vector<int> order;
+    order.reserve(num_variables);
+    for (size_t rank = 0; rank < features.size(); ++rank) {
+        order.push_back(features[rank]);
+        order.insert(order.end(), anchored[rank].begin(), anchored[rank].end());
+    }
+    order.insert(order.end(), unanchored.begin(), unanchored.end());
+    return order;
+}
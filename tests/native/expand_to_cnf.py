@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""
+Expands a KNF or OPB file written by uvl2dimacs -f knf / -f opb to plain CNF.
+
+Usage: expand_to_cnf.py <input.knf|input.opb> <output.dimacs>
+
+Every cardinality or pseudo-Boolean constraint is replaced by the clauses it
+implies, so the output can be given to an ordinary #SAT solver and its count
+compared with that of the straightforward (-s) conversion. Clauses keep their
+variables, so no variable is added or removed.
+
+A constraint sum(a_i * l_i) >= d with positive coefficients a_i (a negative
+literal -x counts as 1 - x) is violated exactly when the literals left true
+sum to less than d. Its clauses are the minimal sets S of literals whose
+falsification already violates it: one clause (l_1 v ... v l_m) per S. For
+"at least k of n" this gives every subset of n - k + 1 literals.
+
+Exits with 2 if a constraint would expand to more than MAX_CLAUSES clauses.
+"""
+
+import sys
+
+MAX_CLAUSES = 200000
+
+
+def normalize_opb(tokens):
+    """Turns `<coef> x<v> ... >= <degree> ;` into (terms, degree) with positive coefficients."""
+    terms = []
+    degree = int(tokens[-2])
+    for coefficient, variable in zip(tokens[0:-3:2], tokens[1:-3:2]):
+        coefficient = int(coefficient)
+        var = int(variable[1:])
+        if coefficient > 0:
+            terms.append((coefficient, var))
+        elif coefficient < 0:
+            # a * x = a + |a| * (1 - x), i.e. |a| on the negated literal
+            terms.append((-coefficient, -var))
+            degree -= coefficient
+    return terms, degree
+
+
+def falsifying_sets(terms, degree, out):
+    """Appends every minimal set of literals whose falsification violates the constraint."""
+    terms = sorted(terms, reverse=True)
+    total = sum(coefficient for coefficient, _ in terms)
+    if degree <= 0:
+        return
+    if total < degree:
+        out.append([])
+        return
+    chosen = []
+
+    def search(index, remaining):
+        # remaining = sum of the coefficients not falsified so far
+        if remaining < degree:
+            # Minimal when every chosen literal is needed, i.e. the smallest one is
+            if remaining + terms[chosen[-1]][0] >= degree:
+                out.append([terms[i][1] for i in chosen])
+                if len(out) > MAX_CLAUSES:
+                    raise OverflowError
+            return
+        for i in range(index, len(terms)):
+            chosen.append(i)
+            search(i + 1, remaining - terms[i][0])
+            chosen.pop()
+
+    search(0, total)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip().splitlines()[2])
+        return 2
+
+    num_variables = 0
+    clauses = []
+    with open(sys.argv[1]) as f:
+        for line in f:
+            tokens = line.split()
+            if not tokens or tokens[0] == 'c':
+                continue
+            if tokens[0] == '*':
+                if len(tokens) > 2 and tokens[1] == '#variable=':
+                    num_variables = int(tokens[2])
+                continue
+            if tokens[0] == 'p':
+                num_variables = int(tokens[2])
+                continue
+            try:
+                if tokens[0] == 'k':
+                    bound = int(tokens[1])
+                    falsifying_sets([(1, int(t)) for t in tokens[2:-1]], bound, clauses)
+                elif tokens[-1] == ';':
+                    terms, degree = normalize_opb(tokens)
+                    falsifying_sets(terms, degree, clauses)
+                else:
+                    clauses.append([int(t) for t in tokens[:-1]])
+            except OverflowError:
+                print("Constraint expands to more than %d clauses: %s" % (MAX_CLAUSES, line.strip()))
+                return 2
+
+    with open(sys.argv[2], 'w') as f:
+        f.write("p cnf %d %d\n" % (num_variables, len(clauses)))
+        for clause in clauses:
+            f.write(" ".join(map(str, clause + [0])) + "\n")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,233 @@
+#!/bin/bash
+#
+# Test script for the native cardinality formats (-f knf, -f opb)
+#
+# KNF and OPB keep alternative and [min..max] groups as cardinality
+# constraints, which SharpSAT-TD cannot read. This script verifies that they
+# still describe the same configurations as the straightforward conversion:
+# 1. Converts each UVL model with -s, -f knf and -f opb
+# 2. Expands every cardinality / pseudo-Boolean constraint of the KNF and OPB
+#    files back to clauses (expand_to_cnf.py)
+# 3. Counts solutions using SharpSAT-TD and verifies that all three counts
+#    match exactly
+#
+# The corpus has no cardinality groups, so the fixtures in
+# tests/cardinality/uvl are always tested in addition; their lower bounds
+# above 1 exercise the parent copies of KNF and the weighted guards of OPB.
+#
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+# Get script directory and project root
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(cd "$SCRIPT_DIR/../.." && pwd)"
+
+# Directories
+UVL_DIR="$PROJECT_ROOT/tests/straightforward/uvl"
+CARDINALITY_UVL_DIR="$PROJECT_ROOT/tests/cardinality/uvl"
+DIMACS_DIR="$SCRIPT_DIR/dimacs"
+
+# Executables
+CLI="$PROJECT_ROOT/build/uvl2dimacs"
+EXPANDER="$SCRIPT_DIR/expand_to_cnf.py"
+SHARPSAT_DIR="$PROJECT_ROOT/tests/sharpsat-td"
+SHARPSAT="$SHARPSAT_DIR/bin/sharpSAT"
+
+# Native formats compared with the straightforward count
+FORMATS=(knf opb)
+
+# Temporary directory for SharpSAT (passed via -tmpdir flag)
+TEMP_DIR="/tmp/sharpsat_native_test_$$"
+mkdir -p "$TEMP_DIR"
+
+# Cleanup on exit
+trap "rm -rf $TEMP_DIR" EXIT
+
+# Check if required tools exist
+if [ ! -f "$CLI" ]; then
+    echo -e "${RED}Error: uvl2dimacs CLI not found at $CLI${NC}"
+    echo "Please build the project first with: make"
+    exit 1
+fi
+
+if [ ! -f "$SHARPSAT" ]; then
+    echo -e "${RED}Error: SharpSAT-TD not found at $SHARPSAT${NC}"
+    echo "See tests/tseitin/test_tseitin.sh for installation instructions."
+    exit 1
+fi
+
+if ! command -v python3 >/dev/null 2>&1; then
+    echo -e "${RED}Error: python3 is required to run $EXPANDER${NC}"
+    exit 1
+fi
+
+if [ ! -d "$UVL_DIR" ]; then
+    echo -e "${RED}Error: UVL directory not found: $UVL_DIR${NC}"
+    exit 1
+fi
+
+# Create output directory
+mkdir -p "$DIMACS_DIR"
+
+# Function to count solutions using SharpSAT-TD
+# Args: $1 = DIMACS file path
+# Returns: Solution count (or "UNSAT" if unsatisfiable, "ERROR" if failed)
+count_solutions() {
+    local dimacs_file="$1"
+    local abs_dimacs_file="$(cd "$(dirname "$dimacs_file")" && pwd)/$(basename "$dimacs_file")"
+
+    # SharpSAT must be run from its bin directory (requires flow_cutter_pace17 in same dir)
+    cd "$SHARPSAT_DIR/bin" || {
+        echo "ERROR"
+        return 1
+    }
+
+    local output=$(./sharpSAT -decot 1 -tmpdir "$TEMP_DIR" "$abs_dimacs_file" 2>&1)
+    local exit_code=$?
+    cd - > /dev/null
+
+    if echo "$output" | grep -q "s UNSATISFIABLE"; then
+        echo "UNSAT"
+        return 0
+    fi
+    local count=$(echo "$output" | grep "c s exact arb int" | awk '{print $NF}')
+    if [ $exit_code -ne 0 ] || [ -z "$count" ]; then
+        echo "ERROR"
+        return 1
+    fi
+
+    echo "$count"
+    return 0
+}
+
+# Function to convert a model to each native format and compare counts
+# Args: $1 = UVL file, $2 = basename, $3 = expected solution count
+# Returns: Empty string if all counts match, otherwise a failure description
+check_native_formats() {
+    local uvl_file="$1"
+    local basename="$2"
+    local expected="$3"
+
+    for format in "${FORMATS[@]}"; do
+        local native_file="$DIMACS_DIR/${basename}.${format}"
+        local expanded_dimacs="$DIMACS_DIR/${basename}_${format}.dimacs"
+        if ! "$CLI" -f "$format" "$uvl_file" "$native_file" >/dev/null 2>&1; then
+            echo "-f $format: conversion failed"
+            return 0
+        fi
+        local expand_output
+        if ! expand_output=$(python3 "$EXPANDER" "$native_file" "$expanded_dimacs"); then
+            echo "-f $format: expansion failed: $expand_output"
+            return 0
+        fi
+        local count_native=$(count_solutions "$expanded_dimacs")
+        if [ "$count_native" != "$expected" ]; then
+            echo "-f $format: $count_native solutions, expected $expected"
+            return 0
+        fi
+    done
+    return 0
+}
+
+echo "============================================================"
+echo "Testing Native Cardinality Formats (KNF, OPB)"
+echo "============================================================"
+echo ""
+echo -e "${BLUE}This test verifies that the KNF and OPB outputs, expanded back"
+echo -e "to clauses, have the solution count of the -s output.${NC}"
+echo ""
+echo "CLI: $CLI"
+echo "SharpSAT-TD: $SHARPSAT"
+echo "UVL files: $UVL_DIR"
+echo "Output: $DIMACS_DIR"
+echo ""
+
+# Test parameters
+NUM_TESTS=${1:-20}  # Default to 20 tests, can override with argument
+
+# Get list of UVL files (sort by size, take smallest ones for faster testing)
+echo "Selecting $NUM_TESTS models (preferring smaller ones for speed)..."
+uvl_files=($(find "$UVL_DIR" -name "*.uvl" -exec wc -l {} \; 2>/dev/null | sort -n | head -n "$NUM_TESTS" | awk '{print $2}'))
+
+# Add the cardinality fixtures
+uvl_files+=($(find "$CARDINALITY_UVL_DIR" -name "*.uvl" 2>/dev/null | sort))
+
+if [ ${#uvl_files[@]} -eq 0 ]; then
+    echo -e "${RED}Error: No UVL files found${NC}"
+    exit 1
+fi
+
+echo "Selected ${#uvl_files[@]} files to test"
+echo ""
+
+# Counters
+total=0
+passed=0
+failed=0
+
+for uvl_file in "${uvl_files[@]}"; do
+    basename=$(basename "$uvl_file" .uvl)
+    straight_dimacs="$DIMACS_DIR/${basename}_s.dimacs"
+
+    ((total++))
+    echo -n "[$total/${#uvl_files[@]}] Testing $basename... "
+
+    if ! "$CLI" -s "$uvl_file" "$straight_dimacs" >/dev/null 2>&1; then
+        echo -e "${RED}FAIL (straightforward conversion failed)${NC}"
+        ((failed++))
+        continue
+    fi
+
+    count_straight=$(count_solutions "$straight_dimacs")
+    if [ "$count_straight" = "ERROR" ]; then
+        echo -e "${RED}FAIL (straightforward counting failed)${NC}"
+        ((failed++))
+        continue
+    fi
+
+    format_failure=$(check_native_formats "$uvl_file" "$basename" "$count_straight")
+    if [ -n "$format_failure" ]; then
+        echo -e "${RED}FAIL (native format)${NC}"
+        echo "  $format_failure"
+        ((failed++))
+        continue
+    fi
+
+    cardinality=$(grep -c "^k " "$DIMACS_DIR/${basename}.knf")
+    echo -e "${GREEN}PASS ($cardinality cardinality constraints, solutions: $count_straight)${NC}"
+    ((passed++))
+done
+
+# Summary
+echo ""
+echo "============================================================"
+echo "Test Summary"
+echo "============================================================"
+echo "Total tests: $total"
+echo -e "${GREEN}Passed: $passed${NC}"
+if [ $failed -gt 0 ]; then
+    echo -e "${RED}Failed: $failed${NC}"
+else
+    echo "Failed: 0"
+fi
+echo "============================================================"
+
+if [ $failed -eq 0 ] && [ $passed -gt 0 ]; then
+    echo ""
+    echo -e "${GREEN}✓ All tests passed!${NC}"
+    echo ""
+    echo "KNF and OPB outputs preserve the straightforward solution counts."
+    exit 0
+else
+    echo ""
+    echo -e "${RED}✗ Some tests failed!${NC}"
+    echo ""
+    echo -e "${BLUE}Check RelationEncoder::encode_native_cardinality() and the"
+    echo -e "add_at_least() / add_guarded_at_least() writers.${NC}"
+    exit 1
+fi
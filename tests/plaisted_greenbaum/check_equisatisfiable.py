@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""
+Checks that two DIMACS files accept exactly the same feature assignments.
+
+Usage: check_equisatisfiable.py <reference.dimacs> <candidate.dimacs>
+
+The reference is a straightforward (-s) conversion, whose variables are all
+features. The candidate (e.g. a Plaisted-Greenbaum conversion, -T) uses the
+same feature IDs 1..N and adds auxiliary variables above N. The script checks
+that every feature assignment satisfies the reference clauses exactly when
+the candidate clauses, with the features fixed, can be satisfied by some
+assignment of the auxiliary variables.
+
+All 2^N assignments are covered by a depth-first search over the features
+that prunes a subtree as soon as its answer is known for every assignment in
+it: once a reference clause is falsified, the candidate with the features
+assigned so far must be unsatisfiable; once unit propagation refutes the
+candidate, no reference solution may extend the assignment.
+
+Prints "OK <satisfying assignments>" and exits with 0 if the two files agree,
+otherwise prints the first differing assignment and exits with 1.
+"""
+
+import sys
+
+
+def read_dimacs(path):
+    """Returns (number of features, number of variables, clauses)."""
+    num_features = None
+    num_variables = 0
+    clauses = []
+    with open(path) as f:
+        for line in f:
+            tokens = line.split()
+            if not tokens:
+                continue
+            if tokens[0] == 'c':
+                if tokens[1:3] == ['Original', 'features:']:
+                    num_features = int(tokens[3])
+                continue
+            if tokens[0] == 'p':
+                num_variables = int(tokens[2])
+                continue
+            clauses.append([int(t) for t in tokens[:-1]])
+    if num_features is None:
+        num_features = num_variables
+    return num_features, num_variables, clauses
+
+
+class Solver:
+    """Small DPLL solver with unit propagation and an undo trail."""
+
+    def __init__(self, num_variables, clauses):
+        self.clauses = clauses
+        self.value = [None] * (num_variables + 1)
+        self.trail = []
+        self.occurrences = {}
+        for index, clause in enumerate(clauses):
+            for lit in clause:
+                self.occurrences.setdefault(-lit, []).append(index)
+        self.variables = sorted(set(abs(lit) for clause in clauses for lit in clause))
+        self.empty = any(not clause for clause in clauses)
+
+    def assign(self, lit):
+        """Assigns a literal and propagates; returns False on a conflict."""
+        queue = [lit]
+        while queue:
+            lit = queue.pop()
+            current = self.value[abs(lit)]
+            if current is not None:
+                if current != (lit > 0):
+                    return False
+                continue
+            self.value[abs(lit)] = lit > 0
+            self.trail.append(abs(lit))
+            # Only clauses containing the falsified literal can become unit or empty
+            for index in self.occurrences.get(lit, ()):
+                unassigned = None
+                count = 0
+                for other in self.clauses[index]:
+                    value = self.value[abs(other)]
+                    if value is None:
+                        unassigned = other
+                        count += 1
+                    elif value == (other > 0):
+                        break
+                else:
+                    if count == 0:
+                        return False
+                    if count == 1:
+                        queue.append(unassigned)
+        return True
+
+    def undo(self, mark):
+        """Unassigns everything assigned after the trail had length mark."""
+        while len(self.trail) > mark:
+            self.value[self.trail.pop()] = None
+
+    def solve(self):
+        """Checks whether the current assignment extends to a solution (state is restored)."""
+        if self.empty:
+            return False
+        for var in self.variables:
+            if self.value[var] is None:
+                break
+        else:
+            return True
+        mark = len(self.trail)
+        for lit in (var, -var):
+            if self.assign(lit) and self.solve():
+                self.undo(mark)
+                return True
+            self.undo(mark)
+        return False
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip().splitlines()[2])
+        return 2
+
+    num_features, _, reference = read_dimacs(sys.argv[1])
+    candidate_features, num_variables, candidate = read_dimacs(sys.argv[2])
+    if candidate_features != num_features:
+        print("MISMATCH feature counts differ: %d vs %d" % (num_features, candidate_features))
+        return 1
+
+    # Each reference clause is checked once its largest variable is assigned
+    by_last = [[] for _ in range(num_features + 1)]
+    for clause in reference:
+        by_last[max((abs(lit) for lit in clause), default=0)].append(clause)
+    solver = Solver(max(num_variables, num_features), candidate)
+    values = [None] * (num_features + 1)
+
+    def holds(lit):
+        return values[abs(lit)] == (lit > 0)
+
+    def reference_extends(var):
+        """Checks whether features var..N can be assigned to satisfy the reference."""
+        if var > num_features:
+            return True
+        for value in (False, True):
+            values[var] = value
+            if all(any(holds(lit) for lit in clause) for clause in by_last[var]) and reference_extends(var + 1):
+                values[var] = None
+                return True
+        values[var] = None
+        return False
+
+    def describe():
+        return [var for var in range(1, num_features + 1) if values[var]]
+
+    def search(var, candidate_consistent):
+        """Returns the number of reference solutions below this node, or None on a mismatch."""
+        if not candidate_consistent:
+            if reference_extends(var):
+                print("MISMATCH features %s true (then completed): reference SAT, candidate UNSAT" % describe())
+                return None
+            return 0
+        if var > num_features:
+            if not solver.solve():
+                print("MISMATCH features %s true: reference SAT, candidate UNSAT" % describe())
+                return None
+            return 1
+        accepted = 0
+        for value in (False, True):
+            values[var] = value
+            mark = len(solver.trail)
+            consistent = solver.assign(var if value else -var)
+            if all(any(holds(lit) for lit in clause) for clause in by_last[var]):
+                found = search(var + 1, consistent)
+            elif consistent and solver.solve():
+                print("MISMATCH features %s true (then completed): reference UNSAT, candidate SAT" % describe())
+                found = None
+            else:
+                found = 0
+            solver.undo(mark)
+            if found is None:
+                return None
+            accepted += found
+        values[var] = None
+        return accepted
+
+    if any(not clause for clause in reference):
+        accepted = 0 if not solver.solve() else None
+        if accepted is None:
+            print("MISMATCH reference is empty-clause UNSAT, candidate SAT")
+    else:
+        accepted = search(1, not solver.empty)
+    if accepted is None:
+        return 1
+    print("OK %d" % accepted)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.setrecursionlimit(100000)
+    sys.exit(main())
@@ -0,0 +1,184 @@
+#!/bin/bash
+#
+# Test script for the Plaisted-Greenbaum transformation (-T)
+#
+# The polarity-aware transformation only emits the gate directions a
+# constraint needs, so auxiliary variables are not fully defined and model
+# counts are NOT preserved. What must be preserved is the set of valid
+# feature configurations. This script verifies exactly that:
+# 1. Selects small UVL models (at most MAX_FEATURES features) whose -T
+#    conversion has auxiliary variables, plus the cardinality fixtures
+# 2. Converts each model with -s and -T
+# 3. For every assignment of the features, checks that the -T clauses are
+#    satisfiable exactly when the -s clauses are (check_equisatisfiable.py)
+#
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+# Get script directory and project root
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(cd "$SCRIPT_DIR/../.." && pwd)"
+
+# Directories
+UVL_DIR="$PROJECT_ROOT/tests/straightforward/uvl"
+CARDINALITY_UVL_DIR="$PROJECT_ROOT/tests/cardinality/uvl"
+DIMACS_DIR="$SCRIPT_DIR/dimacs"
+
+# Executables
+CLI="$PROJECT_ROOT/build/uvl2dimacs"
+CHECKER="$SCRIPT_DIR/check_equisatisfiable.py"
+
+# Test parameters
+NUM_TESTS=${1:-20}      # Corpus models to test (default 20)
+MAX_FEATURES=${2:-40}   # Bounds the feature-assignment search of the checker
+
+# Check if required tools exist
+if [ ! -f "$CLI" ]; then
+    echo -e "${RED}Error: uvl2dimacs CLI not found at $CLI${NC}"
+    echo "Please build the project first with: make"
+    exit 1
+fi
+
+if ! command -v python3 >/dev/null 2>&1; then
+    echo -e "${RED}Error: python3 is required to run $CHECKER${NC}"
+    exit 1
+fi
+
+if [ ! -d "$UVL_DIR" ]; then
+    echo -e "${RED}Error: UVL directory not found: $UVL_DIR${NC}"
+    exit 1
+fi
+
+# Create output directory
+mkdir -p "$DIMACS_DIR"
+
+# Function to read the number of features from a DIMACS header
+# Args: $1 = DIMACS file path
+get_num_features() {
+    grep -m1 "^c Original features:" "$1" | awk '{print $4}'
+}
+
+# Function to read the number of variables from a DIMACS header
+# Args: $1 = DIMACS file path
+get_num_variables() {
+    grep -m1 "^p cnf" "$1" | awk '{print $3}'
+}
+
+echo "============================================================"
+echo "Testing Plaisted-Greenbaum Transformation (equisatisfiability)"
+echo "============================================================"
+echo ""
+echo -e "${BLUE}This test verifies that for every feature assignment the -T"
+echo -e "output is satisfiable exactly when the -s output is.${NC}"
+echo ""
+echo "CLI: $CLI"
+echo "UVL files: $UVL_DIR"
+echo "DIMACS output: $DIMACS_DIR"
+echo ""
+
+# Select the smallest corpus models where -T introduces auxiliary variables
+echo "Selecting $NUM_TESTS models with at most $MAX_FEATURES features and auxiliary variables..."
+uvl_files=()
+for uvl_file in $(find "$UVL_DIR" -name "*.uvl" -exec wc -l {} \; 2>/dev/null | sort -n | awk '{print $2}'); do
+    [ ${#uvl_files[@]} -ge $NUM_TESTS ] && break
+    basename=$(basename "$uvl_file" .uvl)
+    pg_dimacs="$DIMACS_DIR/${basename}_T.dimacs"
+    "$CLI" -T "$uvl_file" "$pg_dimacs" >/dev/null 2>&1 || continue
+    num_features=$(get_num_features "$pg_dimacs")
+    num_variables=$(get_num_variables "$pg_dimacs")
+    if [ "$num_features" -le "$MAX_FEATURES" ] && [ "$num_variables" -gt "$num_features" ]; then
+        uvl_files+=("$uvl_file")
+    fi
+done
+
+# Add the cardinality fixtures
+uvl_files+=($(find "$CARDINALITY_UVL_DIR" -name "*.uvl" 2>/dev/null | sort))
+
+if [ ${#uvl_files[@]} -eq 0 ]; then
+    echo -e "${RED}Error: No UVL files selected${NC}"
+    exit 1
+fi
+
+echo "Selected ${#uvl_files[@]} files to test"
+echo ""
+
+# Counters
+total=0
+passed=0
+failed=0
+skipped=0
+
+for uvl_file in "${uvl_files[@]}"; do
+    basename=$(basename "$uvl_file" .uvl)
+    straight_dimacs="$DIMACS_DIR/${basename}_s.dimacs"
+    pg_dimacs="$DIMACS_DIR/${basename}_T.dimacs"
+
+    ((total++))
+    echo -n "[$total/${#uvl_files[@]}] Testing $basename... "
+
+    if ! "$CLI" -s "$uvl_file" "$straight_dimacs" >/dev/null 2>&1; then
+        echo -e "${RED}FAIL (straightforward conversion failed)${NC}"
+        ((failed++))
+        continue
+    fi
+    if ! "$CLI" -T "$uvl_file" "$pg_dimacs" >/dev/null 2>&1; then
+        echo -e "${RED}FAIL (Plaisted-Greenbaum conversion failed)${NC}"
+        ((failed++))
+        continue
+    fi
+
+    num_features=$(get_num_features "$pg_dimacs")
+    if [ "$num_features" -gt "$MAX_FEATURES" ] && [ "$(dirname "$uvl_file")" != "$CARDINALITY_UVL_DIR" ]; then
+        echo -e "${YELLOW}SKIP ($num_features features)${NC}"
+        ((skipped++))
+        continue
+    fi
+
+    output=$(python3 "$CHECKER" "$straight_dimacs" "$pg_dimacs")
+    if [ $? -eq 0 ]; then
+        aux=$(( $(get_num_variables "$pg_dimacs") - num_features ))
+        echo -e "${GREEN}PASS ($num_features features, $aux auxiliary, $(echo "$output" | awk '{print $2}') configurations)${NC}"
+        ((passed++))
+    else
+        echo -e "${RED}FAIL${NC}"
+        echo "  $output"
+        ((failed++))
+    fi
+done
+
+# Summary
+echo ""
+echo "============================================================"
+echo "Test Summary"
+echo "============================================================"
+echo "Total tests: $total"
+echo -e "${GREEN}Passed: $passed${NC}"
+if [ $failed -gt 0 ]; then
+    echo -e "${RED}Failed: $failed${NC}"
+else
+    echo "Failed: 0"
+fi
+if [ $skipped -gt 0 ]; then
+    echo -e "${YELLOW}Skipped: $skipped${NC}"
+fi
+echo "============================================================"
+
+if [ $failed -eq 0 ] && [ $passed -gt 0 ]; then
+    echo ""
+    echo -e "${GREEN}✓ All tests passed!${NC}"
+    echo ""
+    echo "The -T output accepts exactly the feature configurations of -s."
+    exit 0
+else
+    echo ""
+    echo -e "${RED}✗ Some tests failed!${NC}"
+    echo ""
+    echo "This suggests a bug in the polarity tracking (ASTNode::tseitin_assert)"
+    echo "or in the direction flags of shared gates (GateCache)."
+    exit 1
+fi
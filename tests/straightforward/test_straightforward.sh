@@ -5,7 +5,9 @@
 # This script:
 # 1. Runs uvl2dimacs CLI with -s flag on all UVL files in the uvl/ directory
 # 2. Compares the generated DIMACS files with the reference DIMACS files in dimacs/
-# 3. Reports matches and mismatches
+# 3. Checks that -j 4 writes byte-identical output to -j 1 for every option set
+#    in THREAD_VARIANTS
+# 4. Reports matches and mismatches
 #
 
 # Colors for output
@@ -24,6 +26,14 @@ DIMACS_DIR="$SCRIPT_DIR/dimacs"
 TEMP_DIR="$SCRIPT_DIR/temp_test_output"
 CLI_PATH="$PROJECT_ROOT/build/uvl2dimacs"
 
+# Option sets whose output must not depend on the number of threads (-j)
+THREAD_VARIANTS=(
+    "-s"
+    "-s -c"
+    "-s -a product:2"
+    "-s -l"
+)
+
 # Check if CLI exists
 if [ ! -f "$CLI_PATH" ]; then
     echo -e "${RED}Error: CLI not found at $CLI_PATH${NC}"
@@ -45,6 +55,29 @@ fi
 # Create temp directory for generated files
 mkdir -p "$TEMP_DIR"
 
+# Function to convert a model with -j 1 and -j 4 and compare the outputs
+# Args: $1 = UVL file, $2 = basename
+# Returns: Empty string if all outputs are identical, otherwise a failure description
+check_threads() {
+    local uvl_file="$1"
+    local basename="$2"
+
+    for variant in "${THREAD_VARIANTS[@]}"; do
+        local sequential="$TEMP_DIR/${basename}_j1.dimacs"
+        local parallel="$TEMP_DIR/${basename}_j4.dimacs"
+        if ! "$CLI_PATH" $variant -j 1 "$uvl_file" "$sequential" >/dev/null 2>&1 ||
+           ! "$CLI_PATH" $variant -j 4 "$uvl_file" "$parallel" >/dev/null 2>&1; then
+            echo "$variant: conversion failed"
+            return 0
+        fi
+        if ! cmp -s "$sequential" "$parallel"; then
+            echo "$variant: -j 4 output differs from -j 1"
+            return 0
+        fi
+    done
+    return 0
+}
+
 # Counters
 total=0
 passed=0
@@ -96,12 +129,19 @@ for uvl_file in "${uvl_files[@]}"; do
         grep -v "^c " "$reference_dimacs" | grep -v "^$" > "$TEMP_DIR/ref_${basename}.stripped" 2>/dev/null || touch "$TEMP_DIR/ref_${basename}.stripped"
         grep -v "^c " "$generated_dimacs" | grep -v "^$" > "$TEMP_DIR/gen_${basename}.stripped" 2>/dev/null || touch "$TEMP_DIR/gen_${basename}.stripped"
 
-        if diff -q "$TEMP_DIR/ref_${basename}.stripped" "$TEMP_DIR/gen_${basename}.stripped" >/dev/null 2>&1; then
-            echo -e "${GREEN}[PASS]${NC} $basename"
-            ((passed++))
-        else
+        if ! diff -q "$TEMP_DIR/ref_${basename}.stripped" "$TEMP_DIR/gen_${basename}.stripped" >/dev/null 2>&1; then
             echo -e "${RED}[FAIL]${NC} $basename - Generated DIMACS differs from reference"
             ((failed++))
+            continue
+        fi
+
+        thread_failure=$(check_threads "$uvl_file" "$basename")
+        if [ -n "$thread_failure" ]; then
+            echo -e "${RED}[FAIL]${NC} $basename - $thread_failure"
+            ((failed++))
+        else
+            echo -e "${GREEN}[PASS]${NC} $basename"
+            ((passed++))
         fi
     else
         echo -e "${RED}[FAIL]${NC} $basename - Conversion failed"
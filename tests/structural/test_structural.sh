@@ -0,0 +1,185 @@
+#!/bin/bash
+#
+# Test script for structural simplification (-c)
+#
+# This script checks the core/dead propagation of StructuralAnalyzer on small
+# fixtures with known results:
+# 1. Converts each fixture in tests/structural/uvl with -c
+# 2. Compares the reported core and dead feature counts and the void warning
+#    with the expected values below
+# 3. If SharpSAT-TD is installed, verifies that -c preserves the solution
+#    count of the straightforward conversion
+#
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+# Get script directory and project root
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(cd "$SCRIPT_DIR/../.." && pwd)"
+
+# Directories
+UVL_DIR="$SCRIPT_DIR/uvl"
+DIMACS_DIR="$SCRIPT_DIR/dimacs"
+
+# Executables
+CLI="$PROJECT_ROOT/build/uvl2dimacs"
+SHARPSAT_DIR="$PROJECT_ROOT/tests/sharpsat-td"
+SHARPSAT="$SHARPSAT_DIR/bin/sharpSAT"
+
+# Temporary directory for SharpSAT (passed via -tmpdir flag)
+TEMP_DIR="/tmp/sharpsat_structural_test_$$"
+mkdir -p "$TEMP_DIR"
+
+# Cleanup on exit
+trap "rm -rf $TEMP_DIR" EXIT
+
+# Expected results: fixture core dead void
+EXPECTED=(
+    "core_dead 5 3 no"
+    "void 0 0 yes"
+)
+
+# Check if required tools exist
+if [ ! -f "$CLI" ]; then
+    echo -e "${RED}Error: uvl2dimacs CLI not found at $CLI${NC}"
+    echo "Please build the project first with: make"
+    exit 1
+fi
+
+use_sharpsat=true
+if [ ! -f "$SHARPSAT" ]; then
+    echo -e "${YELLOW}SharpSAT-TD not found at $SHARPSAT: solution counts are not compared${NC}"
+    echo "See tests/tseitin/test_tseitin.sh for installation instructions."
+    echo ""
+    use_sharpsat=false
+fi
+
+# Create output directory
+mkdir -p "$DIMACS_DIR"
+
+# Function to count solutions using SharpSAT-TD
+# Args: $1 = DIMACS file path
+# Returns: Solution count (or "UNSAT" if unsatisfiable, "ERROR" if failed)
+count_solutions() {
+    local dimacs_file="$1"
+    local abs_dimacs_file="$(cd "$(dirname "$dimacs_file")" && pwd)/$(basename "$dimacs_file")"
+
+    # SharpSAT must be run from its bin directory (requires flow_cutter_pace17 in same dir)
+    cd "$SHARPSAT_DIR/bin" || {
+        echo "ERROR"
+        return 1
+    }
+
+    local output=$(./sharpSAT -decot 1 -tmpdir "$TEMP_DIR" "$abs_dimacs_file" 2>&1)
+    local exit_code=$?
+    cd - > /dev/null
+
+    if echo "$output" | grep -q "s UNSATISFIABLE"; then
+        echo "UNSAT"
+        return 0
+    fi
+    local count=$(echo "$output" | grep "c s exact arb int" | awk '{print $NF}')
+    if [ $exit_code -ne 0 ] || [ -z "$count" ]; then
+        echo "ERROR"
+        return 1
+    fi
+
+    echo "$count"
+    return 0
+}
+
+echo "============================================================"
+echo "Testing Structural Simplification (core/dead/void detection)"
+echo "============================================================"
+echo ""
+echo "CLI: $CLI"
+echo "Fixtures: $UVL_DIR"
+echo ""
+
+# Counters
+total=0
+passed=0
+failed=0
+
+for expected in "${EXPECTED[@]}"; do
+    read -r name core dead void <<< "$expected"
+    uvl_file="$UVL_DIR/${name}.uvl"
+    straight_dimacs="$DIMACS_DIR/${name}_s.dimacs"
+    structural_dimacs="$DIMACS_DIR/${name}_c.dimacs"
+
+    ((total++))
+    echo -n "[$total/${#EXPECTED[@]}] Testing $name... "
+
+    if ! "$CLI" -s "$uvl_file" "$straight_dimacs" >/dev/null 2>&1; then
+        echo -e "${RED}FAIL (straightforward conversion failed)${NC}"
+        ((failed++))
+        continue
+    fi
+    if ! output=$("$CLI" -c "$uvl_file" "$structural_dimacs" 2>&1); then
+        echo -e "${RED}FAIL (structural conversion failed)${NC}"
+        ((failed++))
+        continue
+    fi
+
+    got_core=$(echo "$output" | grep "Core:" | awk '{print $2}')
+    got_dead=$(echo "$output" | grep "Dead:" | awk '{print $2}')
+    got_void=no
+    if echo "$output" | grep -q "model is void"; then
+        got_void=yes
+    fi
+
+    if [ "$got_core" != "$core" ] || [ "$got_dead" != "$dead" ] || [ "$got_void" != "$void" ]; then
+        echo -e "${RED}FAIL (analysis differs)${NC}"
+        echo "  Expected: core=$core dead=$dead void=$void"
+        echo "  Got:      core=$got_core dead=$got_dead void=$got_void"
+        ((failed++))
+        continue
+    fi
+
+    if [ "$use_sharpsat" = true ]; then
+        count_straight=$(count_solutions "$straight_dimacs")
+        count_structural=$(count_solutions "$structural_dimacs")
+        if [ "$count_straight" = "ERROR" ] || [ "$count_straight" != "$count_structural" ]; then
+            echo -e "${RED}FAIL (counts differ)${NC}"
+            echo "  Straightforward: $count_straight"
+            echo "  Structural:      $count_structural"
+            ((failed++))
+            continue
+        fi
+        echo -e "${GREEN}PASS (core=$core, dead=$dead, void=$void, solutions: $count_straight)${NC}"
+    else
+        echo -e "${GREEN}PASS (core=$core, dead=$dead, void=$void)${NC}"
+    fi
+    ((passed++))
+done
+
+# Summary
+echo ""
+echo "============================================================"
+echo "Test Summary"
+echo "============================================================"
+echo "Total tests: $total"
+echo -e "${GREEN}Passed: $passed${NC}"
+if [ $failed -gt 0 ]; then
+    echo -e "${RED}Failed: $failed${NC}"
+else
+    echo "Failed: 0"
+fi
+echo "============================================================"
+
+if [ $failed -eq 0 ] && [ $passed -gt 0 ]; then
+    echo ""
+    echo -e "${GREEN}✓ All tests passed!${NC}"
+    exit 0
+else
+    echo ""
+    echo -e "${RED}✗ Some tests failed!${NC}"
+    echo ""
+    echo -e "${BLUE}Check the propagation rules in StructuralAnalyzer.${NC}"
+    exit 1
+fi
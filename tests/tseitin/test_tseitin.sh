@@ -9,6 +9,18 @@
 #
 # This is a direct test of countability preservation using full Tseitin equivalences (⟺)
 #
+# Each model is also converted with every linear at-most-one encoding (-a) and
+# every counter encoding of cardinality groups (-g) at threshold 2, so that
+# every alternative and cardinality group uses it; their auxiliary variables
+# are fully defined, so the counts must match as well. The same holds for the
+# hybrid mode (-y), equivalent-variable merging (-e) and SAT preprocessing
+# (-p), which are run as further variants. The corpus has no cardinality
+# groups, so the fixtures in tests/cardinality/uvl are always tested in
+# addition, against a straightforward DIMACS generated on the fly.
+#
+# Finally each model is split into independent components (-d): the product
+# of the component counts must equal the straightforward count.
+#
 
 # Colors for output
 RED='\033[0;31m'
@@ -24,6 +36,7 @@ PROJECT_ROOT="$(cd "$SCRIPT_DIR/../.." && pwd)"
 # Directories
 UVL_DIR="$PROJECT_ROOT/tests/straightforward/uvl"
 STRAIGHT_DIMACS_DIR="$PROJECT_ROOT/tests/straightforward/dimacs"
+CARDINALITY_UVL_DIR="$PROJECT_ROOT/tests/cardinality/uvl"
 TSEITIN_DIMACS_DIR="$SCRIPT_DIR/dimacs"
 
 # Executables
@@ -31,6 +44,24 @@ CLI="$PROJECT_ROOT/build/uvl2dimacs"
 SHARPSAT_DIR="$PROJECT_ROOT/tests/sharpsat-td"
 SHARPSAT="$SHARPSAT_DIR/bin/sharpSAT"
 
+# Alternative conversions whose counts must equal the straightforward count
+ENCODING_VARIANTS=(
+    "-s -a sequential:2"
+    "-s -a ladder:2"
+    "-s -a commander:2"
+    "-s -a bimander:2"
+    "-s -a product:2"
+    "-s -g sequential:2"
+    "-s -g totalizer:2"
+    "-s -g network:2"
+    "-s -g auto:2"
+    "-y"
+    "-s -e"
+    "-t -e"
+    "-s -p"
+    "-t -p"
+)
+
 # Temporary directory for SharpSAT (passed via -tmpdir flag)
 TEMP_DIR="/tmp/sharpsat_tseitin_test_$$"
 mkdir -p "$TEMP_DIR"
@@ -96,6 +127,11 @@ fi
 # but it works fine when run with actual DIMACS files.
 # We skip the health check and let the actual tests proceed.
 
+if ! command -v python3 >/dev/null 2>&1; then
+    echo -e "${RED}Error: python3 is required to multiply component counts${NC}"
+    exit 1
+fi
+
 if [ ! -d "$UVL_DIR" ]; then
     echo -e "${RED}Error: UVL directory not found: $UVL_DIR${NC}"
     exit 1
@@ -190,13 +226,83 @@ count_solutions() {
     return 0
 }
 
+# Function to convert a model with each encoding variant and compare counts
+# Args: $1 = UVL file, $2 = basename, $3 = expected solution count
+# Returns: Empty string if all counts match, otherwise a failure description
+check_encoding_variants() {
+    local uvl_file="$1"
+    local basename="$2"
+    local expected="$3"
+
+    for variant in "${ENCODING_VARIANTS[@]}"; do
+        local suffix=$(echo "$variant" | tr -d '-' | tr ' :' '__')
+        local variant_dimacs="$TSEITIN_DIMACS_DIR/${basename}_${suffix}.dimacs"
+        if ! "$CLI" $variant "$uvl_file" "$variant_dimacs" >/dev/null 2>&1; then
+            echo "$variant: conversion failed"
+            return 0
+        fi
+        local count_variant=$(count_solutions "$variant_dimacs")
+        if [ "$count_variant" != "$expected" ]; then
+            echo "$variant: $count_variant solutions, expected $expected"
+            return 0
+        fi
+    done
+    return 0
+}
+
+# Function to split a model into components and compare the product of their counts
+# Args: $1 = UVL file, $2 = basename, $3 = expected solution count
+# Returns: Empty string if the product matches, otherwise a failure description
+check_components() {
+    local uvl_file="$1"
+    local basename="$2"
+    local expected="$3"
+    local components_dir="$TSEITIN_DIMACS_DIR/${basename}_components"
+    local manifest="$components_dir/${basename}.dimacs"
+
+    rm -rf "$components_dir"
+    mkdir -p "$components_dir"
+    if ! "$CLI" -s -d "$uvl_file" "$manifest" >/dev/null 2>&1; then
+        echo "-d: conversion failed"
+        return 0
+    fi
+
+    # Manifest lines: component <k> <file> <variables> <clauses> <kind>
+    local counts=()
+    for file in $(grep "^component " "$manifest" | awk '{print $3}'); do
+        local count_component=$(count_solutions "$components_dir/$file")
+        if [ "$count_component" = "ERROR" ]; then
+            echo "-d: counting $file failed"
+            return 0
+        fi
+        if [ "$count_component" = "UNSAT" ]; then
+            count_component=0
+        fi
+        counts+=("$count_component")
+    done
+
+    # Counts may exceed 64 bits: multiply them with Python's integers
+    local product=$(python3 -c 'import sys; p = 1
+for c in sys.argv[1:]: p *= int(c)
+print(p)' "${counts[@]}")
+    if [ "$product" = "0" ]; then
+        product="UNSAT"
+    fi
+    if [ "$product" != "$expected" ]; then
+        echo "-d: product of ${#counts[@]} component counts is $product, expected $expected"
+    fi
+    return 0
+}
+
 echo "============================================================"
 echo "Testing Tseitin Transformation (3-CNF + Solution Counting)"
 echo "============================================================"
 echo ""
 echo -e "${BLUE}This test verifies that the Tseitin transformation:"
 echo -e "1. Produces valid 3-CNF (all clauses have ≤3 literals)"
-echo -e "2. Preserves solution counts using full equivalences (⟺)${NC}"
+echo -e "2. Preserves solution counts using full equivalences (⟺)"
+echo -e "3. Keeps solution counts with every conversion in ENCODING_VARIANTS"
+echo -e "4. Splits into components (-d) whose counts multiply to the same count${NC}"
 echo ""
 echo "CLI: $CLI"
 echo "SharpSAT-TD: $SHARPSAT"
@@ -222,6 +328,9 @@ if [ ${#uvl_files[@]} -gt $NUM_TESTS ]; then
     uvl_files=("${uvl_files[@]:0:$NUM_TESTS}")
 fi
 
+# Add the cardinality fixtures
+uvl_files+=($(find "$CARDINALITY_UVL_DIR" -name "*.uvl" 2>/dev/null | sort))
+
 echo "Selected ${#uvl_files[@]} files to test"
 echo ""
 
@@ -244,6 +353,16 @@ for uvl_file in "${uvl_files[@]}"; do
 
     echo -n "[$total/${#uvl_files[@]}] Testing $basename... "
 
+    # Fixtures have no reference DIMACS: generate it
+    if [ "$(dirname "$uvl_file")" = "$CARDINALITY_UVL_DIR" ]; then
+        straight_dimacs="$TSEITIN_DIMACS_DIR/${basename}_s.dimacs"
+        if ! "$CLI" -s "$uvl_file" "$straight_dimacs" >/dev/null 2>&1; then
+            echo -e "${RED}FAIL (straightforward conversion failed)${NC}"
+            ((failed++))
+            continue
+        fi
+    fi
+
     # Check if straightforward DIMACS exists
     if [ ! -f "$straight_dimacs" ]; then
         echo -e "${YELLOW}SKIP (no straightforward DIMACS)${NC}"
@@ -289,6 +408,14 @@ for uvl_file in "${uvl_files[@]}"; do
     # Handle UNSAT cases
     if [ "$count_straight" = "UNSAT" ] || [ "$count_tseitin" = "UNSAT" ]; then
         if [ "$count_straight" = "UNSAT" ] && [ "$count_tseitin" = "UNSAT" ]; then
+            variant_failure=$(check_encoding_variants "$uvl_file" "$basename" "$count_straight")
+            [ -z "$variant_failure" ] && variant_failure=$(check_components "$uvl_file" "$basename" "$count_straight")
+            if [ -n "$variant_failure" ]; then
+                echo -e "${RED}FAIL (encoding variant)${NC}"
+                echo "  $variant_failure"
+                ((failed++))
+                continue
+            fi
             echo -e "${GREEN}PASS (3-CNF ✓, both UNSAT)${NC}"
             ((passed++))
         else
@@ -302,6 +429,14 @@ for uvl_file in "${uvl_files[@]}"; do
 
     # Compare solution counts
     if [ "$count_straight" = "$count_tseitin" ]; then
+        variant_failure=$(check_encoding_variants "$uvl_file" "$basename" "$count_straight")
+        [ -z "$variant_failure" ] && variant_failure=$(check_components "$uvl_file" "$basename" "$count_straight")
+        if [ -n "$variant_failure" ]; then
+            echo -e "${RED}FAIL (encoding variant)${NC}"
+            echo "  $variant_failure"
+            ((failed++))
+            continue
+        fi
         echo -e "${GREEN}PASS (3-CNF ✓, max clause: $max_clause_size, solutions: $count_straight)${NC}"
         ((passed++))
     else
@@ -346,6 +481,8 @@ if [ $failed -eq 0 ] && [ $passed -gt 0 ]; then
     echo "  1. Produces valid 3-CNF (all clauses have ≤3 literals)"
     echo "  2. Uses full biconditional equivalences (⟺)"
     echo "  3. Preserves solution counts exactly"
+    echo "  4. Keeps solution counts with ${#ENCODING_VARIANTS[@]} alternative conversions"
+    echo "  5. Splits into components whose counts multiply to the same count"
     echo ""
     echo -e "${BLUE}Key insight:${NC} Auxiliary variables are FULLY DETERMINED by the"
     echo "equivalences, so each original solution extends to exactly ONE"